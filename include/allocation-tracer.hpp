@@ -0,0 +1,107 @@
+#ifndef ALLOCATIONTRACER_HPP_INCLUDED
+#define ALLOCATIONTRACER_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace trillek {
+
+/** \brief Count the allocations by call site to find the hot spots
+ *
+ * The global operator new and the memory counted by MemoryAccounting
+ * (TrillekAllocator, the pools, Lua...) are traced. Tracing is off by
+ * default, an allocation then costs one relaxed load. It is enabled:
+ * - by the environment variable TRILLEK_ALLOCATION_TRACE, its value being
+ *   the sampling period (1 to record the stack of every allocation),
+ * - or by building with the CMake option TRILLEK_ALLOCATION_TRACING, which
+ *   also exports the symbols of the executable for the call stacks.
+ *
+ * The stack of one allocation out of period is recorded, and counted for
+ * period allocations of its size. When tracing is enabled by the
+ * environment or the build, the report, sorted by bytes, is written to the
+ * standard error output at exit, or to the file given by
+ * TRILLEK_ALLOCATION_TRACE_FILE.
+ */
+class AllocationTracer {
+public:
+    // the number of frames recorded for a call site
+    static const unsigned int DEPTH = 8;
+    // the number of call sites recorded, the others are counted as lost
+    static const unsigned int MAX_SITES = 4096;
+
+    /** \brief The allocations of a call site
+     */
+    struct Site {
+        void* frames[DEPTH];
+        unsigned int depth;
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    /** \brief Start tracing
+     *
+     * \param period unsigned int the sampling period, at least 1
+     */
+    static void Enable(unsigned int period = 1);
+
+    /** \brief Stop tracing, the sites are kept
+     */
+    static void Disable();
+
+    /** \brief Tell if the allocations are traced
+     *
+     * \return bool true if tracing
+     */
+    static bool Enabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /** \brief Trace an allocation, called by the allocation hooks
+     *
+     * \param size size_t the number of bytes
+     */
+    static void Record(size_t size) {
+        if (Enabled()) {
+            Sample(size);
+        }
+    }
+
+    /** \brief Count a frame, called by the scheduler when a frame begins
+     */
+    static void NextFrame() {
+        frames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** \brief Get the call sites, the most allocated bytes first
+     *
+     * \param max_sites size_t the maximum number of sites
+     * \return std::vector<Site> the sites
+     */
+    static std::vector<Site> Sites(size_t max_sites = MAX_SITES);
+
+    /** \brief Forget the recorded allocations
+     */
+    static void Clear();
+
+    /** \brief Write the report of the most allocating sites
+     *
+     * stdio is used, so that the report can be written at exit.
+     *
+     * \param out std::FILE* the stream
+     * \param max_sites size_t the maximum number of sites
+     */
+    static void Report(std::FILE* out, size_t max_sites = 50);
+
+private:
+    static void Sample(size_t size);
+
+    static std::atomic<bool> enabled;
+    static std::atomic<uint64_t> frames;
+};
+
+} // End of trillek
+
+#endif // ALLOCATIONTRACER_HPP_INCLUDED
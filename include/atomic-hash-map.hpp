@@ -0,0 +1,406 @@
+#ifndef ATOMICHASHMAP_HPP_INCLUDED
+#define ATOMICHASHMAP_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace trillek {
+
+/** \brief A thread-safe hash map, with the interface of AtomicMap
+ *
+ * The keys are spread over shards, each one protected by its own mutex, so
+ * that threads writing different keys rarely wait for each other. A shard
+ * stores its elements in a flat array with linear probing : inserting an
+ * element allocates nothing until the shard must grow, and Poll() keeps the
+ * array of the shard for the next elements.
+ *
+ * The keys and the elements must be default-constructible.
+ */
+template<class K, class T, class Hash = std::hash<K>>
+class AtomicHashMap {
+
+public:
+
+    /** \brief Constructor
+     *
+     * \param shards size_t the minimum number of shards, rounded up to a power of 2
+     *
+     */
+    AtomicHashMap(size_t shards = 16) : shard_mask(ShardCount(shards) - 1),
+        shards(new Shard[shard_mask + 1]) {};
+
+    /** \brief Default destructor
+     *
+     */
+    virtual ~AtomicHashMap() {};
+
+    AtomicHashMap(const AtomicHashMap<K,T,Hash>& rhs) : shard_mask(rhs.shard_mask),
+        shards(new Shard[shard_mask + 1]) {
+        for (size_t s = 0; s <= shard_mask; ++s) {
+            std::lock_guard<std::mutex> locker(rhs.shards[s].mtx);
+            shards[s].CopyFrom(rhs.shards[s]);
+        }
+    }
+
+    AtomicHashMap<K,T,Hash>& operator=(const AtomicHashMap<K,T,Hash>& rhs) {
+        if (this != &rhs) {
+            AtomicHashMap<K,T,Hash> copy(rhs);
+            // the number of shards of this map is kept
+            Clear();
+            for (size_t s = 0; s <= copy.shard_mask; ++s) {
+                for (auto& slot : copy.shards[s].slots) {
+                    if (slot.state == FULL) {
+                        Insert(slot.key, slot.value);
+                    }
+                }
+            }
+        }
+        return *this;
+    }
+
+    /** \brief Empty the map and return the content
+     *
+     * The shards keep their storage for the next elements.
+     *
+     * \return std::map<K,T> the content
+     *
+     */
+    std::map<K,T> Poll() const {
+        std::vector<std::pair<K,T>> elements;
+        Poll(elements);
+        // building the tree in the order of the keys is much faster than in the order of the hashes
+        std::sort(elements.begin(), elements.end(),
+            [](const std::pair<K,T>& a, const std::pair<K,T>& b) { return a.first < b.first; });
+        std::map<K,T> ret;
+        for (auto& element : elements) {
+            ret.emplace_hint(ret.end(), std::move(element));
+        }
+        return ret;
+    }
+
+    /** \brief Empty the map and append the content to a vector
+     *
+     * The elements are in no particular order. Nothing is allocated if the
+     * vector has enough capacity.
+     *
+     * \param elements std::vector<std::pair<K,T>>& the vector receiving the content
+     *
+     */
+    void Poll(std::vector<std::pair<K,T>>& elements) const {
+        for (size_t s = 0; s <= shard_mask; ++s) {
+            auto& shard = shards[s];
+            if (! shard.filled.load(std::memory_order_acquire)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> locker(shard.mtx);
+            shard.filled.store(false, std::memory_order_relaxed);
+            if (! shard.used) {
+                continue;
+            }
+            for (auto& slot : shard.slots) {
+                if (slot.state == FULL) {
+                    elements.emplace_back(std::move(slot.key), std::move(slot.value));
+                    shard.Reset(slot);
+                }
+                slot.state = EMPTY;
+            }
+            shard.size = 0;
+            shard.used = 0;
+        }
+    }
+
+    /** \brief Insert an element
+     *
+     * \param key K&& key of the element
+     * \param value T&& value to insert
+     *
+     */
+    template<class L=K,class U=T>
+    void Insert(L&& key, U&& value) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        auto& slot = shard.Claim(key, hash);
+        if (slot.state != FULL) {
+            slot.key = std::forward<L>(key);
+            slot.state = FULL;
+            shard.filled.store(true, std::memory_order_release);
+        }
+        slot.value = std::forward<U>(value);
+    }
+
+    /** \brief Remove an element
+     *
+     * \param key const K& the key of the element to remove
+     *
+     */
+    void Erase(const K& key) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        auto slot = shard.Find(key, hash);
+        if (slot) {
+            shard.Remove(*slot);
+        }
+    }
+
+    /** \brief Clear the content of the map
+     *
+     */
+    void Clear() const {
+        for (size_t s = 0; s <= shard_mask; ++s) {
+            auto& shard = shards[s];
+            std::lock_guard<std::mutex> locker(shard.mtx);
+            shard.slots.clear();
+            shard.size = 0;
+            shard.used = 0;
+        }
+    }
+
+    /** \brief Remove and get a reference of an element
+     *
+     * \param key const K& the key of the element
+     * \param element T& a non-const reference that will contain the element
+     * \return bool true if removed, false otherwise
+     *
+     */
+    bool Pop(const K& key, T& element) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        auto slot = shard.Find(key, hash);
+        if (slot) {
+            element = std::move(slot->value);
+            shard.Remove(*slot);
+            return true;
+        }
+        return false;
+    }
+
+    /** \brief Get an element
+     *
+     * \param key const K& the key of the element
+     * \return T the element
+     * \throw std::out_of_range if there is no element with this key
+     *
+     */
+    T At(const K& key) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        auto slot = shard.Find(key, hash);
+        if (! slot) {
+            throw std::out_of_range("AtomicHashMap::At");
+        }
+        return slot->value;
+    }
+
+    /** \brief Get the number of elements having key
+     *
+     * \param key const K& the key
+     * \return size_t the number of elements
+     *
+     */
+    size_t Count(const K& key) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        return shard.Find(key, hash) ? 1 : 0;
+    }
+
+    /** \brief Compare atomically an element with a value
+     *
+     * \param key const K& the key of the element
+     * \param element const T& the value to compare with
+     * \return bool true if equal, false otherwise
+     *
+     */
+    bool Compare(const K& key, const T& element) const {
+        const size_t hash = Mix(hasher(key));
+        auto& shard = shards[hash & shard_mask];
+        std::lock_guard<std::mutex> locker(shard.mtx);
+        auto slot = shard.Find(key, hash);
+        return slot && (slot->value == element);
+    }
+
+    /** \brief Get the number of elements
+     *
+     * The result is only a hint when other threads use the map.
+     *
+     * \return size_t the number of elements
+     *
+     */
+    size_t Size() const {
+        size_t size = 0;
+        for (size_t s = 0; s <= shard_mask; ++s) {
+            std::lock_guard<std::mutex> locker(shards[s].mtx);
+            size += shards[s].size;
+        }
+        return size;
+    }
+
+    /** \brief Get the number of shards
+     *
+     * \return size_t the number of shards
+     *
+     */
+    size_t Shards() const {
+        return shard_mask + 1;
+    }
+
+private:
+
+    enum : uint8_t { EMPTY, FULL, ERASED };
+
+    struct Slot {
+        Slot() : hash(0), state(EMPTY) {};
+        K key;
+        T value;
+        size_t hash;
+        uint8_t state;
+    };
+
+    struct Shard {
+        Shard() : size(0), used(0), filled(false) {};
+
+        // the slot of key, or nullptr
+        Slot* Find(const K& key, size_t hash) {
+            if (slots.empty()) {
+                return nullptr;
+            }
+            const size_t mask = slots.size() - 1;
+            for (size_t i = Home(hash, mask); ; i = (i + 1) & mask) {
+                auto& slot = slots[i];
+                if (slot.state == EMPTY) {
+                    return nullptr;
+                }
+                if (slot.state == FULL && slot.hash == hash && slot.key == key) {
+                    return &slot;
+                }
+            }
+        }
+
+        // the slot of key, or the free slot where key must be inserted
+        Slot& Claim(const K& key, size_t hash) {
+            // keep a quarter of the slots empty so that the probing ends quickly
+            if ((used + 1) * 4 > slots.size() * 3) {
+                Grow();
+            }
+            const size_t mask = slots.size() - 1;
+            Slot* erased = nullptr;
+            for (size_t i = Home(hash, mask); ; i = (i + 1) & mask) {
+                auto& slot = slots[i];
+                if (slot.state == EMPTY) {
+                    auto& target = erased ? *erased : slot;
+                    if (! erased) {
+                        ++used;
+                    }
+                    ++size;
+                    target.hash = hash;
+                    return target;
+                }
+                if (slot.state == ERASED) {
+                    if (! erased) {
+                        erased = &slot;
+                    }
+                }
+                else if (slot.hash == hash && slot.key == key) {
+                    return slot;
+                }
+            }
+        }
+
+        void Remove(Slot& slot) {
+            Reset(slot);
+            slot.state = ERASED;
+            --size;
+        }
+
+        // release the resources of the element
+        void Reset(Slot& slot) {
+            slot.key = K();
+            slot.value = T();
+            slot.state = EMPTY;
+        }
+
+        // rebuild the table, twice larger if the elements fill more than a third of it
+        void Grow() {
+            const size_t capacity = slots.empty() ? 8 :
+                                    (size * 3 > slots.size() ? slots.size() * 2 : slots.size());
+            std::vector<Slot> old(capacity);
+            std::swap(old, slots);
+            used = 0;
+            size = 0;
+            const size_t mask = capacity - 1;
+            for (auto& slot : old) {
+                if (slot.state == FULL) {
+                    size_t i = Home(slot.hash, mask);
+                    while (slots[i].state == FULL) {
+                        i = (i + 1) & mask;
+                    }
+                    slots[i] = std::move(slot);
+                    ++used;
+                    ++size;
+                }
+            }
+        }
+
+        void CopyFrom(const Shard& rhs) {
+            slots = rhs.slots;
+            size = rhs.size;
+            used = rhs.used;
+            filled.store(rhs.filled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        // the first slot to probe, using the bits not used to choose the shard
+        static size_t Home(size_t hash, size_t mask) {
+            return (hash >> 16) & mask;
+        }
+
+        std::mutex mtx;
+        std::vector<Slot> slots;
+        // the number of elements
+        size_t size;
+        // the number of slots that are not empty, including the erased ones
+        size_t used;
+        // set by an insertion, so that Poll() does not lock the shards left empty
+        std::atomic<bool> filled;
+        // keep the mutexes of the shards in different cache lines
+        char pad[64];
+    };
+
+    static size_t ShardCount(size_t n) {
+        size_t count = 1;
+        while (count < n) {
+            count <<= 1;
+        }
+        return count;
+    }
+
+    // spread the bits of the hash, std::hash being the identity for integers
+    static size_t Mix(size_t h) {
+        uint64_t x = static_cast<uint64_t>(h);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    const size_t shard_mask;
+    const std::unique_ptr<Shard[]> shards;
+    Hash hasher;
+};
+}
+
+#endif // ATOMICHASHMAP_HPP_INCLUDED
@@ -10,6 +10,11 @@
 namespace trillek {
 
 /** \brief A thread-safe queue implementation with atomic operations
+ *
+ * The queue can be double-buffered : the consumer polls the content into a
+ * buffer it keeps from one frame to the other, and the nodes of the
+ * elements it consumed are kept aside to hold the next pushed elements.
+ * Once the queue reached its usual size, the frames allocate nothing.
  */
 template<class T>
 class AtomicQueue {
@@ -48,6 +53,46 @@ class AtomicQueue {
             return ret;
         }
 
+        /** \brief Empty the queue into a buffer, recycling the previous content of the buffer
+         *
+         * The elements in the buffer are the ones of the previous poll, and are
+         * considered consumed. They are reset to T() and their nodes are reused
+         * by the next calls to Push().
+         *
+         * \param buffer atomic_queue<T>& the buffer receiving the content
+         *
+         */
+        void Poll(atomic_queue<T>& buffer) const {
+            // release the resources held by the consumed elements outside the lock
+            for (auto& element : buffer) {
+                element = T();
+            }
+            std::unique_lock<std::mutex> locker(mtx);
+            spare.splice(spare.end(), buffer);
+            std::swap(buffer, q);
+        }
+
+        /** \brief Free the nodes kept for the next elements
+         *
+         */
+        void ReleaseSpare() const {
+            atomic_queue<T> released;
+            {
+                std::unique_lock<std::mutex> locker(mtx);
+                std::swap(released, spare);
+            }
+        }
+
+        /** \brief Get the number of nodes kept for the next elements
+         *
+         * \return size_t the number of nodes
+         *
+         */
+        size_t Spare() const {
+            std::unique_lock<std::mutex> locker(mtx);
+            return spare.size();
+        }
+
         /** \brief Put an element at the end of the queue
          *
          * \param element U&& element to put in the queue
@@ -55,7 +100,13 @@ class AtomicQueue {
         template<class U>
         void Push(U&& element) const {
             std::unique_lock<std::mutex> locker(mtx);
-            q.push_back(std::forward<U>(element));
+            if (spare.empty()) {
+                q.push_back(std::forward<U>(element));
+            }
+            else {
+                q.splice(q.end(), spare, spare.begin());
+                q.back() = std::forward<U>(element);
+            }
         }
 
         /** \brief Put a list of element at the end of the queue
@@ -97,6 +148,8 @@ class AtomicQueue {
 
         // the queue
         mutable atomic_queue<T> q;
+        // the nodes recycled by Poll(buffer)
+        mutable atomic_queue<T> spare;
         // the mutex protecting the queue
         mutable std::mutex mtx;
 
@@ -0,0 +1,365 @@
+#ifndef ATOMICRINGQUEUE_HPP_INCLUDED
+#define ATOMICRINGQUEUE_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <thread>
+#include <trillek-allocator.hpp>
+
+namespace trillek {
+
+/** \brief The threads that can use a ring queue at once
+ */
+enum class RingAccess {
+    MPMC,   // any number of producers and consumers
+    SPSC    // one producer thread and one consumer thread
+};
+
+namespace detail {
+// the smallest power of 2 greater or equal to n, at least 2
+inline size_t RingCapacity(size_t n) {
+    size_t capacity = 2;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// keep the counters of the producers and the consumers in different cache lines
+const size_t CACHE_LINE = 64;
+}
+
+/** \brief A lock-free bounded queue, with the interface of AtomicQueue
+ *
+ * The elements are stored in a ring allocated once, so that no operation
+ * allocates memory. Each slot has a sequence number telling if it is free
+ * or holds an element for a given turn of the ring. A producer or a
+ * consumer claims a slot with one compare-and-swap, so no thread waits for
+ * another one, except a producer when the ring is full.
+ *
+ * The elements must be default-constructible.
+ */
+template<class T, RingAccess A = RingAccess::MPMC>
+class AtomicRingQueue {
+
+    template<class U>
+    using atomic_queue = std::list<U, TrillekAllocator<U>>;
+
+    public:
+
+        /** \brief Constructor
+         *
+         * \param capacity size_t the minimum number of elements, rounded up to a power of 2
+         *
+         */
+        AtomicRingQueue(size_t capacity = 1024) :
+            mask(detail::RingCapacity(capacity) - 1), cells(new Cell[mask + 1]),
+            enqueue_pos(0), dequeue_pos(0) {
+            for (size_t i = 0; i <= mask; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        };
+
+        /** \brief Destructor
+         *
+         */
+        virtual ~AtomicRingQueue() {};
+
+        // disable copy functions
+        AtomicRingQueue(AtomicRingQueue&) = delete;
+        AtomicRingQueue& operator=(AtomicRingQueue&) = delete;
+
+        /** \brief Get the maximum number of elements
+         *
+         * \return size_t the capacity
+         *
+         */
+        size_t Capacity() const {
+            return mask + 1;
+        }
+
+        /** \brief Empty the queue and return the content
+         *
+         * \return atomic_queue<T> A list of the content
+         *
+         */
+        atomic_queue<T> Poll() const {
+            atomic_queue<T> ret;
+            T element;
+            while (Pop(element)) {
+                ret.push_back(std::move(element));
+            }
+            return ret;
+        }
+
+        /** \brief Put an element at the end of the queue, if the queue is not full
+         *
+         * \param element U&& element to put in the queue
+         * \return bool false if the queue is full
+         */
+        template<class U>
+        bool TryPush(U&& element) const {
+            size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (1) {
+                cell = &cells[pos & mask];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (dif == 0) {
+                    // the slot is free for this turn : claim it
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (dif < 0) {
+                    // the slot holds the element of the previous turn
+                    return false;
+                }
+                else {
+                    // another producer took the slot
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::forward<U>(element);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** \brief Put an element at the end of the queue
+         *
+         * The call waits while the queue is full.
+         *
+         * \param element U&& element to put in the queue
+         */
+        template<class U>
+        void Push(U&& element) const {
+            while (! TryPush(std::forward<U>(element))) {
+                std::this_thread::yield();
+            }
+        }
+
+        /** \brief Put a list of element at the end of the queue
+         *
+         * The elements are moved out of the list, and the list is emptied.
+         *
+         * \param list U&& list of elements to add
+         */
+        template<class U>
+        void PushList(U&& list) const {
+            for (auto& element : list) {
+                Push(std::move(element));
+            }
+            list.clear();
+        }
+
+        /** \brief Pop an element from the front of the queue
+         *
+         * \param element T& reference that will contain the element popped
+         * \return bool true if an element was popped, false otherwise
+         */
+        bool Pop(T& element) const {
+            size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (1) {
+                cell = &cells[pos & mask];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (dif == 0) {
+                    // the slot holds the element of this turn : claim it
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (dif < 0) {
+                    // no element was written in the slot for this turn
+                    return false;
+                }
+                else {
+                    // another consumer took the slot
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            element = std::move(cell->data);
+            // free the slot for the next turn
+            cell->sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** \brief Test if the queue is empty
+         *
+         * The result is only a hint when other threads use the queue.
+         *
+         * \return bool true if the queue is empty, false otherwise
+         *
+         */
+        bool Empty() const {
+            const size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            return cells[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+        }
+
+    private:
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        const size_t mask;
+        const std::unique_ptr<Cell[]> cells;
+        char pad0[detail::CACHE_LINE];
+        mutable std::atomic<size_t> enqueue_pos;
+        char pad1[detail::CACHE_LINE];
+        mutable std::atomic<size_t> dequeue_pos;
+        char pad2[detail::CACHE_LINE];
+};
+
+/** \brief A lock-free bounded queue for one producer thread and one consumer thread
+ *
+ * The producer only writes the tail and the consumer only writes the head.
+ * Each side keeps a copy of the index of the other side, and reads the
+ * shared index only when its copy says the ring is full or empty.
+ */
+template<class T>
+class AtomicRingQueue<T, RingAccess::SPSC> {
+
+    template<class U>
+    using atomic_queue = std::list<U, TrillekAllocator<U>>;
+
+    public:
+
+        /** \brief Constructor
+         *
+         * \param capacity size_t the minimum number of elements, rounded up to a power of 2
+         *
+         */
+        AtomicRingQueue(size_t capacity = 1024) :
+            mask(detail::RingCapacity(capacity) - 1), ring(new T[mask + 1]),
+            head(0), tail_copy(0), tail(0), head_copy(0) {};
+
+        /** \brief Destructor
+         *
+         */
+        virtual ~AtomicRingQueue() {};
+
+        // disable copy functions
+        AtomicRingQueue(AtomicRingQueue&) = delete;
+        AtomicRingQueue& operator=(AtomicRingQueue&) = delete;
+
+        /** \brief Get the maximum number of elements
+         *
+         * \return size_t the capacity
+         *
+         */
+        size_t Capacity() const {
+            return mask + 1;
+        }
+
+        /** \brief Empty the queue and return the content, from the consumer thread
+         *
+         * \return atomic_queue<T> A list of the content
+         *
+         */
+        atomic_queue<T> Poll() const {
+            atomic_queue<T> ret;
+            T element;
+            while (Pop(element)) {
+                ret.push_back(std::move(element));
+            }
+            return ret;
+        }
+
+        /** \brief Put an element at the end of the queue if it is not full, from the producer thread
+         *
+         * \param element U&& element to put in the queue
+         * \return bool false if the queue is full
+         */
+        template<class U>
+        bool TryPush(U&& element) const {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head_copy > mask) {
+                head_copy = head.load(std::memory_order_acquire);
+                if (t - head_copy > mask) {
+                    return false;
+                }
+            }
+            ring[t & mask] = std::forward<U>(element);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** \brief Put an element at the end of the queue, from the producer thread
+         *
+         * The call waits while the queue is full.
+         *
+         * \param element U&& element to put in the queue
+         */
+        template<class U>
+        void Push(U&& element) const {
+            while (! TryPush(std::forward<U>(element))) {
+                std::this_thread::yield();
+            }
+        }
+
+        /** \brief Put a list of element at the end of the queue, from the producer thread
+         *
+         * The elements are moved out of the list, and the list is emptied.
+         *
+         * \param list U&& list of elements to add
+         */
+        template<class U>
+        void PushList(U&& list) const {
+            for (auto& element : list) {
+                Push(std::move(element));
+            }
+            list.clear();
+        }
+
+        /** \brief Pop an element from the front of the queue, from the consumer thread
+         *
+         * \param element T& reference that will contain the element popped
+         * \return bool true if an element was popped, false otherwise
+         */
+        bool Pop(T& element) const {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail_copy) {
+                tail_copy = tail.load(std::memory_order_acquire);
+                if (h == tail_copy) {
+                    return false;
+                }
+            }
+            element = std::move(ring[h & mask]);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** \brief Test if the queue is empty
+         *
+         * The result is only a hint when other threads use the queue.
+         *
+         * \return bool true if the queue is empty, false otherwise
+         *
+         */
+        bool Empty() const {
+            return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+        }
+
+    private:
+
+        const size_t mask;
+        const std::unique_ptr<T[]> ring;
+        char pad0[detail::CACHE_LINE];
+        // written by the consumer
+        mutable std::atomic<size_t> head;
+        mutable size_t tail_copy;
+        char pad1[detail::CACHE_LINE];
+        // written by the producer
+        mutable std::atomic<size_t> tail;
+        mutable size_t head_copy;
+        char pad2[detail::CACHE_LINE];
+};
+}
+
+#endif // ATOMICRINGQUEUE_HPP_INCLUDED
@@ -3,6 +3,7 @@
 
 #include "trillek.hpp"
 #include "type-id.hpp"
+#include "value-storage.hpp"
 
 namespace trillek {
 
@@ -15,46 +16,41 @@ namespace trillek {
 class Container {
 public:
     // instance an empty container
-    Container() : value_holder(nullptr) { }
-
-    // clean up - very important
-    ~Container() {
-        if(value_holder != nullptr) delete value_holder;
-    }
+    Container() { }
 
     // Copy is not allowed
     Container(const Container &that) = delete;
     Container& operator=(const Container &that) = delete;
 
     // Move
-    Container(Container&& that) : value_holder(that.value_holder) {
-        that.value_holder = nullptr;
-    }
-    Container& operator=(Container&& that) {
-        value_holder = that.value_holder;
-        that.value_holder = nullptr;
+    Container(Container&& that) noexcept : storage(std::move(that.storage)) { }
+    Container& operator=(Container&& that) noexcept {
+        this->storage = std::move(that.storage);
         return *this;
     }
 
     /**
      * \brief Sets the value of the container.
+     *
+     * Small values are stored in the container without allocation.
      */
     template <typename T>
-    Container(T value) : value_holder(new ValueHolder<T>(value)) { }
+    Container(T value) : storage(std::move(value)) { }
 
     /**
      * \brief Retrieves the container value.
      */
     template <class T>
     T Get() const {
-        if(this->value_holder != nullptr) {
-            return static_cast<ValueHolder<T>*>(this->value_holder)->Get();
+        T* value = this->storage.Get<T>();
+        if(value != nullptr) {
+            return *value;
         }
         return T();
     }
 
     bool IsEmpty() const {
-        return nullptr == this->value_holder;
+        return this->storage.IsEmpty();
     }
 
     /**
@@ -75,49 +71,18 @@ public:
      * \brief Retrieves the type ID of contained value.
      */
     unsigned GetType() const {
-        if(this->value_holder == nullptr) {
-            return 0;
-        }
-        return this->value_holder->GetType();
+        return this->storage.GetType();
     }
 
     /**
      * \brief Retrieves the size of the contained value.
      */
     std::size_t GetSize() const {
-        if(this->value_holder == nullptr) {
-            return 0;
-        }
-        return this->value_holder->GetSize();
+        return this->storage.GetSize();
     }
 
 private:
-    /**
-     * \brief ValueHolderBase - common class
-     */
-    class ValueHolderBase {
-    public:
-        virtual ~ValueHolderBase() { }
-        virtual unsigned GetType() const { return 0; }
-        virtual std::size_t GetSize() const { return 0; }
-    };
-
-    /**
-     * \brief The generic value holder.
-     */
-    template <typename T>
-    class ValueHolder : public ValueHolderBase {
-    public:
-        ValueHolder(T value) : value(value), type_id(reflection::GetTypeID<T>()) { }
-        T Get() { return this->value; }
-        virtual unsigned GetType() const { return type_id; }
-        virtual std::size_t GetSize() const { return sizeof(T); }
-    private:
-        unsigned type_id;
-        T value;
-    };
-
-    ValueHolderBase* value_holder;
+    ValueStorage storage;
 };
 
 } // namespace trillek
@@ -0,0 +1,268 @@
+#ifndef FRAMEALLOCATOR_HPP_INCLUDED
+#define FRAMEALLOCATOR_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <stdlib.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace trillek {
+
+/** \brief A bump allocator for the temporaries of a frame
+ *
+ * The memory is taken from blocks that are kept from one frame to the next.
+ * An allocation only moves a pointer, and nothing is freed until Reset()
+ * rewinds the arena at once. Once the blocks are warm, a frame does not hit
+ * the heap anymore.
+ *
+ * Each thread has its own arena. The scheduler resets the arena of a worker
+ * when the worker runs its first task of a new frame: the memory given by
+ * the arena is valid until the end of the frame it was allocated in.
+ * The arena of a thread that is not managed by the scheduler is never reset.
+ * The blocks are counted for the scheduler in MemoryAccounting.
+ */
+class FrameArena {
+public:
+    // the default size of a block
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    /** \brief Constructor
+     *
+     * \param block_size size_t the size of the blocks, larger allocations get their own block
+     */
+    FrameArena(size_t block_size = BLOCK_SIZE);
+    ~FrameArena();
+
+    // disable copy functions
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /** \brief Allocate memory valid until the next reset
+     *
+     * \param size size_t the number of bytes
+     * \param alignment size_t the alignment, a power of 2
+     * \return void* the memory
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /** \brief Release all the memory allocated since the last reset
+     *
+     * The blocks are kept for the next frame.
+     */
+    void Reset();
+
+    /** \brief Give the blocks back to the heap
+     *
+     * The arena must not hold any live allocation.
+     */
+    void Release();
+
+    /** \brief Get the number of bytes allocated since the last reset
+     *
+     * \return size_t the number of bytes
+     */
+    size_t Used() const {
+        return used;
+    }
+
+    /** \brief Get the highest number of bytes allocated between two resets
+     *
+     * \return size_t the number of bytes
+     */
+    size_t Peak() const {
+        return used > peak ? used : peak;
+    }
+
+    /** \brief Get the number of bytes held in blocks
+     *
+     * \return size_t the number of bytes
+     */
+    size_t Capacity() const {
+        return capacity;
+    }
+
+    /** \brief Get the number of blocks taken from the heap since the arena was created
+     *
+     * \return size_t the number of blocks
+     */
+    size_t BlockAllocations() const {
+        return block_allocations;
+    }
+
+    /** \brief Tell if the arena is reset by the scheduler
+     *
+     * \return bool true if the memory is released at each frame
+     */
+    bool Managed() const {
+        return managed;
+    }
+
+    /** \brief Mark the arena as reset by the scheduler
+     *
+     * \param m bool true if the memory is released at each frame
+     */
+    void SetManaged(bool m) {
+        managed = m;
+    }
+
+    /** \brief Get the arena of the calling thread
+     *
+     * \return FrameArena& the arena
+     */
+    static FrameArena& Local();
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    const size_t block_size;
+    // the block in use and the first free byte in it
+    size_t current;
+    size_t offset;
+    size_t used;
+    size_t peak;
+    size_t capacity;
+    size_t block_allocations;
+    bool managed;
+};
+
+/** \brief An allocator taking the memory from the frame arena of the thread
+ *
+ * It has the same interface as TrillekAllocator, so that STL containers
+ * holding per-frame temporaries can use it. Deallocating is free, the memory
+ * is released when the arena is reset: a container using this allocator
+ * must be destroyed before the end of the frame.
+ *
+ * On a thread whose arena is not managed by the scheduler, the memory comes
+ * from the heap. The allocations are tagged, so that a container can be
+ * destroyed on any thread.
+ */
+template<typename T>
+class FrameAllocator {
+public:
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T value_type;
+
+    /// Default constructor
+    FrameAllocator() throw() { }
+    /// Copy constructor
+    FrameAllocator(const FrameAllocator&) throw() { }
+    /// Copy constructor with another type
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>&) throw() { }
+
+    /// Destructor
+    ~FrameAllocator() { }
+
+    /// Copy
+    FrameAllocator<T>& operator=(const FrameAllocator&) {
+        return *this;
+    }
+    /// Copy with another type
+    template<typename U>
+    FrameAllocator& operator=(const FrameAllocator<U>&) {
+        return *this;
+    }
+
+    bool operator==(const FrameAllocator&) const {
+        return true;
+    }
+
+    bool operator!=(const FrameAllocator&) const {
+        return false;
+    }
+
+    /// Get address of reference
+    pointer address(reference x) const {
+        return &x;
+    }
+    /// Get const address of const reference
+    const_pointer address(const_reference x) const {
+        return &x;
+    }
+
+    /// Allocate memory
+    pointer allocate(size_type n, const void* = 0) {
+        const size_type size = n * sizeof(value_type) + HEADER;
+        auto& arena = FrameArena::Local();
+        char* p;
+        if (arena.Managed()) {
+            p = static_cast<char*>(arena.Allocate(size, HEADER));
+            p += HEADER;
+            reinterpret_cast<size_t*>(p)[-1] = FROM_ARENA;
+        }
+        else {
+            p = static_cast<char*>(::malloc(size));
+            if (! p) {
+                throw std::bad_alloc();
+            }
+            p += HEADER;
+            reinterpret_cast<size_t*>(p)[-1] = FROM_HEAP;
+        }
+        return reinterpret_cast<pointer>(p);
+    }
+
+    /// Deallocate memory
+    void deallocate(void* p, size_type) {
+        // the arena memory is released at the end of the frame
+        if (p && reinterpret_cast<size_t*>(p)[-1] == FROM_HEAP) {
+            ::free(static_cast<char*>(p) - HEADER);
+        }
+    }
+
+    /// Call constructor
+    void construct(pointer p, const T& val) {
+        // Placement new
+        new ((T*)p) T(val);
+    }
+    /// Call constructor with more arguments
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        // Placement new
+        ::new((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    /// Call the destructor of p
+    void destroy(pointer p) {
+        p->~T();
+    }
+    /// Call the destructor of p of type U
+    template<typename U>
+    void destroy(U* p) {
+        p->~U();
+    }
+
+    /// Get the max allocation size
+    size_type max_size() const {
+        return (size_type(-1) - HEADER) / sizeof(T);
+    }
+
+    /// A struct to rebind the allocator to another allocator of type U
+    template<typename U>
+    struct rebind {
+        typedef FrameAllocator<U> other;
+    };
+
+private:
+    // the tag before each allocation keeps the alignment of T
+    static const size_type HEADER = alignof(T) > alignof(std::max_align_t) ? alignof(T) : alignof(std::max_align_t);
+    static const size_type FROM_ARENA = 0;
+    static const size_type FROM_HEAP = 1;
+};
+
+template<typename T>
+const typename FrameAllocator<T>::size_type FrameAllocator<T>::HEADER;
+
+} // End of trillek
+
+#endif // FRAMEALLOCATOR_HPP_INCLUDED
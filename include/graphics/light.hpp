@@ -3,6 +3,7 @@
 
 #include "opengl.hpp"
 #include "type-id.hpp"
+#include "memory-accounting.hpp"
 #include <memory>
 #include <vector>
 #include "systems/component-factory.hpp"
@@ -45,6 +46,8 @@ namespace reflection {
 TRILLEK_MAKE_IDTYPE_NAME(graphics::LightBase, "light", 2001)
 } // End of reflection
 
+TRILLEK_MEMORY_TAG(graphics::LightBase, GRAPHICS)
+
 } // namespace trillek
 
 #endif
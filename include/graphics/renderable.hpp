@@ -3,6 +3,7 @@
 
 #include "opengl.hpp"
 #include "type-id.hpp"
+#include "memory-accounting.hpp"
 #include <memory>
 #include <vector>
 #include "component.hpp"
@@ -139,6 +140,8 @@ namespace reflection {
 TRILLEK_MAKE_IDTYPE_NAME(graphics::Renderable, "renderable", 2000)
 } // End of reflection
 
+TRILLEK_MEMORY_TAG(graphics::Renderable, GRAPHICS)
+
 } // End of trillek
 
 #endif
@@ -2,9 +2,11 @@
 #define SHADER_HPP_INCLUDED
 
 #include "opengl.hpp"
+#include "symbol.hpp"
 #include "type-id.hpp"
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <atomic>
 #include "systems/resource-system.hpp"
@@ -72,11 +74,22 @@ public:
 
     // ISSUE: This is a bit questionable as it violates the principle of least surprise
     //An indexer that returns the location of the attribute/uniform
-    GLint operator[](const std::string & attribute);
-    GLint operator()(const std::string & uniform);
+    GLint operator[](Symbol attribute);
+    GLint operator()(Symbol uniform);
 
-    GLint Attribute(const std::string & attribute);
-    GLint Uniform(const std::string & uniform);
+    /**
+     * \brief Get the location of an attribute, cached by symbol
+     * \param[in] Symbol attribute the name of the attribute, "name"_sym for a literal
+     * \return GLint the location
+     */
+    GLint Attribute(Symbol attribute);
+
+    /**
+     * \brief Get the location of a uniform, cached by symbol
+     * \param[in] Symbol uniform the name of the uniform, "name"_sym for a literal
+     * \return GLint the location
+     */
+    GLint Uniform(Symbol uniform);
 
     //Program deletion
     void DeleteProgram();
@@ -87,8 +100,8 @@ private:
     GLuint program;
     std::vector<GLuint> shaders;
     std::vector<std::pair<std::string, GLuint>> output_bindings;
-    std::map<std::string, GLint> attributes_list;
-    std::map<std::string, GLint> uniforms_list;
+    std::unordered_map<Symbol, GLint> attributes_list;
+    std::unordered_map<Symbol, GLint> uniforms_list;
 
     static std::once_flag types_once;
     static std::map<std::string, ShaderType> shaderclass;
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include "graphics/camera.hpp"
+#include "memory-accounting.hpp"
 #include "trillek-game.hpp"
 
 namespace trillek {
@@ -35,5 +36,7 @@ namespace reflection {
 TRILLEK_MAKE_IDTYPE_NAME(graphics::SixDOFCamera, "camera", 2002)
 } // namespace reflection
 
+TRILLEK_MEMORY_TAG(graphics::SixDOFCamera, GRAPHICS)
+
 } // End of trillek
 #endif
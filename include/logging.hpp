@@ -3,6 +3,7 @@
 
 #include "trillek.hpp"
 #include "type-id.hpp"
+#include "frame-allocator.hpp"
 #include <memory>
 #include <sstream>
 
@@ -55,11 +56,12 @@ public:
         }
         ~LogLine() {
             if(show) {
+                const auto line = message.str();
                 if(glob) {
-                    GetInstance().WriteLine(LogLevelString<T>(), message.str());
+                    GetInstance().WriteLine(LogLevelString<T>(), std::string(line.begin(), line.end()));
                 }
                 else {
-                    GetInstance().WriteLine(LogLevelString<T>(), systemname, message.str());
+                    GetInstance().WriteLine(LogLevelString<T>(), systemname, std::string(line.begin(), line.end()));
                 }
             }
         }
@@ -71,7 +73,8 @@ public:
     private:
         bool show, glob;
         std::string systemname;
-        std::ostringstream message;
+        // the message is built in the frame arena
+        std::basic_ostringstream<char, std::char_traits<char>, FrameAllocator<char>> message;
     };
 
     template<LogLevel L, typename SYSTEM>
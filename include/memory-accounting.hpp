@@ -0,0 +1,108 @@
+#ifndef MEMORYACCOUNTING_HPP_INCLUDED
+#define MEMORYACCOUNTING_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace trillek {
+
+/** \brief The subsystems the memory is counted for
+ */
+enum class MemoryTag : unsigned int {
+    GENERAL,
+    SCHEDULER,
+    RESOURCES,
+    GRAPHICS,
+    PHYSICS,
+    LUA,
+    SOUND,
+    COUNT
+};
+
+/** \brief The memory counted for a tag
+ */
+struct MemoryStats {
+    // the bytes allocated and not freed
+    int64_t current;
+    // the highest value of current, see MemoryAccounting
+    int64_t peak;
+    uint64_t allocations;
+    uint64_t deallocations;
+};
+
+/** \brief Count the memory allocated by each subsystem
+ *
+ * Each thread has its own counters, written with relaxed atomic operations
+ * and summed when the numbers are read. The memory can be freed by another
+ * thread than the one that allocated it: the counters of a thread can be
+ * negative, not their sum.
+ *
+ * The threads also add the bytes they allocate to a shared counter when
+ * they reach FLUSH_SIZE, to follow the high-water mark. The peak is exact
+ * up to FLUSH_SIZE bytes per thread, and is updated each time it is read.
+ */
+class MemoryAccounting {
+public:
+    static const int64_t FLUSH_SIZE = 64 * 1024;
+
+    /** \brief Count an allocation
+     *
+     * \param tag MemoryTag the subsystem
+     * \param size size_t the number of bytes
+     */
+    static void Allocate(MemoryTag tag, size_t size);
+
+    /** \brief Count a deallocation
+     *
+     * \param tag MemoryTag the subsystem
+     * \param size size_t the number of bytes given to Allocate()
+     */
+    static void Deallocate(MemoryTag tag, size_t size);
+
+    /** \brief Get the memory counted for a subsystem
+     *
+     * \param tag MemoryTag the subsystem
+     * \return MemoryStats the numbers
+     */
+    static MemoryStats Stats(MemoryTag tag);
+
+    /** \brief Get the memory counted for all subsystems
+     *
+     * The peak is the sum of the peaks of the subsystems.
+     *
+     * \return MemoryStats the numbers
+     */
+    static MemoryStats Total();
+
+    /** \brief Get the name of a subsystem
+     *
+     * \param tag MemoryTag the subsystem
+     * \return const char* the name
+     */
+    static const char* TagName(MemoryTag tag);
+
+    /** \brief Write a report of the memory of each subsystem
+     *
+     * \param out std::ostream& the stream
+     */
+    static void Dump(std::ostream& out);
+};
+
+/** \brief The subsystem owning the objects of a type
+ *
+ * Used by the pools, see TRILLEK_MEMORY_TAG.
+ */
+template<class T>
+struct MemoryTagOf {
+    static const MemoryTag value = MemoryTag::GENERAL;
+};
+
+// count the objects of a type for a subsystem, in the trillek namespace
+#define TRILLEK_MEMORY_TAG(a,t) \
+    template<> struct MemoryTagOf<a> { static const MemoryTag value = MemoryTag::t; };
+
+} // End of trillek
+
+#endif // MEMORYACCOUNTING_HPP_INCLUDED
@@ -8,6 +8,7 @@
 
 #include "systems/component-factory.hpp"
 #include "type-id.hpp"
+#include "memory-accounting.hpp"
 #include "component.hpp"
 
 namespace trillek {
@@ -93,6 +94,8 @@ template <> inline const char* GetTypeName<physics::Collidable>() { return "coll
 template <> inline const unsigned int GetTypeID<physics::Collidable>() { return 3000; }
 
 } // End of reflection
+
+TRILLEK_MEMORY_TAG(physics::Collidable, PHYSICS)
 } // End of trillek
 
 #endif
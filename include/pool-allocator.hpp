@@ -0,0 +1,181 @@
+#ifndef POOLALLOCATOR_HPP_INCLUDED
+#define POOLALLOCATOR_HPP_INCLUDED
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "memory-accounting.hpp"
+
+namespace trillek {
+
+/** \brief The statistics of a pool
+ */
+struct PoolStats {
+    // the size of a slot, with the control block of std::allocate_shared
+    size_t slot_size;
+    // the number of slots in the chunks
+    size_t capacity;
+    // the number of slots in use, the highest number since the pool was created
+    size_t used;
+    size_t peak;
+    size_t chunks;
+    // the allocations that did not fit in a slot and went to the heap
+    size_t overflows;
+};
+
+/** \brief A pool of fixed-size slots allocated in contiguous chunks
+ *
+ * The slot size is given by the first allocation. The objects created one
+ * after another are next to each other in memory, and a freed slot is
+ * reused by the next allocation. The chunks are kept until the pool is
+ * destroyed.
+ *
+ * The pool can be used from any thread. Its memory is counted for a
+ * subsystem, see MemoryAccounting.
+ */
+class SlabPool {
+public:
+    // the default size of a chunk
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    /** \brief Constructor
+     *
+     * \param chunk_size size_t the size of the chunks, at least one slot is in a chunk
+     * \param tag MemoryTag the subsystem the memory is counted for
+     */
+    SlabPool(size_t chunk_size = CHUNK_SIZE, MemoryTag tag = MemoryTag::GENERAL);
+    ~SlabPool();
+
+    // disable copy functions
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /** \brief Allocate a slot
+     *
+     * \param size size_t the size of the object
+     * \param alignment size_t the alignment of the object
+     * \return void* the memory
+     */
+    void* Allocate(size_t size, size_t alignment);
+
+    /** \brief Free a slot
+     *
+     * \param p void* the memory returned by Allocate()
+     * \param size size_t the size given to Allocate()
+     * \param alignment size_t the alignment given to Allocate()
+     */
+    void Deallocate(void* p, size_t size, size_t alignment);
+
+    /** \brief Get the statistics of the pool
+     *
+     * \return PoolStats the statistics
+     */
+    PoolStats Stats() const;
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    // the size of a chunk, once the slot size is known
+    size_t ChunkBytes() const {
+        return (this->chunk_size / this->slot_size > 1 ? this->chunk_size / this->slot_size : 1) * this->slot_size;
+    }
+
+    // under m_pool
+    bool Fits(size_t size, size_t alignment) const {
+        return size <= this->slot_size && alignment <= this->slot_alignment;
+    }
+
+    std::vector<char*> chunks;
+    // the freed slots, the last freed first
+    FreeSlot* free_slots;
+    // the slots never used in the last chunk
+    char* cursor;
+    char* end;
+    const size_t chunk_size;
+    const MemoryTag tag;
+    size_t slot_size;
+    size_t slot_alignment;
+    size_t used;
+    size_t peak;
+    size_t overflows;
+    mutable std::mutex m_pool;
+};
+
+/** \brief Get the pool of the objects of a type
+ *
+ * The memory is counted for the subsystem given by MemoryTagOf<Owner>.
+ * The pool is never destroyed: objects owned by static variables can be
+ * released after the end of main().
+ *
+ * \return SlabPool& the pool
+ */
+template<class Owner>
+SlabPool& TypedPool() {
+    static SlabPool* pool = new SlabPool(SlabPool::CHUNK_SIZE, MemoryTagOf<Owner>::value);
+    return *pool;
+}
+
+/** \brief An allocator taking the objects from the pool of a type
+ *
+ * Meant for std::allocate_shared, so that the object and its control block
+ * are in one slot:
+ *
+ *     auto c = std::allocate_shared<Component>(PoolAllocator<Component>());
+ *
+ * The rebound allocators use the pool of the same type. Arrays go to the heap.
+ */
+template<class T, class Owner = T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+
+    PoolAllocator() {};
+
+    template<class U>
+    PoolAllocator(const PoolAllocator<U, Owner>&) {};
+
+    T* allocate(size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(TypedPool<Owner>().Allocate(sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (n == 1) {
+            TypedPool<Owner>().Deallocate(p, sizeof(T), alignof(T));
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    template<class U>
+    struct rebind {
+        typedef PoolAllocator<U, Owner> other;
+    };
+
+    /** \brief Get the statistics of the pool of the type
+     *
+     * \return PoolStats the statistics
+     */
+    static PoolStats Stats() {
+        return TypedPool<Owner>().Stats();
+    }
+};
+
+template<class T, class U, class Owner>
+bool operator==(const PoolAllocator<T, Owner>&, const PoolAllocator<U, Owner>&) {
+    return true;
+}
+
+template<class T, class U, class Owner>
+bool operator!=(const PoolAllocator<T, Owner>&, const PoolAllocator<U, Owner>&) {
+    return false;
+}
+
+} // End of trillek
+
+#endif // POOLALLOCATOR_HPP_INCLUDED
@@ -2,8 +2,10 @@
 #define PROPERTY_HPP
 
 #include <string>
+#include "symbol.hpp"
 #include "trillek.hpp"
 #include "type-id.hpp"
+#include "value-storage.hpp"
 
 namespace trillek {
 /**
@@ -12,45 +14,43 @@ namespace trillek {
  * This class is used to pass around generic properties.
  * Properties have a name and a value. The value is
  * accessed by calling Get() with the appropriate type.
+ * The name is interned, compare it with GetSymbol() == "name"_sym.
  */
 class Property {
 private:
-    Property() : value_holder(nullptr) { }
+    Property() { }
 public:
     // Copy
-    Property(const Property &other) {
-        this->name = other.name;
-        if (other.value_holder != nullptr) {
-            this->value_holder = other.value_holder->Clone();
-        }
-        else {
-            this->value_holder = nullptr;
-        }
-    }
+    Property(const Property &other) : name(other.name), value(other.value) { }
 
     // Move
-    Property(Property&& other) : name(other.name), value_holder(other.value_holder) {
-        other.value_holder = nullptr;
-    }
+    Property(Property&& other) noexcept : name(other.name), value(std::move(other.value)) { }
 
     /**
      * \brief Sets the name and value of the property.
      *
-     * \param[in] std::string name The name of the property
+     * Small values are stored in the property without allocation.
+     *
+     * \param[in] Symbol name The name of the property
      * \param[in] T value The value of the property.
      */
     template <typename T>
-    Property(std::string name, T value) : name(name), value_holder(new ValueHolder<T>(value)) { }
-
-    ~Property() { delete this->value_holder; }
+    Property(Symbol name, T value) : name(name), value(std::move(value)) {
+        static_assert(std::is_copy_constructible<T>::value, "The value of a property must be copyable");
+    }
 
     template <typename T>
-    T Get() const { return static_cast<ValueHolder<T>*>(this->value_holder)->Get(); }
+    T Get() const { return *this->value.Get<T>(); }
 
     /**
      * \brief Gets the property name.
      */
-    std::string GetName() const { return this->name; }
+    std::string GetName() const { return this->name.GetName(); }
+
+    /**
+     * \brief Gets the property name as a symbol.
+     */
+    Symbol GetSymbol() const { return this->name; }
 
     /**
      * \brief Compares the type contents.
@@ -71,45 +71,15 @@ public:
      * \brief Retrieves the type ID of contents.
      */
     unsigned GetType() const {
-        if(this->value_holder == nullptr) {
-            return 0;
-        }
-        return this->value_holder->GetType();
+        return this->value.GetType();
     }
 
     std::size_t GetSize() const {
-        if(this->value_holder == nullptr) {
-            return 0;
-        }
-        return this->value_holder->GetSize();
+        return this->value.GetSize();
     }
 private:
-    class ValueHolderBase {
-    public:
-        virtual ~ValueHolderBase() { }
-        virtual ValueHolderBase* Clone() const = 0;
-        virtual unsigned GetType() const { return 0; }
-        virtual std::size_t GetSize() const { return 0; }
-    };
-
-    /**
-     * \brief A generic value holder type.
-     */
-    template <typename T>
-    class ValueHolder : public ValueHolderBase {
-    public:
-        ValueHolder(T value) : value(value), type_id(reflection::GetTypeID<T>()) { }
-        virtual ValueHolder* Clone() const { return new ValueHolder(value); }
-        T Get() { return this->value; }
-        virtual unsigned GetType() const { return type_id; }
-        virtual std::size_t GetSize() const { return sizeof(T); }
-    private:
-        unsigned type_id;
-        T value;
-    };
-
-    std::string name;
-    ValueHolderBase* value_holder;
+    Symbol name;
+    ValueStorage value;
 };
 
 } // namespace trillek
@@ -6,6 +6,7 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "frame-allocator.hpp"
 #include "systems/resource-system.hpp"
 
 namespace trillek { 
@@ -49,6 +50,12 @@ public:
         std::vector<glm::mat4> bone_matricies;
     };
 
+    // an interpolated skeleton, valid until the end of the frame
+    struct InterpolatedSkeleton {
+        std::vector<SkeletonJoint, FrameAllocator<SkeletonJoint>> skeleton_joints;
+        std::vector<glm::mat4, FrameAllocator<glm::mat4>> bone_matricies;
+    };
+
     struct Frame {
         int index;
         std::vector<float> parameters;
@@ -117,14 +124,16 @@ public:
     bool CheckMesh(std::shared_ptr<Mesh> mesh_file);
 
     /**
-    * \brief Gets the interpolated FrameSkeleton between 2 frames at a given delta.
+    * \brief Gets the interpolated skeleton between 2 frames at a given delta.
+    *
+    * The skeleton is allocated in the frame arena, it must not be kept after the frame.
     *
     * \param[in] size_t frame_index_start The starting frame index.
     * \param[in] size_t frame_index_start The ending frame index.
     * \param[in] float delta The change in time since the last call.
-    * \return FrameSkeleton The current FrameSkeleton for the given delta.
+    * \return InterpolatedSkeleton The current skeleton for the given delta.
     */
-    FrameSkeleton InterpolateSkeletons(size_t frame_index_start, size_t frame_index_end, float delta);
+    InterpolatedSkeleton InterpolateSkeletons(size_t frame_index_start, size_t frame_index_end, float delta);
 private:
     std::string fname; // Relative filename
     std::vector<std::unique_ptr<BoundingBox>> bounds; // Bound box sizes for each join.
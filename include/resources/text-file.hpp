@@ -21,8 +21,8 @@ public:
     */
     virtual bool Initialize(const std::vector<Property> &properties) {
         for (const Property& p : properties) {
-            std::string name = p.GetName();
-            if (name == "filename") {
+            Symbol name = p.GetSymbol();
+            if (name == "filename"_sym) {
                 this->filename = p.Get<std::string>();
             }
         }
@@ -0,0 +1,131 @@
+#ifndef CLOCK_HPP_INCLUDED
+#define CLOCK_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include "scheduler/task-request.hpp"
+
+namespace trillek {
+
+/** \brief The source of time of the scheduler
+ */
+class Clock {
+public:
+    Clock() {};
+    virtual ~Clock() {};
+
+    // disable copy functions
+    Clock(const Clock&) = delete;
+    Clock& operator=(const Clock&) = delete;
+
+    /** \brief Get the current time
+     *
+     * \return frame_tp the time
+     */
+    virtual frame_tp Now() const = 0;
+
+    /** \brief Get the real duration of a duration of this clock
+     *
+     * \param duration const frame_unit& the duration on this clock
+     * \return frame_unit the duration on a wall clock
+     */
+    virtual frame_unit RealDuration(const frame_unit& duration) const {
+        return duration;
+    }
+
+    /** \brief Tell if the time only moves when the scheduler has nothing to do
+     *
+     * \return bool true if the clock is virtual
+     */
+    virtual bool Virtual() const {
+        return false;
+    }
+
+    /** \brief Move the time forward, for virtual clocks
+     *
+     * \param timepoint const frame_tp& the new time
+     */
+    virtual void AdvanceTo(const frame_tp& /*timepoint*/) {};
+};
+
+/** \brief The wall clock
+ */
+class RealClock : public Clock {
+public:
+    frame_tp Now() const override {
+        return frame_tp(std::chrono::duration_cast<frame_unit>(
+                    std::chrono::steady_clock::now().time_since_epoch()));
+    }
+};
+
+/** \brief A clock that jumps to the next thing to do
+ *
+ * When all the threads of the scheduler are idle, the time jumps to the
+ * next frame or the next delayed task instead of waiting for it. Frames
+ * keep their length in simulated time, and are run as fast as possible.
+ */
+class VirtualClock : public Clock {
+public:
+    /** \brief Constructor
+     *
+     * \param start const frame_tp& the initial time
+     */
+    VirtualClock(const frame_tp& start = frame_tp()) : now(start.time_since_epoch().count()) {};
+
+    frame_tp Now() const override {
+        return frame_tp(frame_unit(now.load()));
+    }
+
+    bool Virtual() const override {
+        return true;
+    }
+
+    void AdvanceTo(const frame_tp& timepoint) override {
+        const auto tp = timepoint.time_since_epoch().count();
+        auto current = now.load();
+        // the time never goes back
+        while (current < tp && ! now.compare_exchange_weak(current, tp)) {}
+    }
+
+private:
+    std::atomic<frame_unit::rep> now;
+};
+
+/** \brief The wall clock running faster or slower
+ *
+ * The time starts at the wall clock time when the clock is created.
+ */
+class ScaledClock : public Clock {
+public:
+    /** \brief Constructor
+     *
+     * \param scale double the speed of the clock, e.g 0.5 to run at half speed
+     */
+    ScaledClock(double scale) : scale(scale), origin(real.Now()) {};
+
+    frame_tp Now() const override {
+        const auto elapsed = real.Now() - origin;
+        return origin + frame_unit(static_cast<frame_unit::rep>(elapsed.count() * scale));
+    }
+
+    frame_unit RealDuration(const frame_unit& duration) const override {
+        return frame_unit(static_cast<frame_unit::rep>(duration.count() / scale));
+    }
+
+    /** \brief Get the speed of the clock
+     *
+     * \return double the scale
+     */
+    double Scale() const {
+        return scale;
+    }
+
+private:
+    const double scale;
+    const RealClock real;
+    const frame_tp origin;
+};
+
+} // namespace trillek
+
+#endif // CLOCK_HPP_INCLUDED
@@ -0,0 +1,139 @@
+#ifndef CONCURRENCYCONTROLLER_HPP_INCLUDED
+#define CONCURRENCYCONTROLLER_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include "scheduler/task-request.hpp"
+
+namespace trillek {
+
+/** \brief Limit the number of tasks running at once
+ *
+ * There is a limit for all the tasks, and a quota for each class of task.
+ * The counters are packed in one atomic word, so that a task that can run
+ * takes its slot without any lock.
+ *
+ * A task that can not run waits in a queue. When a slot is released, the
+ * first waiting task that can use it is given the slot and only this one is
+ * woken up.
+ */
+class ConcurrencyController {
+public:
+    /** \brief Constructor
+     *
+     * The limit is the number of hardware threads. Frame-critical tasks can
+     * use all of them, background I/O and scripting a quarter each.
+     */
+    ConcurrencyController();
+    virtual ~ConcurrencyController() {};
+
+    // disable copy functions
+    ConcurrencyController(const ConcurrencyController&) = delete;
+    ConcurrencyController& operator=(const ConcurrencyController&) = delete;
+
+    /** \brief Set the maximum number of tasks running at once
+     *
+     * \param limit unsigned int the limit, at least 1
+     */
+    void SetLimit(unsigned int limit);
+
+    /** \brief Set the maximum number of tasks of a class running at once
+     *
+     * \param task_class TaskClass the class
+     * \param quota unsigned int the quota, at least 1
+     */
+    void SetQuota(TaskClass task_class, unsigned int quota);
+
+    /** \brief Get the maximum number of tasks running at once
+     *
+     * \return unsigned int the limit
+     */
+    unsigned int Limit() const {
+        return limit.load();
+    }
+
+    /** \brief Get the maximum number of tasks of a class running at once
+     *
+     * \param task_class TaskClass the class
+     * \return unsigned int the quota
+     */
+    unsigned int Quota(TaskClass task_class) const {
+        return quotas[static_cast<unsigned int>(task_class)].load();
+    }
+
+    /** \brief Get the number of tasks running
+     *
+     * \return unsigned int the number of tasks
+     */
+    unsigned int Running() const {
+        return Field(counts.load(), 0);
+    }
+
+    /** \brief Get the number of tasks of a class running
+     *
+     * \param task_class TaskClass the class
+     * \return unsigned int the number of tasks
+     */
+    unsigned int Running(TaskClass task_class) const {
+        return Field(counts.load(), 1 + static_cast<unsigned int>(task_class));
+    }
+
+    /** \brief Take a slot if one is free, without blocking
+     *
+     * \param task_class TaskClass the class of the task
+     * \return bool true if the slot was taken
+     */
+    bool TryAcquire(TaskClass task_class);
+
+    /** \brief Take a slot, waiting for one if necessary
+     *
+     * \param task_class TaskClass the class of the task
+     */
+    void Acquire(TaskClass task_class);
+
+    /** \brief Release a slot taken by Acquire() or TryAcquire()
+     *
+     * \param task_class TaskClass the class of the task
+     */
+    void Release(TaskClass task_class);
+
+private:
+    struct Waiter {
+        Waiter(TaskClass task_class) : task_class(task_class), granted(false) {};
+        const TaskClass task_class;
+        bool granted;
+        std::condition_variable cv;
+    };
+
+    static const unsigned int FIELD_BITS = 16;
+
+    static unsigned int Field(uint64_t state, unsigned int field) {
+        return (state >> (field * FIELD_BITS)) & ((1u << FIELD_BITS) - 1);
+    }
+
+    static uint64_t One(unsigned int field) {
+        return uint64_t(1) << (field * FIELD_BITS);
+    }
+
+    /** \brief Give the free slots to the waiting tasks
+     *
+     * \param max_grants unsigned int the maximum number of tasks woken up
+     */
+    void Grant(unsigned int max_grants);
+
+    // the number of tasks running, then the number of tasks running of each class
+    std::atomic<uint64_t> counts;
+    std::atomic<unsigned int> limit;
+    std::atomic<unsigned int> quotas[TASK_CLASS_COUNT];
+
+    std::atomic<unsigned int> waiting;
+    std::list<Waiter*> waiters;
+    std::mutex m_waiters;
+};
+
+} // namespace trillek
+
+#endif // CONCURRENCYCONTROLLER_HPP_INCLUDED
@@ -0,0 +1,92 @@
+#ifndef IOLANE_HPP_INCLUDED
+#define IOLANE_HPP_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trillek {
+
+/** \brief A pool of threads for the jobs that block on I/O
+ *
+ * Reading and decoding files blocks the thread for a long time. These jobs
+ * run in their own threads so that the workers of the frames are never
+ * blocked by them.
+ *
+ * The threads are launched when jobs are waiting and no thread is idle, up
+ * to a maximum. Idle threads wait for the next job.
+ */
+class IOLane {
+public:
+    /** \brief Constructor
+     *
+     * \param max_thread unsigned int the maximum number of threads, at least 1
+     */
+    IOLane(unsigned int max_thread = 2);
+
+    /** \brief Destructor, the queued jobs are done before
+     */
+    virtual ~IOLane();
+
+    // disable copy functions
+    IOLane(const IOLane&) = delete;
+    IOLane& operator=(const IOLane&) = delete;
+
+    /** \brief Set the maximum number of threads
+     *
+     * The threads already launched are kept.
+     *
+     * \param max unsigned int the maximum, at least 1
+     */
+    void SetMaxThreads(unsigned int max);
+
+    /** \brief Get the maximum number of threads
+     *
+     * \return unsigned int the maximum
+     */
+    unsigned int MaxThreads() const;
+
+    /** \brief Get the number of threads launched
+     *
+     * \return unsigned int the number of threads
+     */
+    unsigned int Threads() const;
+
+    /** \brief Get the number of jobs waiting for a thread
+     *
+     * \return size_t the number of jobs
+     */
+    size_t Pending() const;
+
+    /** \brief Queue a job
+     *
+     * \param job std::function<void(void)>&& the job
+     */
+    void Push(std::function<void(void)>&& job);
+
+    /** \brief Do the queued jobs and stop the threads
+     *
+     * The lane can be used again after.
+     */
+    void Stop();
+
+private:
+    /** \brief Main loop of each thread
+     */
+    void Loop();
+
+    mutable std::mutex m_jobs;
+    std::condition_variable jobcheck;
+    std::deque<std::function<void(void)>> jobs;
+    std::vector<std::thread> threads;
+    unsigned int max_thread;
+    unsigned int idle;
+    bool stopping;
+};
+
+} // namespace trillek
+
+#endif // IOLANE_HPP_INCLUDED
@@ -0,0 +1,183 @@
+#ifndef PARALLELJOB_HPP_INCLUDED
+#define PARALLELJOB_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace trillek {
+
+/** \brief A range of indices shared by several threads
+ *
+ * Each participating thread claims chunks of the range until none is left.
+ * The chunks are large at the beginning and shrink to the grain size at the
+ * end, so that the threads finish at the same time with few claims.
+ */
+class ParallelJob {
+public:
+    /** \brief Constructor
+     *
+     * \param size size_t the number of indices
+     * \param grain size_t the minimum number of indices of a chunk
+     * \param nr_participant unsigned int the number of threads expected
+     */
+    ParallelJob(size_t size, size_t grain, unsigned int nr_participant) :
+        size(size), grain(std::max<size_t>(grain, 1)),
+        nr_participant(std::max(nr_participant, 1u)), next(0), done(0) {};
+
+    virtual ~ParallelJob() {};
+
+    // disable copy functions
+    ParallelJob(const ParallelJob&) = delete;
+    ParallelJob& operator=(const ParallelJob&) = delete;
+
+    /** \brief Claim and run chunks until the range is exhausted
+     */
+    virtual void Work() = 0;
+
+    /** \brief Tell if all the indices have been processed
+     *
+     * \return bool true if the job is done
+     */
+    bool Done() const {
+        return done.load(std::memory_order_acquire) == size;
+    }
+
+    /** \brief Wait until all the indices have been processed
+     *
+     * Once Work() returned, the remaining chunks are already claimed by
+     * running threads, so the wait is short and can't deadlock.
+     */
+    void Wait() {
+        std::unique_lock<std::mutex> locker(m_done);
+        done_check.wait(locker, [this] () { return Done(); });
+    }
+
+    /** \brief Get the number of chunks of grain size
+     *
+     * \return size_t the number of chunks
+     */
+    size_t MaxChunks() const {
+        return (size + grain - 1) / grain;
+    }
+
+protected:
+    /** \brief Claim the next chunk
+     *
+     * \param first size_t& the first index of the chunk
+     * \param last size_t& the index after the last index of the chunk
+     * \return bool false if the range is exhausted
+     */
+    bool Claim(size_t& first, size_t& last) {
+        size_t current = next.load(std::memory_order_relaxed);
+        do {
+            if (current >= size) {
+                return false;
+            }
+            const size_t chunk = std::max(grain, (size - current) / (2 * nr_participant));
+            last = std::min(size, current + chunk);
+        } while (! next.compare_exchange_weak(current, last));
+        first = current;
+        return true;
+    }
+
+    /** \brief Declare indices processed
+     *
+     * The results of the indices must be stored before the call.
+     *
+     * \param count size_t the number of indices
+     */
+    void Complete(size_t count) {
+        if (done.fetch_add(count, std::memory_order_release) + count == size) {
+            // take the lock so that a thread checking Done() in Wait() sees the notification
+            std::lock_guard<std::mutex> locker(m_done);
+            done_check.notify_all();
+        }
+    }
+
+private:
+    const size_t size;
+    const size_t grain;
+    const unsigned int nr_participant;
+    std::atomic<size_t> next;
+    std::atomic<size_t> done;
+    std::mutex m_done;
+    std::condition_variable done_check;
+};
+
+/** \brief Call a function on each chunk of a range
+ *
+ * The function is called as fn(first, last) with two iterators.
+ */
+template<class Iterator, class Function>
+class ParallelForJob : public ParallelJob {
+public:
+    ParallelForJob(Iterator begin, size_t size, size_t grain, unsigned int nr_participant, const Function& fn) :
+        ParallelJob(size, grain, nr_participant), begin(begin), fn(fn) {};
+
+    void Work() override {
+        size_t first, last;
+        while (Claim(first, last)) {
+            fn(begin + first, begin + last);
+            Complete(last - first);
+        }
+    }
+
+private:
+    const Iterator begin;
+    const Function fn;
+};
+
+/** \brief Reduce the values computed on each chunk of a range
+ *
+ * The value of a chunk is fn(first, last), and the values are merged with
+ * combine(a, b), that must be associative and commutative.
+ */
+template<class Iterator, class T, class Function, class Combine>
+class ParallelReduceJob : public ParallelJob {
+public:
+    ParallelReduceJob(Iterator begin, size_t size, size_t grain, unsigned int nr_participant,
+                      const T& identity, const Function& fn, const Combine& combine) :
+        ParallelJob(size, grain, nr_participant), begin(begin), identity(identity),
+        fn(fn), combine(combine), result(identity) {};
+
+    void Work() override {
+        T partial = identity;
+        size_t count = 0;
+        size_t first, last;
+        while (Claim(first, last)) {
+            partial = combine(partial, fn(begin + first, begin + last));
+            count += last - first;
+        }
+        if (count) {
+            {
+                std::lock_guard<std::mutex> locker(m_result);
+                result = combine(result, partial);
+            }
+            // the partial value is merged, the chunks are done
+            Complete(count);
+        }
+    }
+
+    /** \brief Get the result, once the job is done
+     *
+     * \return const T& the result
+     */
+    const T& Result() const {
+        return result;
+    }
+
+private:
+    const Iterator begin;
+    const T identity;
+    const Function fn;
+    const Combine combine;
+    T result;
+    std::mutex m_result;
+};
+
+} // namespace trillek
+
+#endif // PARALLELJOB_HPP_INCLUDED
@@ -0,0 +1,89 @@
+#ifndef RECYCLINGALLOCATOR_HPP_INCLUDED
+#define RECYCLINGALLOCATOR_HPP_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace trillek {
+
+/** \brief An allocator keeping the freed blocks for the next allocations
+ *
+ * Each thread keeps a list of the blocks it has freed, so that objects
+ * created and destroyed at a high rate (e.g with std::allocate_shared) only
+ * hit the heap until the list is warm. A block freed on another thread
+ * joins the list of that thread.
+ *
+ * Only single objects are recycled, arrays go to the heap.
+ */
+template<class T>
+class RecyclingAllocator {
+public:
+    typedef T value_type;
+
+    // the number of blocks kept by a thread
+    static const size_t MAX_FREE_BLOCKS = 256;
+
+    RecyclingAllocator() {};
+
+    template<class U>
+    RecyclingAllocator(const RecyclingAllocator<U>&) {};
+
+    T* allocate(size_t n) {
+        auto& blocks = FreeBlocks().blocks;
+        if (n == 1 && ! blocks.empty()) {
+            void* p = blocks.back();
+            blocks.pop_back();
+            return static_cast<T*>(p);
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        auto& blocks = FreeBlocks().blocks;
+        if (n == 1 && blocks.size() < MAX_FREE_BLOCKS) {
+            blocks.push_back(p);
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    template<class U>
+    struct rebind {
+        typedef RecyclingAllocator<U> other;
+    };
+
+private:
+    struct FreeList {
+        FreeList() {
+            blocks.reserve(MAX_FREE_BLOCKS);
+        }
+
+        ~FreeList() {
+            for (auto p : blocks) {
+                ::operator delete(p);
+            }
+        }
+
+        std::vector<void*> blocks;
+    };
+
+    static FreeList& FreeBlocks() {
+        static thread_local FreeList free_list;
+        return free_list;
+    }
+};
+
+template<class T, class U>
+bool operator==(const RecyclingAllocator<T>&, const RecyclingAllocator<U>&) {
+    return true;
+}
+
+template<class T, class U>
+bool operator!=(const RecyclingAllocator<T>&, const RecyclingAllocator<U>&) {
+    return false;
+}
+
+} // namespace trillek
+
+#endif // RECYCLINGALLOCATOR_HPP_INCLUDED
@@ -0,0 +1,288 @@
+#ifndef SCHEDULERTELEMETRY_HPP_INCLUDED
+#define SCHEDULERTELEMETRY_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "scheduler/task-request.hpp"
+
+namespace trillek {
+
+/** \brief Count durations in buckets of powers of 2 nanoseconds
+ *
+ * Bucket i counts the durations from 2^i to 2^(i+1) - 1 ns, the bucket 0
+ * also counts the durations of 0 ns. The last bucket counts all the longer
+ * durations. Recording a duration is one relaxed atomic increment.
+ */
+class LatencyHistogram {
+public:
+    static const unsigned int BUCKETS = 40;
+
+    LatencyHistogram() {
+        Reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram& other) {
+        Reset();
+        Merge(other);
+    }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other) {
+        if (this != &other) {
+            Reset();
+            Merge(other);
+        }
+        return *this;
+    }
+
+    /** \brief Count a duration
+     *
+     * \param duration const frame_unit& the duration, 0 if negative
+     */
+    void Record(const frame_unit& duration) {
+        const uint64_t ns = duration.count() > 0 ? duration.count() : 0;
+        buckets[Index(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    /** \brief Add the counts of another histogram
+     *
+     * \param other const LatencyHistogram& the histogram
+     */
+    void Merge(const LatencyHistogram& other) {
+        for (unsigned int i = 0; i < BUCKETS; ++i) {
+            buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        total.fetch_add(other.total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    /** \brief Set all the counts to 0
+     */
+    void Reset() {
+        for (auto& b : buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+    }
+
+    /** \brief Get the number of durations counted
+     *
+     * \return uint64_t the number of durations
+     */
+    uint64_t Count() const;
+
+    /** \brief Get the number of durations counted in a bucket
+     *
+     * \param index unsigned int the bucket
+     * \return uint64_t the number of durations
+     */
+    uint64_t Bucket(unsigned int index) const {
+        return buckets[index].load(std::memory_order_relaxed);
+    }
+
+    /** \brief Get the mean of the durations
+     *
+     * \return frame_unit the mean, 0 if nothing was counted
+     */
+    frame_unit Mean() const;
+
+    /** \brief Get an upper bound of a percentile of the durations
+     *
+     * \param percent double the percentile, e.g 99
+     * \return frame_unit the upper bound of the bucket of the percentile
+     */
+    frame_unit Percentile(double percent) const;
+
+    /** \brief Get the upper bound of a bucket
+     *
+     * \param index unsigned int the bucket
+     * \return frame_unit the longest duration counted in the bucket
+     */
+    static frame_unit UpperBound(unsigned int index) {
+        return frame_unit((int64_t(2) << index) - 1);
+    }
+
+private:
+    static unsigned int Index(uint64_t ns) {
+        unsigned int index = 0;
+        while (ns >>= 1) {
+            ++index;
+        }
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> total;
+};
+
+/** \brief The time spent by a worker
+ */
+struct WorkerTelemetry {
+    WorkerTelemetry() : busy(0), idle(0), tasks(0) {};
+
+    frame_unit busy;    // the time spent running tasks
+    frame_unit idle;    // the time spent waiting for something to do
+    uint64_t tasks;     // the number of tasks run
+};
+
+/** \brief The measures of the scheduler
+ *
+ * Each worker writes in its own slot, so that recording a task does not
+ * share a cache line with the other workers. The readers merge the slots.
+ *
+ * The times are measured on the wall clock, whatever the clock of the
+ * scheduler.
+ */
+class SchedulerTelemetry {
+public:
+    // the number of queue depth samples kept
+    static const unsigned int DEPTH_SAMPLES = 256;
+
+    SchedulerTelemetry();
+    virtual ~SchedulerTelemetry() {};
+
+    // disable copy functions
+    SchedulerTelemetry(const SchedulerTelemetry&) = delete;
+    SchedulerTelemetry& operator=(const SchedulerTelemetry&) = delete;
+
+    /** \brief Create the slots of the workers
+     *
+     * Must be called before the workers are launched.
+     *
+     * \param nr_worker unsigned int the number of workers
+     */
+    void Initialize(unsigned int nr_worker);
+
+    /** \brief Get the wall clock time used by the measures
+     *
+     * \return frame_tp the time
+     */
+    static frame_tp Now() {
+        return frame_tp(std::chrono::duration_cast<frame_unit>(
+                    std::chrono::steady_clock::now().time_since_epoch()));
+    }
+
+    /** \brief Record a task run by a worker
+     *
+     * \param worker unsigned int the worker
+     * \param wait const frame_unit& the time between the task being due and its start
+     * \param run const frame_unit& the time spent running the task
+     */
+    void RecordTask(unsigned int worker, const frame_unit& wait, const frame_unit& run);
+
+    /** \brief Record the time a worker waited for something to do
+     *
+     * \param worker unsigned int the worker
+     * \param idle const frame_unit& the time
+     */
+    void RecordIdle(unsigned int worker, const frame_unit& idle);
+
+    /** \brief Record the start of a frame
+     *
+     * \param lateness const frame_unit& the time between the timepoint of the frame and its start
+     * \param queue_depth size_t the number of tasks in the pool
+     */
+    void RecordFrameStart(const frame_unit& lateness, size_t queue_depth);
+
+    /** \brief Record the end of a frame
+     *
+     * \param duration const frame_unit& the time between the start and the end of the frame
+     * \param budget const frame_unit& the length of a frame
+     */
+    void RecordFrameEnd(const frame_unit& duration, const frame_unit& budget);
+
+    /** \brief Get the number of workers
+     *
+     * \return unsigned int the number of workers
+     */
+    unsigned int Workers() const {
+        return slots.size();
+    }
+
+    /** \brief Get the time spent by a worker
+     *
+     * \param worker unsigned int the worker
+     * \return WorkerTelemetry the times
+     */
+    WorkerTelemetry Worker(unsigned int worker) const;
+
+    /** \brief Get the times between the tasks being due and their start
+     *
+     * \return LatencyHistogram the times of all the workers
+     */
+    LatencyHistogram WaitTimes() const;
+
+    /** \brief Get the times spent running the tasks
+     *
+     * \return LatencyHistogram the times of all the workers
+     */
+    LatencyHistogram RunTimes() const;
+
+    /** \brief Get the times between the timepoints of the frames and their start
+     *
+     * \return const LatencyHistogram& the times
+     */
+    const LatencyHistogram& FrameLateness() const {
+        return frame_lateness;
+    }
+
+    /** \brief Get the durations of the frames
+     *
+     * \return const LatencyHistogram& the durations
+     */
+    const LatencyHistogram& FrameTimes() const {
+        return frame_times;
+    }
+
+    /** \brief Get the number of frames that lasted longer than a frame length
+     *
+     * \return uint64_t the number of frames
+     */
+    uint64_t FrameOverruns() const {
+        return frame_overruns.load(std::memory_order_relaxed);
+    }
+
+    /** \brief Get the last samples of the number of tasks in the pool
+     *
+     * A sample is taken at the start of each frame.
+     *
+     * \return std::vector<size_t> the samples, the oldest first
+     */
+    std::vector<size_t> QueueDepths() const;
+
+    /** \brief Write a report of the measures
+     *
+     * \param out std::ostream& the stream
+     */
+    void Dump(std::ostream& out) const;
+
+    /** \brief Set all the measures to 0
+     *
+     * The measures recorded meanwhile may be lost.
+     */
+    void Reset();
+
+private:
+    struct Slot {
+        Slot() : busy(0), idle(0), tasks(0) {};
+        std::atomic<frame_unit::rep> busy;
+        std::atomic<frame_unit::rep> idle;
+        std::atomic<uint64_t> tasks;
+        LatencyHistogram wait;
+        LatencyHistogram run;
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    LatencyHistogram frame_lateness;
+    LatencyHistogram frame_times;
+    std::atomic<uint64_t> frame_overruns;
+    std::atomic<size_t> depths[DEPTH_SAMPLES];
+    std::atomic<uint64_t> depth_count;
+};
+
+} // namespace trillek
+
+#endif // SCHEDULERTELEMETRY_HPP_INCLUDED
@@ -0,0 +1,191 @@
+#ifndef SYSTEMGRAPH_HPP_INCLUDED
+#define SYSTEMGRAPH_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "scheduler/task-request.hpp"
+
+namespace trillek {
+
+class SystemBase;
+
+/** \brief Counters of the ticks of a system
+ */
+struct SystemTickStats {
+    SystemTickStats() : ticks(0), overruns(0), skipped(0) {};
+
+    uint64_t ticks;     // the number of ticks run
+    uint64_t overruns;  // the number of ticks that began after the next one was due
+    uint64_t skipped;   // the number of ticks dropped by the catch-up policy
+};
+
+/** \brief The order in which the systems run in a frame
+ *
+ * A system runs after the systems registered before it that write the data
+ * it reads, or that read or write the data it writes. The others run
+ * concurrently.
+ *
+ * Each system has its own tick period (SystemBase::SetTickRate()). A frame
+ * runs the systems whose tick is due at the earliest pending timepoint, in
+ * the order of the graph. A frame begins when a thread calls StartFrame()
+ * after this timepoint. Each system is sent as a task when all its due
+ * predecessors are done, so no thread waits for the data of another system.
+ * The deadline of the task is the next tick of the system.
+ * The next frame can only begin when all the systems of the frame are done.
+ * Stop() can only succeed between two frames, and no frame begins after it.
+ *
+ * When a frame begins late, each system applies its catch-up policy.
+ */
+class SystemGraph {
+public:
+    // queue a task, on a given worker or on any worker if NO_WORKER is passed
+    typedef std::function<void(std::shared_ptr<TaskRequestBase>&&,unsigned int)> push_t;
+
+    // called when a frame begins, with the timepoint of the frame and the current time
+    typedef std::function<void(const frame_tp&,const frame_tp&)> frame_start_t;
+
+    /** \brief Constructor
+     *
+     * \param push push_t the function queuing the tasks of the systems
+     * \param frame_done std::function<void(void)> the function called when all the systems are done
+     * \param frame_start frame_start_t the function called when a frame begins, before its systems are queued
+     */
+    SystemGraph(push_t push, std::function<void(void)> frame_done, frame_start_t frame_start = frame_start_t());
+    virtual ~SystemGraph() {};
+
+    // disable copy functions
+    SystemGraph(const SystemGraph&) = delete;
+    SystemGraph& operator=(const SystemGraph&) = delete;
+
+    /** \brief Build the graph
+     *
+     * Each system is given a home worker in a round-robin way. The home
+     * worker calls ThreadInit() and Terminate(), and runs the frames of a
+     * system bound to its thread.
+     *
+     * \param systems std::queue<SystemBase*>& the systems in registration order, emptied
+     * \param nr_worker unsigned int the number of workers
+     * \param start const frame_tp& the start time, the first tick of a system is one period later
+     * \param frame_length const frame_unit& the period of the systems running once per frame
+     */
+    void Build(std::queue<SystemBase*>& systems, unsigned int nr_worker,
+               const frame_tp& start, const frame_unit& frame_length);
+
+    /** \brief Call ThreadInit() of the systems whose home is a worker
+     *
+     * \param worker unsigned int the worker
+     */
+    void ThreadInit(unsigned int worker);
+
+    /** \brief Call Terminate() of the systems whose home is a worker
+     *
+     * Must be called after Stop() succeeded.
+     *
+     * \param worker unsigned int the worker
+     */
+    void Terminate(unsigned int worker);
+
+    /** \brief Forbid the next frames, if no frame is running
+     *
+     * It uses the same exchange as StartFrame(), so that a frame can not
+     * begin concurrently. Once it succeeded, StartFrame() always fails and
+     * the systems can be terminated.
+     *
+     * \return bool true if the graph is stopped, false if a frame is running
+     */
+    bool Stop();
+
+    /** \brief Begin the next frame if its timepoint is reached
+     *
+     * Nothing is done if the previous frame is not finished.
+     *
+     * \param now const frame_tp& the current time
+     * \return bool true if the frame has begun
+     */
+    bool StartFrame(const frame_tp& now);
+
+    /** \brief Get the timepoint of the next frame
+     *
+     * \return frame_tp the timepoint, frame_tp::max() if there is no system
+     */
+    frame_tp NextFrame() const;
+
+    /** \brief Get the tick counters of a system
+     *
+     * \param system const SystemBase* the system
+     * \return SystemTickStats the counters, all 0 if the system is not in the graph
+     */
+    SystemTickStats GetTickStats(const SystemBase* system) const;
+
+    /** \brief Tell if no frame is running
+     *
+     * \return bool true if all the systems are done
+     */
+    bool Idle() const {
+        const auto r = remaining.load();
+        return ! r || r == STOPPED;
+    }
+
+    /** \brief Get the number of systems
+     *
+     * \return size_t the number of systems
+     */
+    size_t Size() const {
+        return nodes.size();
+    }
+
+private:
+    class SystemTask;
+
+    // the value of remaining once the graph is stopped
+    static const size_t STOPPED = ~size_t(0);
+
+    struct Node {
+        SystemBase* system;
+        unsigned int home;
+        bool bound;
+        std::vector<size_t> successors;
+        std::vector<size_t> predecessors;
+        // the number of due predecessors not done in the current frame
+        std::atomic<unsigned int> pending;
+        // true if the system runs in the current frame
+        bool due;
+        frame_unit period;
+        frame_tp next_tick;
+        std::atomic<uint64_t> ticks;
+        std::atomic<uint64_t> overruns;
+        std::atomic<uint64_t> skipped;
+    };
+
+    /** \brief Move the next tick of a system according to its catch-up policy
+     *
+     * \param node Node& the system
+     * \param now const frame_tp& the current time
+     */
+    void Tick(Node& node, const frame_tp& now);
+
+    /** \brief Run a system, and queue the successors that are ready
+     *
+     * \param index size_t the index of the system
+     */
+    void Run(size_t index);
+
+    void Queue(size_t index, const frame_tp& frame);
+
+    const push_t push;
+    const std::function<void(void)> frame_done;
+    const frame_start_t frame_start;
+    std::vector<std::unique_ptr<Node>> nodes;
+    // the number of systems not done in the current frame, 0 when idle, STOPPED when stopped
+    std::atomic<size_t> remaining;
+    std::atomic<frame_unit::rep> next_frame;
+    frame_tp current_frame;
+};
+
+} // namespace trillek
+
+#endif // SYSTEMGRAPH_HPP_INCLUDED
@@ -0,0 +1,348 @@
+#ifndef TASKPOOL_HPP_INCLUDED
+#define TASKPOOL_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "scheduler/task-request.hpp"
+#include "scheduler/timer-wheel.hpp"
+
+namespace trillek {
+
+/** \brief Order tasks by deadline, the earliest on top of a heap
+ *
+ * A task without deadline is due by its timestamp.
+ */
+struct TaskLater {
+    bool operator()(const std::shared_ptr<TaskRequestBase>& a, const std::shared_ptr<TaskRequestBase>& b) const {
+        return b->DueBy() < a->DueBy();
+    }
+};
+
+typedef std::priority_queue<std::shared_ptr<TaskRequestBase>,
+                            std::vector<std::shared_ptr<TaskRequestBase>>,
+                            TaskLater> task_heap;
+
+/** \brief Storage of the tasks waiting for a worker
+ *
+ * A pool is shared by all the workers of the scheduler. Each call tells
+ * which worker is calling, so that an implementation can keep per-worker
+ * data. Threads that are not workers pass NO_WORKER.
+ *
+ * The tasks are in two lanes: the frame-critical tasks, and the background
+ * tasks of the other classes. A frame-critical task is popped before a
+ * background task, except that a background task is popped at least once
+ * every BackgroundInterval() pops while both lanes have tasks.
+ *
+ * A task can also be refused by the admission of the pool, see SetAdmission().
+ */
+class TaskPool {
+public:
+    static const unsigned int NO_WORKER = ~0u;
+    static const unsigned int CRITICAL_LANE = 0;
+    static const unsigned int BACKGROUND_LANE = 1;
+    static const unsigned int LANES = 2;
+
+    TaskPool() : background_interval(8) {
+        for (auto& r : refused) {
+            r.store(false);
+        }
+    };
+    virtual ~TaskPool() {};
+
+    // disable copy functions
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /** \brief Put a task in the pool
+     *
+     * \param task std::shared_ptr<TaskRequestBase>&& the task
+     * \param worker unsigned int the index of the calling worker
+     * \param now const frame_tp& the current time
+     */
+    virtual void Push(std::shared_ptr<TaskRequestBase>&& task, unsigned int worker, const frame_tp& now) = 0;
+
+    /** \brief Put several tasks in the pool
+     *
+     * The default implementation pushes them one by one. The pools override
+     * it to take their locks once.
+     *
+     * \param tasks std::vector<std::shared_ptr<TaskRequestBase>>& the tasks, moved from
+     * \param worker unsigned int the index of the calling worker
+     * \param now const frame_tp& the current time
+     */
+    virtual void PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks, unsigned int worker, const frame_tp& now) {
+        for (auto& task : tasks) {
+            Push(std::move(task), worker, now);
+        }
+    }
+
+    /** \brief Get a task whose timestamp is reached
+     *
+     * \param task std::shared_ptr<TaskRequestBase>& the task retrieved
+     * \param worker unsigned int the index of the calling worker
+     * \param now const frame_tp& the current time
+     * \return bool true if a task was retrieved, false otherwise
+     */
+    virtual bool Pop(std::shared_ptr<TaskRequestBase>& task, unsigned int worker, const frame_tp& now) = 0;
+
+    /** \brief Get the earliest timestamp of the tasks in the pool
+     *
+     * \return frame_tp the timestamp, frame_tp::max() if the pool is empty
+     */
+    virtual frame_tp NextTimepoint() const = 0;
+
+    /** \brief Get the number of tasks in the pool
+     *
+     * The value is only a hint when other threads use the pool.
+     *
+     * \return size_t the number of tasks
+     */
+    virtual size_t Size() const = 0;
+
+    /** \brief Set the minimum share of the background tasks
+     *
+     * \param interval unsigned int a background task is popped at least once every interval pops, at least 1
+     */
+    void SetBackgroundInterval(unsigned int interval) {
+        background_interval.store(std::max(interval, 1u));
+    }
+
+    /** \brief Get the minimum share of the background tasks
+     *
+     * \return unsigned int a background task is popped at least once every interval pops
+     */
+    unsigned int BackgroundInterval() const {
+        return background_interval.load();
+    }
+
+    /** \brief Set the admission of the tasks
+     *
+     * A task is popped only if admit() accepts its class. It is called before
+     * the task leaves the pool, so that the scheduler takes the concurrency
+     * slot of the task there and a worker never holds a task it can not run.
+     * A refused lane is skipped, and NextTimepoint() ignores its ready tasks
+     * until Readmit() is called.
+     *
+     * Must be set before the pool is shared.
+     *
+     * \param admit std::function<bool(TaskClass)> the admission, all the tasks are accepted if empty
+     */
+    void SetAdmission(std::function<bool(TaskClass)> admit) {
+        admission = std::move(admit);
+    }
+
+    /** \brief Try the refused lanes again
+     *
+     * To call each time the admission can accept a task it refused.
+     *
+     * \return bool true if a lane was refused
+     */
+    bool Readmit() {
+        bool was_refused = false;
+        for (auto& r : refused) {
+            if (r.load() && r.exchange(false)) {
+                was_refused = true;
+            }
+        }
+        return was_refused;
+    }
+
+    /** \brief Get the lane of a task
+     *
+     * \param task const TaskRequestBase& the task
+     * \return unsigned int CRITICAL_LANE or BACKGROUND_LANE
+     */
+    static unsigned int Lane(const TaskRequestBase& task) {
+        return task.Class() == TaskClass::FRAME_CRITICAL ? CRITICAL_LANE : BACKGROUND_LANE;
+    }
+
+protected:
+    /** \brief Choose the lane to pop from when both lanes have tasks
+     *
+     * \param critical_run unsigned int the number of frame-critical tasks popped since the last background task
+     * \return unsigned int the lane
+     */
+    unsigned int ChooseLane(unsigned int critical_run) const {
+        return critical_run + 1 >= background_interval.load(std::memory_order_relaxed) ? BACKGROUND_LANE : CRITICAL_LANE;
+    }
+
+    /** \brief Ask the admission for a task about to be popped
+     *
+     * \param lane unsigned int the lane of the task
+     * \param task const TaskRequestBase& the task
+     * \return bool true if the task can be popped
+     */
+    bool Admit(unsigned int lane, const TaskRequestBase& task) {
+        if (! admission) {
+            return true;
+        }
+        // refuse before asking, so that a Readmit() after the answer is not lost
+        refused[lane].store(true);
+        if (admission(task.Class())) {
+            refused[lane].store(false);
+            return true;
+        }
+        return false;
+    }
+
+    /** \brief Tell if the admission refused a task of a lane since the last Readmit()
+     *
+     * \param lane unsigned int the lane
+     * \return bool true if the lane is refused
+     */
+    bool Refused(unsigned int lane) const {
+        return refused[lane].load();
+    }
+
+private:
+    std::atomic<unsigned int> background_interval;
+    std::function<bool(TaskClass)> admission;
+    std::atomic<bool> refused[LANES];
+};
+
+/** \brief A priority queue per lane protected by one mutex
+ *
+ * All workers compete for the same lock. In each lane, the tasks are
+ * popped by earliest deadline first. Tasks whose timestamp is not reached
+ * wait in a timer wheel and join their lane when they are due.
+ */
+class GlobalTaskPool : public TaskPool {
+public:
+    GlobalTaskPool() : critical_run(0) {};
+    virtual ~GlobalTaskPool() {};
+
+    void Push(std::shared_ptr<TaskRequestBase>&& task, unsigned int worker, const frame_tp& now) override;
+
+    void PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks, unsigned int worker, const frame_tp& now) override;
+
+    bool Pop(std::shared_ptr<TaskRequestBase>& task, unsigned int worker, const frame_tp& now) override;
+
+    frame_tp NextTimepoint() const override;
+
+    size_t Size() const override;
+
+private:
+    // must be called with m_queue locked
+    void PushLocked(std::shared_ptr<TaskRequestBase>&& task, const frame_tp& now);
+
+    task_heap taskqueue[LANES];
+    unsigned int critical_run;
+    TimerWheel<std::shared_ptr<TaskRequestBase>> timers;
+    std::vector<std::shared_ptr<TaskRequestBase>> due;
+    mutable std::mutex m_queue;
+};
+
+/** \brief A deque per worker, with idle workers stealing from the others
+ *
+ * A worker pushes and pops at the back of its own deque, so that the tasks it
+ * has just created are run while their data is hot. Idle workers steal from
+ * the front of the other deques. Tasks queued by threads that are not workers
+ * are spread over the deques.
+ *
+ * Tasks whose timestamp is not reached are kept in a shared timer wheel, and
+ * moved in one batch to the deque of the first worker that sees them due.
+ *
+ * A batch pushed by a worker goes to its own deque, and the idle workers
+ * steal from it. A batch pushed by another thread is cut in one slice per
+ * deque.
+ *
+ * Each worker has a deque per lane. The lanes are ordered as in the other
+ * pools. The tasks having a deadline are kept out of the deques, in a heap
+ * per lane shared by all the workers: they are popped by earliest deadline
+ * first, before the tasks of the deques of their lane.
+ */
+class WorkStealingTaskPool : public TaskPool {
+public:
+    /** \brief Constructor
+     *
+     * \param nr_worker unsigned int the number of workers using the pool
+     */
+    WorkStealingTaskPool(unsigned int nr_worker);
+    virtual ~WorkStealingTaskPool() {};
+
+    void Push(std::shared_ptr<TaskRequestBase>&& task, unsigned int worker, const frame_tp& now) override;
+
+    void PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks, unsigned int worker, const frame_tp& now) override;
+
+    bool Pop(std::shared_ptr<TaskRequestBase>& task, unsigned int worker, const frame_tp& now) override;
+
+    frame_tp NextTimepoint() const override;
+
+    size_t Size() const override;
+
+private:
+    struct WorkerQueue {
+        WorkerQueue() : critical_run(0) {};
+        std::mutex m_tasks;
+        std::deque<std::shared_ptr<TaskRequestBase>> tasks[LANES];
+        // the number of frame-critical tasks popped by the worker since its last background task
+        std::atomic<unsigned int> critical_run;
+    };
+
+    /** \brief Pop a task of a lane, from the deque of the worker first
+     *
+     * \return bool true if a task was retrieved
+     */
+    bool PopLane(std::shared_ptr<TaskRequestBase>& task, unsigned int self, unsigned int lane);
+
+    // must be called with the lock of the deque, the ready counters must be updated before
+    static void PushLocked(WorkerQueue& q, std::shared_ptr<TaskRequestBase>&& task) {
+        q.tasks[Lane(*task)].push_back(std::move(task));
+    }
+
+    // must be called with m_deadlines locked, the ready counters must be updated before
+    void PushDeadlineLocked(std::shared_ptr<TaskRequestBase>&& task) {
+        const auto lane = Lane(*task);
+        deadline_tasks[lane].push(std::move(task));
+        deadline_count[lane].fetch_add(1);
+    }
+
+    static bool HasDeadline(const std::shared_ptr<TaskRequestBase>& task) {
+        return task->Deadline() != frame_tp::max();
+    }
+
+    /** \brief Move the ready tasks having a deadline to the heaps
+     *
+     * \param first the first task
+     * \param last the end of the tasks
+     * \return the end of the tasks without deadline, moved to the front, in the same order
+     */
+    std::vector<std::shared_ptr<TaskRequestBase>>::iterator PushDeadlines(
+        std::vector<std::shared_ptr<TaskRequestBase>>::iterator first,
+        std::vector<std::shared_ptr<TaskRequestBase>>::iterator last);
+
+    /** \brief Move the due delayed tasks to the deque of a worker
+     *
+     * Only one thread at a time does it, the others return immediately.
+     */
+    void ReleaseDelayed(unsigned int target, const frame_tp& now);
+
+    unsigned int Target(unsigned int worker);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::atomic<size_t> ready_count;
+    // the number of ready tasks in the background lane
+    std::atomic<size_t> background_count;
+    std::atomic<unsigned int> next_target;
+
+    // the ready tasks having a deadline
+    task_heap deadline_tasks[LANES];
+    std::atomic<size_t> deadline_count[LANES];
+    std::mutex m_deadlines;
+
+    TimerWheel<std::shared_ptr<TaskRequestBase>> delayed;
+    std::atomic<size_t> delayed_count;
+    // the next timepoint of the timer wheel, max() if empty
+    std::atomic<frame_unit::rep> next_delayed;
+    mutable std::mutex m_delayed;
+};
+
+} // namespace trillek
+
+#endif // TASKPOOL_HPP_INCLUDED
@@ -0,0 +1,239 @@
+#ifndef TASKREQUEST_HPP_INCLUDED
+#define TASKREQUEST_HPP_INCLUDED
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <list>
+#include <iterator>
+#include "scheduler/recycling-allocator.hpp"
+
+#define		STOP		0
+#define 	SPLIT		1
+#define		CONTINUE	2
+#define		REQUEUE		3
+#define		REPEAT		4
+
+namespace trillek {
+
+using namespace std::chrono;
+
+typedef std::function<int(void)> block_t;
+typedef std::list<block_t> chain_t;
+
+typedef std::chrono::nanoseconds frame_unit;
+#if defined(_MSC_VER)
+// Visual Studio implements steady_clock as system_clock
+// TODO : wait for the fix from Microsoft
+typedef time_point<system_clock, frame_unit> frame_tp;
+typedef time_point<system_clock, frame_unit> glfw_tp;
+#else
+typedef time_point<steady_clock, frame_unit> frame_tp;
+typedef time_point<steady_clock, frame_unit> glfw_tp;
+#endif
+
+/** \brief The kind of work done by a task
+ *
+ * The scheduler limits the number of tasks of each class running at once.
+ * The frame-critical tasks are run before the others (see TaskPool).
+ */
+enum class TaskClass : unsigned int {
+    FRAME_CRITICAL, // the work of the current frame
+    BACKGROUND_IO,  // loading and saving
+    SCRIPTING       // the scripts
+};
+
+const unsigned int TASK_CLASS_COUNT = 3;
+
+class TaskRequestBase {
+public:
+    TaskRequestBase(frame_tp&& timestamp) :
+        timestamp(std::move(timestamp)),
+        task_class(TaskClass::FRAME_CRITICAL),
+        deadline(frame_tp::max())
+        {};
+
+    virtual ~TaskRequestBase() {};
+
+    // the task due first runs first
+    bool operator<(const TaskRequestBase& tqe) const {
+        return this->DueBy() < tqe.DueBy();
+    }
+
+    virtual void RunTask() = 0;
+
+    glfw_tp Now() const;
+
+    bool IsNow() const {
+        return timestamp < Now();
+    }
+
+    void Reschedule(frame_unit&& delay) {
+        timestamp = Now() + delay;
+    }
+
+    frame_tp Timepoint() const {
+        return timestamp;
+    }
+
+    TaskClass Class() const {
+        return task_class;
+    }
+
+    void SetClass(TaskClass c) {
+        task_class = c;
+    }
+
+    // the time by which the task must have run, frame_tp::max() if it has none
+    frame_tp Deadline() const {
+        return deadline;
+    }
+
+    void SetDeadline(const frame_tp& d) {
+        deadline = d;
+    }
+
+    // the deadline, or the timestamp for a task without deadline
+    frame_tp DueBy() const {
+        return deadline == frame_tp::max() ? timestamp : deadline;
+    }
+
+    // the wall clock time when the task is due, set when it is queued
+    frame_tp ReadyTime() const {
+        return ready_time;
+    }
+
+    void SetReadyTime(const frame_tp& t) {
+        ready_time = t;
+    }
+
+protected:
+    frame_tp timestamp;
+    TaskClass task_class;
+    frame_tp deadline;
+    frame_tp ready_time;
+};
+
+template<class T>
+class TaskRequest : public TaskRequestBase {
+public:
+    TaskRequest(T&& funct) :
+        funct(std::forward<T>(funct)),
+        TaskRequestBase(Now())
+        {};
+
+    TaskRequest(T&& funct, const frame_unit& delay) :
+        funct(std::forward<T>(funct)),
+        TaskRequestBase(Now() + delay)
+        {};
+
+    virtual ~TaskRequest() {};
+
+    void RunTask() override {
+        funct();
+    }
+private:
+    const T funct;
+};
+
+/** \brief A chain of blocks run as a stackless coroutine
+ *
+ * The task is the frame of the coroutine: it holds a cursor on the chain,
+ * that is moved forward by the result of each block (STOP, SPLIT, CONTINUE,
+ * REQUEUE, REPEAT).
+ *
+ * A suspended chain (REQUEUE) is queued again as the same object, and
+ * resumes at the block that suspended it. The fork created by SPLIT only
+ * copies the cursor, and its memory is recycled by the thread.
+ * The chain itself is never copied.
+ *
+ * The task must be owned by a std::shared_ptr.
+ */
+template<>
+class TaskRequest<chain_t> : public TaskRequestBase, public std::enable_shared_from_this<TaskRequest<chain_t>> {
+public:
+    TaskRequest(const chain_t& chain) :
+        block(chain.cbegin()),
+        block_end(chain.cend()),
+        TaskRequestBase(Now())
+        {};
+
+    TaskRequest(const chain_t& chain, const frame_unit& delay) :
+        block(chain.cbegin()),
+        block_end(chain.cend()),
+        TaskRequestBase(Now() + delay)
+        {};
+
+    TaskRequest(chain_t&& chain) = delete;
+
+    TaskRequest(chain_t&& chain, const frame_unit& delay) = delete;
+
+    TaskRequest(std::shared_ptr<chain_t>&& chain) :
+        chain(std::move(chain)),
+        block(this->chain->cbegin()),
+        block_end(this->chain->cend()),
+        TaskRequestBase(Now())
+        {};
+
+    TaskRequest(std::shared_ptr<chain_t>&& chain, const frame_unit& delay) :
+        chain(std::move(chain)),
+        block(this->chain->cbegin()),
+        block_end(this->chain->cend()),
+        TaskRequestBase(Now() + delay)
+        {};
+
+    virtual ~TaskRequest() {};
+
+    TaskRequest<chain_t>& operator++() {
+        if (block_end != block) {
+            ++block;
+        }
+        return *this;
+    }
+
+    void RunTask() override {
+        for(auto& b = block; block_end != b; ++b) {
+            auto s = (*b)();
+            switch(s) {
+            case REQUEUE:
+                // suspend the chain, the cursor is on this block
+                // "*this" can run in another thread as soon as it is queued
+                queue_task(shared_from_this(), frame_unit(requeue_delay));
+            case STOP:
+                return;
+            case SPLIT:
+                // Queue a thread to execute this block again, and continue the chain
+                queue_task(std::allocate_shared<TaskRequest<chain_t>>(RecyclingAllocator<TaskRequest<chain_t>>(), *this),
+                           frame_unit(requeue_delay));
+                break;
+            case REPEAT:
+                --b;
+            case CONTINUE:
+            default:
+                break;
+            }
+        }
+    }
+
+    /** \brief Set how the chains are queued again
+     *
+     * \param f the function queuing a chain with the delay before it runs
+     * \param delay const frame_unit& the delay of the chains suspended by REQUEUE or forked by SPLIT
+     */
+    static void Initialize(std::function<void(std::shared_ptr<TaskRequest<chain_t>>&&, frame_unit&&)>&& f,
+                           const frame_unit& delay) {
+        queue_task = std::move(f);
+        requeue_delay = delay;
+    };
+
+private:
+    static std::function<void(std::shared_ptr<TaskRequest<chain_t>>&&, frame_unit&&)> queue_task;
+    static frame_unit requeue_delay;
+    const std::shared_ptr<chain_t> chain;
+    chain_t::const_iterator block;
+    const chain_t::const_iterator block_end;
+};
+
+} // namespace trillek
+
+#endif // TASKREQUEST_HPP_INCLUDED
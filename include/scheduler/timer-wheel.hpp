@@ -0,0 +1,236 @@
+#ifndef TIMERWHEEL_HPP_INCLUDED
+#define TIMERWHEEL_HPP_INCLUDED
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "scheduler/task-request.hpp"
+
+namespace trillek {
+
+/** \brief A hierarchical timer wheel
+ *
+ * Elements are stored with the timepoint they are due. The time is divided
+ * in ticks of a fixed resolution. Level 0 has one slot per tick for the next
+ * 64 ticks, level 1 one slot per 64 ticks for the next 64*64 ticks, and so on.
+ * When the current tick reaches the end of a slot of the lower level, the
+ * matching slot of the upper level is spread over the lower levels.
+ *
+ * Insertion is O(1). Advance() returns all the elements that are due in one
+ * batch. Elements keep their exact timepoint and are never returned before it.
+ *
+ * This class is not thread-safe.
+ */
+template<class T>
+class TimerWheel {
+public:
+    static const unsigned int LEVELS = 4;
+    static const unsigned int SLOT_BITS = 6;
+    static const unsigned int SLOTS = 1 << SLOT_BITS;
+    static const unsigned int SLOT_MASK = SLOTS - 1;
+
+    /** \brief Constructor
+     *
+     * \param resolution const frame_unit& the duration of one tick
+     */
+    TimerWheel(const frame_unit& resolution = std::chrono::milliseconds(1)) :
+        resolution(resolution.count()), current_tick(0), count(0) {
+        for (unsigned int l = 0; l < LEVELS; ++l) {
+            occupied[l] = 0;
+        }
+    };
+
+    // disable copy functions
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /** \brief Insert an element
+     *
+     * \param element T&& the element
+     * \param due const frame_tp& the timepoint the element is due
+     * \param now const frame_tp& the current time
+     */
+    void Insert(T&& element, const frame_tp& due, const frame_tp& now) {
+        if (! count) {
+            // nothing to cascade, jump to the current time
+            Resync(now);
+        }
+        ++count;
+        Place(Entry(due, Floor(due), std::move(element)));
+    }
+
+    /** \brief Move the elements that are due at the end of a list
+     *
+     * \param now const frame_tp& the current time
+     * \param out std::vector<T>& the list receiving the elements
+     */
+    void Advance(const frame_tp& now, std::vector<T>& out) {
+        const int64_t target = Floor(now);
+        Flush(expired, out, now);
+        if (! count) {
+            Resync(now);
+            return;
+        }
+        while (current_tick < target && count) {
+            ++current_tick;
+            unsigned int slot = current_tick & SLOT_MASK;
+            if (! slot) {
+                // end of a slot of the upper levels
+                for (unsigned int l = 1; l < LEVELS; ++l) {
+                    const unsigned int index = (current_tick >> (l * SLOT_BITS)) & SLOT_MASK;
+                    Cascade(l, index);
+                    if (index) {
+                        break;
+                    }
+                }
+            }
+            if (occupied[0] & (uint64_t(1) << slot)) {
+                // elements of the current tick that are not due wait in the expired list
+                Flush(slots[0][slot], out, now);
+                expired.insert(expired.end(), std::make_move_iterator(slots[0][slot].begin()),
+                               std::make_move_iterator(slots[0][slot].end()));
+                slots[0][slot].clear();
+                occupied[0] &= ~(uint64_t(1) << slot);
+            }
+            Flush(expired, out, now);
+            if (! (occupied[0] >> slot >> 1)) {
+                // nothing more on level 0 : jump to the next cascade
+                const int64_t last = current_tick | SLOT_MASK;
+                current_tick = last < target ? last : target;
+            }
+        }
+        if (current_tick < target) {
+            current_tick = target;
+        }
+    }
+
+    /** \brief Get a timepoint at which Advance() should be called
+     *
+     * The timepoint is never after the first element is due, but may be
+     * before when the next element is on the upper levels.
+     *
+     * \return frame_tp the timepoint, frame_tp::max() if the wheel is empty
+     */
+    frame_tp NextTimepoint() const {
+        if (! count) {
+            return frame_tp::max();
+        }
+        if (! expired.empty()) {
+            return Earliest(expired);
+        }
+        const unsigned int slot = current_tick & SLOT_MASK;
+        for (unsigned int i = 1; i < SLOTS - slot; ++i) {
+            if (occupied[0] & (uint64_t(1) << (slot + i))) {
+                return Earliest(slots[0][slot + i]);
+            }
+        }
+        // the next cascade
+        return frame_tp(frame_unit(((current_tick | SLOT_MASK) + 1) * resolution));
+    }
+
+    /** \brief Get the number of elements
+     *
+     * \return size_t the number of elements
+     */
+    size_t Size() const {
+        return count;
+    }
+
+    /** \brief Test if the wheel is empty
+     *
+     * \return bool true if the wheel is empty, false otherwise
+     */
+    bool Empty() const {
+        return ! count;
+    }
+
+private:
+    struct Entry {
+        Entry(const frame_tp& due, int64_t tick, T&& element) :
+            due(due), tick(tick), element(std::move(element)) {};
+        frame_tp due;
+        int64_t tick;
+        T element;
+    };
+
+    int64_t Floor(const frame_tp& tp) const {
+        return tp.time_since_epoch().count() / resolution;
+    }
+
+    static frame_tp Earliest(const std::vector<Entry>& from) {
+        frame_tp earliest = frame_tp::max();
+        for (const auto& e : from) {
+            if (e.due < earliest) {
+                earliest = e.due;
+            }
+        }
+        return earliest;
+    }
+
+    void Resync(const frame_tp& now) {
+        const int64_t tick = Floor(now);
+        if (current_tick < tick) {
+            current_tick = tick;
+        }
+    }
+
+    void Place(Entry&& entry) {
+        int64_t delta = entry.tick - current_tick;
+        if (delta <= 0) {
+            expired.push_back(std::move(entry));
+            return;
+        }
+        // beyond the range of the wheel : park it in the last slot, it will be placed again
+        const int64_t range = int64_t(1) << (LEVELS * SLOT_BITS);
+        const int64_t tick = delta < range ? entry.tick : current_tick + range - 1;
+        delta = tick - current_tick;
+        unsigned int level = 0;
+        while (level + 1 < LEVELS && delta >= (int64_t(1) << ((level + 1) * SLOT_BITS))) {
+            ++level;
+        }
+        const unsigned int slot = (tick >> (level * SLOT_BITS)) & SLOT_MASK;
+        slots[level][slot].push_back(std::move(entry));
+        occupied[level] |= uint64_t(1) << slot;
+    }
+
+    void Cascade(unsigned int level, unsigned int slot) {
+        if (! (occupied[level] & (uint64_t(1) << slot))) {
+            return;
+        }
+        std::vector<Entry> moving;
+        std::swap(moving, slots[level][slot]);
+        occupied[level] &= ~(uint64_t(1) << slot);
+        for (auto& e : moving) {
+            Place(std::move(e));
+        }
+    }
+
+    // move the elements that are due, and keep the others in the list
+    void Flush(std::vector<Entry>& from, std::vector<T>& out, const frame_tp& now) {
+        auto kept = from.begin();
+        for (auto it = from.begin(); it != from.end(); ++it) {
+            if (now < it->due) {
+                if (kept != it) {
+                    *kept = std::move(*it);
+                }
+                ++kept;
+            }
+            else {
+                out.push_back(std::move(it->element));
+                --count;
+            }
+        }
+        from.erase(kept, from.end());
+    }
+
+    const int64_t resolution;
+    int64_t current_tick;
+    size_t count;
+    std::vector<Entry> slots[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS];
+    std::vector<Entry> expired;
+};
+
+} // namespace trillek
+
+#endif // TIMERWHEEL_HPP_INCLUDED
@@ -0,0 +1,124 @@
+#ifndef SYMBOL_HPP_INCLUDED
+#define SYMBOL_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace trillek {
+
+/** \brief An interned string, compared and hashed by its ID
+ *
+ * The ID is the 64-bit FNV-1a hash of the string. A literal written with
+ * the _sym suffix is hashed at compile time:
+ *
+ *     if (p.GetSymbol() == "mesh"_sym) ...
+ *
+ * A symbol built from a string at runtime is interned in a global table,
+ * which keeps its name alive until the end of the program and checks that
+ * two different strings don't share an ID. The name of a symbol is always
+ * available, so that it can still be passed to the APIs taking strings.
+ *
+ * Interning hashes the string and locks the table, so a string never turns
+ * into a symbol implicitly: use a literal, or build the symbol once when
+ * the string is parsed and keep it.
+ */
+class Symbol {
+public:
+    /** \brief The empty symbol
+     */
+    constexpr Symbol() : id(Hash("", 0)), name("") { }
+
+    /** \brief Intern a string
+     *
+     * \param str const std::string& the string
+     */
+    explicit Symbol(const std::string& str);
+
+    /** \brief Intern a string
+     *
+     * \param str const char* the string
+     */
+    explicit Symbol(const char* str);
+
+    /** \brief Build a symbol from a literal, see operator"" _sym
+     *
+     * \param str const char* the literal, must outlive the symbol
+     * \param length std::size_t the length of the literal
+     * \return Symbol the symbol
+     */
+    static constexpr Symbol FromLiteral(const char* str, std::size_t length) {
+        return Symbol(Hash(str, length), str);
+    }
+
+    /** \brief Get the ID of the symbol
+     *
+     * \return uint64_t the ID
+     */
+    constexpr uint64_t GetID() const {
+        return this->id;
+    }
+
+    /** \brief Get the name of the symbol
+     *
+     * \return const char* the name
+     */
+    constexpr const char* GetName() const {
+        return this->name;
+    }
+
+    constexpr bool operator==(const Symbol& other) const {
+        return this->id == other.id;
+    }
+
+    constexpr bool operator!=(const Symbol& other) const {
+        return this->id != other.id;
+    }
+
+    constexpr bool operator<(const Symbol& other) const {
+        return this->id < other.id;
+    }
+
+    /** \brief Hash a string with FNV-1a
+     *
+     * \param str const char* the string
+     * \param length std::size_t the length of the string
+     * \param hash uint64_t the hash of the previous characters
+     * \return uint64_t the hash
+     */
+    static constexpr uint64_t Hash(const char* str, std::size_t length, uint64_t hash = 14695981039346656037ull) {
+        return length ? Hash(str + 1, length - 1, (hash ^ static_cast<uint8_t>(*str)) * 1099511628211ull) : hash;
+    }
+
+private:
+    constexpr Symbol(uint64_t id, const char* name) : id(id), name(name) { }
+
+    void Intern(const char* str, std::size_t length);
+
+    uint64_t id;
+    const char* name;
+};
+
+/** \brief Build a symbol from a literal at compile time
+ *
+ * \param str const char* the literal
+ * \param length std::size_t the length of the literal
+ * \return Symbol the symbol
+ */
+constexpr Symbol operator"" _sym(const char* str, std::size_t length) {
+    return Symbol::FromLiteral(str, length);
+}
+
+} // End of trillek
+
+namespace std {
+template<>
+struct hash<trillek::Symbol> {
+    size_t operator()(const trillek::Symbol& symbol) const {
+        return static_cast<size_t>(symbol.GetID());
+    }
+};
+}
+
+#endif // SYMBOL_HPP_INCLUDED
@@ -1,23 +1,123 @@
 #ifndef ASYNCDATA_HPP_INCLUDED
 #define ASYNCDATA_HPP_INCLUDED
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "trillek-scheduler.hpp"
 
 namespace trillek {
 
+/** \brief Data published by a system to the other threads once per frame
+ *
+ * There are 2 ways to publish the data, which must not be mixed on the same
+ * instance:
+ *
+ * - Publish()/Unpublish() hand a shared pointer to the readers through a
+ * future, renewed each frame.
+ *
+ * - WriteBuffer()/Commit() fill one of a few buffers allocated once, and
+ * Latest() gives the last committed buffer. No call blocks or allocates
+ * memory, and the readers can call WaitFor() when they need the data of a
+ * given frame. There must be only one writer thread at a time.
+ *
+ * Both ways keep the data of the last frames, so that a late reader gets
+ * the closest frame, and an interpolating reader the frames around a time.
+ * With WriteBuffer()/Commit(), a reader running less often than the writer
+ * gets every commit since its last read with ReadSince().
+ */
 template<class T>
 class AsyncData {
+
+    struct Buffer;
+
 public:
-    AsyncData() {
+
+    /** \brief A committed buffer, kept from being rewritten while the instance lives
+     *
+     */
+    class Snapshot {
+    public:
+        Snapshot() : buffer(nullptr) {};
+        Snapshot(Snapshot&& other) : buffer(other.buffer) {
+            other.buffer = nullptr;
+        };
+        Snapshot& operator=(Snapshot&& other) {
+            std::swap(buffer, other.buffer);
+            return *this;
+        };
+        ~Snapshot() {
+            if (buffer) {
+                buffer->readers.fetch_sub(1, std::memory_order_release);
+            }
+        };
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        /** \brief Test if the snapshot holds data
+         *
+         */
+        explicit operator bool() const {
+            return buffer != nullptr;
+        }
+
+        const T& operator*() const {
+            return buffer->data;
+        }
+
+        const T* operator->() const {
+            return &buffer->data;
+        }
+
+        /** \brief Get the frame the data was committed for
+         *
+         * \return const frame_tp& the frame
+         *
+         */
+        const frame_tp& Frame() const {
+            return buffer->frame;
+        }
+
+    private:
+        friend class AsyncData;
+        explicit Snapshot(Buffer* buffer) : buffer(buffer) {};
+
+        Buffer* buffer;
+    };
+
+    /** \brief Constructor
+     *
+     * The writer of WriteBuffer()/Commit() never waits if there are the
+     * frames kept + the readers holding a snapshot at the same time + 1
+     * buffers.
+     *
+     * \param buffers unsigned int the number of buffers of WriteBuffer()/Commit(),
+     * at least history + 2
+     * \param history unsigned int the number of frames kept, at least 1
+     *
+     */
+    AsyncData(unsigned int buffers = 3, unsigned int history = 1) :
+        nr_history(history ? history : 1),
+        nr_buffer(buffers < nr_history + 2 ? nr_history + 2 : buffers),
+        commits(0), writing(0), waiters(0) {
         Unpublish(frame_tp{});
     };
 
     /** \brief Request a future for the data
      *
-     * The future returned is not valid if the frame requested is behind
-     * the current frame for the publisher
+     * If the frame requested is behind the current frame for the publisher,
+     * the future holds the closest frame kept, and is not valid if no frame
+     * was published.
+     *
+     * The call does not block: the scheduler runs the reader of the data
+     * after its writer (see SystemBase::DeclareRead()), so the last frame
+     * of the writer is already published when the reader asks for it.
      *
      * Callers must catch exceptions thrown through the future.
      *
@@ -29,12 +129,18 @@ public:
         std::unique_lock<std::mutex> locker(m_current);
         if (frame_requested < current_frame) {
             // the call is too late
-            return {};
-        }
-        // we block until the frame time or after 500 ms
-        if (! ahead_request.wait_for(locker, std::chrono::milliseconds(500), [&](){ return frame_requested <= current_frame; })) {
-            // 500 ms have passed, let return a invalid future
-            return {};
+            const std::pair<frame_tp,std::shared_ptr<const T>>* closest = nullptr;
+            for (auto& p : published) {
+                if (! closest || Distance(p.first, frame_requested) < Distance(closest->first, frame_requested)) {
+                    closest = &p;
+                }
+            }
+            if (! closest) {
+                return {};
+            }
+            std::promise<std::shared_ptr<const T>> late;
+            late.set_value(closest->second);
+            return late.get_future().share();
         }
         return current_future;
     };
@@ -48,8 +154,16 @@ public:
      */
     template<class U=std::shared_ptr<const T>>
     void Publish(U&& data) {
+        std::shared_ptr<const T> ptr(std::forward<U>(data));
+        {
+            std::unique_lock<std::mutex> locker(m_current);
+            if (published.size() == nr_history) {
+                published.erase(published.begin());
+            }
+            published.push_back(std::make_pair(current_frame, ptr));
+        }
         // unblock threads waiting the data
-        current_promise.set_value(std::forward<U>(data));
+        current_promise.set_value(std::move(ptr));
     };
 
     /** \brief Remove access to current data
@@ -67,15 +181,270 @@ public:
         current_future = current_promise.get_future().share();
         // update the frame timepoint
         current_frame = std::move(frame);
-        ahead_request.notify_all();
+    }
+
+    /** \brief Get the buffer to fill before calling Commit(), from the writer thread
+     *
+     * The buffer holds the data of an older frame, that the writer can
+     * reuse or overwrite.
+     *
+     * \return T& the buffer
+     *
+     */
+    T& WriteBuffer() {
+        return Buffers()[writing].data;
+    }
+
+    /** \brief Make the buffer filled by the writer the latest data, from the writer thread
+     *
+     * The writer gets the oldest buffer that is not kept in the history nor
+     * read by anyone for its next frame.
+     *
+     * \param frame const frame_tp& the frame of the data
+     */
+    void Commit(const frame_tp& frame) {
+        auto buf = Buffers();
+        // only the writer changes the number of commits and the commit of a buffer
+        const uint64_t n = commits.load(std::memory_order_relaxed);
+        buf[writing].frame = frame;
+        buf[writing].commit.store(n, std::memory_order_seq_cst);
+        history[n % nr_history].store(writing, std::memory_order_release);
+        commits.store(n + 1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> locker(m_commit);
+            commit_cv.notify_all();
+        }
+        while (1) {
+            for (unsigned int i = 1; i < nr_buffer; ++i) {
+                const unsigned int candidate = (writing + i) % nr_buffer;
+                auto& b = buf[candidate];
+                const uint64_t c = b.commit.load(std::memory_order_relaxed);
+                if ((c != NEVER && c + nr_history > n) || b.readers.load(std::memory_order_seq_cst)) {
+                    continue;
+                }
+                // a reader coming now sees that the buffer left the history
+                b.commit.store(NEVER, std::memory_order_seq_cst);
+                if (! b.readers.load(std::memory_order_seq_cst)) {
+                    writing = candidate;
+                    return;
+                }
+            }
+            // all the older buffers are read
+            std::this_thread::yield();
+        }
+    }
+
+    /** \brief Get the last committed data
+     *
+     * The call never blocks.
+     *
+     * \return Snapshot the data, empty if nothing was committed yet
+     *
+     */
+    Snapshot Latest() const {
+        while (1) {
+            const uint64_t n = commits.load(std::memory_order_seq_cst);
+            if (! n) {
+                return Snapshot();
+            }
+            auto snapshot = Acquire(n - 1);
+            if (snapshot) {
+                return snapshot;
+            }
+            // the writer committed again
+        }
+    }
+
+    /** \brief Get the data committed before the last one
+     *
+     * \param age unsigned int the number of commits after the data, 0 for the latest
+     * \return Snapshot the data, empty if it is not kept
+     *
+     */
+    Snapshot Previous(unsigned int age) const {
+        const uint64_t n = commits.load(std::memory_order_seq_cst);
+        return n > age ? Acquire(n - 1 - age) : Snapshot();
+    }
+
+    /** \brief Read the data of every commit since the last call, oldest first
+     *
+     * A reader running less often than the writer calls it to get all the
+     * data committed since its last read, instead of the latest one only.
+     * The commits that left the history before being read are skipped.
+     *
+     * \param next uint64_t& the number of the first commit not read yet,
+     * 0 before the first call, updated by the call
+     * \param read F the function called with each Snapshot
+     * \return uint64_t the number of commits skipped
+     *
+     */
+    template<class F>
+    uint64_t ReadSince(uint64_t& next, F read) const {
+        const uint64_t n = commits.load(std::memory_order_seq_cst);
+        uint64_t lost = 0;
+        if (next + nr_history < n) {
+            lost = n - nr_history - next;
+            next = n - nr_history;
+        }
+        for (; next < n; ++next) {
+            auto snapshot = Acquire(next);
+            if (snapshot) {
+                read(snapshot);
+            }
+            else {
+                // the writer committed again
+                ++lost;
+            }
+        }
+        return lost;
+    }
+
+    /** \brief Get the kept data whose frame is the closest to a time point
+     *
+     * \param frame const frame_tp& the time point
+     * \return Snapshot the data, empty if nothing was committed yet
+     *
+     */
+    Snapshot Closest(const frame_tp& frame) const {
+        Snapshot best;
+        for (unsigned int age = 0; age < nr_history; ++age) {
+            auto snapshot = Previous(age);
+            if (! snapshot) {
+                break;
+            }
+            if (! best || Distance(snapshot.Frame(), frame) < Distance(best.Frame(), frame)) {
+                best = std::move(snapshot);
+            }
+        }
+        return best;
+    }
+
+    /** \brief Get the kept data of the frames around a time point
+     *
+     * \param frame const frame_tp& the time point
+     * \param before Snapshot& the last data whose frame is not after the time point
+     * \param after Snapshot& the first data whose frame is after the time point
+     * \return bool true if both are found
+     *
+     */
+    bool Around(const frame_tp& frame, Snapshot& before, Snapshot& after) const {
+        before = Snapshot();
+        after = Snapshot();
+        for (unsigned int age = 0; age < nr_history; ++age) {
+            auto snapshot = Previous(age);
+            if (! snapshot) {
+                break;
+            }
+            if (! (frame < snapshot.Frame())) {
+                before = std::move(snapshot);
+                break;
+            }
+            after = std::move(snapshot);
+        }
+        return before && after;
+    }
+
+    /** \brief Wait for the data of a frame
+     *
+     * \param frame const frame_tp& the frame wanted
+     * \param timeout const frame_unit& the maximum time to wait
+     * \return Snapshot the data of frame or of a later frame, empty on timeout
+     *
+     */
+    Snapshot WaitFor(const frame_tp& frame, const frame_unit& timeout) const {
+        auto snapshot = Latest();
+        if (snapshot && ! (snapshot.Frame() < frame)) {
+            return snapshot;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::unique_lock<std::mutex> locker(m_commit);
+        while (1) {
+            snapshot = Latest();
+            if (snapshot && ! (snapshot.Frame() < frame)) {
+                break;
+            }
+            snapshot = Snapshot();
+            if (commit_cv.wait_until(locker, deadline) == std::cv_status::timeout) {
+                snapshot = Latest();
+                if (snapshot && snapshot.Frame() < frame) {
+                    snapshot = Snapshot();
+                }
+                break;
+            }
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+        return snapshot;
     }
 
 private:
+
+    static const uint64_t NEVER = ~0ull;
+
+    struct Buffer {
+        Buffer() : commit(NEVER), readers(0) {};
+        T data;
+        frame_tp frame;
+        // the number of the commit of the data
+        std::atomic<uint64_t> commit;
+        std::atomic<unsigned int> readers;
+    };
+
+    static frame_unit Distance(const frame_tp& a, const frame_tp& b) {
+        return a < b ? b - a : a - b;
+    }
+
+    // the buffers, allocated by the first call of the writer
+    Buffer* Buffers() {
+        auto buf = buffers.load(std::memory_order_relaxed);
+        if (! buf) {
+            history.reset(new std::atomic<unsigned int>[nr_history]);
+            storage.reset(new Buffer[nr_buffer]);
+            buf = storage.get();
+            buffers.store(buf, std::memory_order_release);
+        }
+        return buf;
+    }
+
+    // the data of a commit, if it is still kept
+    Snapshot Acquire(uint64_t c) const {
+        const uint64_t n = commits.load(std::memory_order_seq_cst);
+        if (c >= n || c + nr_history < n) {
+            return Snapshot();
+        }
+        // the buffers were allocated before the first commit
+        auto buf = buffers.load(std::memory_order_acquire);
+        auto& b = buf[history[c % nr_history].load(std::memory_order_acquire)];
+        b.readers.fetch_add(1, std::memory_order_seq_cst);
+        // the writer does not take a buffer of the history, nor a buffer with readers
+        if (b.commit.load(std::memory_order_seq_cst) == c) {
+            return Snapshot(&b);
+        }
+        b.readers.fetch_sub(1, std::memory_order_release);
+        return Snapshot();
+    }
+
     std::promise<std::shared_ptr<const T>> current_promise;
     std::shared_future<std::shared_ptr<const T>> current_future;
     frame_tp current_frame;
+    // the last published frames
+    std::vector<std::pair<frame_tp,std::shared_ptr<const T>>> published;
     mutable std::mutex m_current;
-    mutable std::condition_variable ahead_request;
+
+    const unsigned int nr_history;
+    const unsigned int nr_buffer;
+    std::unique_ptr<Buffer[]> storage;
+    std::atomic<Buffer*> buffers{nullptr};
+    // the buffers of the last commits, by commit number modulo nr_history
+    std::unique_ptr<std::atomic<unsigned int>[]> history;
+    // the number of commits
+    std::atomic<uint64_t> commits;
+    // the index of the buffer of the writer
+    unsigned int writing;
+    // the readers waiting in WaitFor()
+    mutable std::atomic<unsigned int> waiters;
+    mutable std::mutex m_commit;
+    mutable std::condition_variable commit_cv;
 };
 } // namespace trillek
 
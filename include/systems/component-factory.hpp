@@ -9,6 +9,7 @@
 #include "property.hpp"
 #include "trillek.hpp"
 #include "component.hpp"
+#include "pool-allocator.hpp"
 #include "systems/system-base.hpp"
 #include "util/json-parser.hpp"
 
@@ -146,7 +147,8 @@ public:
     static std::shared_ptr<T> Create(const unsigned int entity_id, const std::vector<Property> &properties) {
         unsigned int type_id = reflection::GetTypeID<T>();
         if (instance->components[type_id].find(entity_id) == instance->components[type_id].end()) {
-            auto sharedcomp = std::make_shared<T>();
+            // the components of a type are packed in the pool of the type
+            auto sharedcomp = std::allocate_shared<T>(PoolAllocator<T>());
             sharedcomp->component_type_id = type_id;
             if (!sharedcomp->Initialize(properties)) {
                 instance->components[type_id].erase(entity_id);
@@ -158,6 +160,16 @@ public:
         return std::static_pointer_cast<T>(instance->components[type_id][entity_id]);
     }
 
+    /**
+     * \brief Gets the statistics of the pool of the components of a type.
+     *
+     * \return PoolStats The capacity and the usage of the pool.
+     */
+    template<class T>
+    static PoolStats GetPoolStats() {
+        return PoolAllocator<T>::Stats();
+    }
+
     /**
      * \brief Adds a component to be managed by the system.
      *
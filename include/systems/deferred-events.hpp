@@ -0,0 +1,153 @@
+#ifndef DEFERREDEVENTS_HPP_INCLUDED
+#define DEFERREDEVENTS_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "atomic-ring-queue.hpp"
+#include "dispatcher.hpp"
+
+namespace trillek {
+namespace event {
+
+/** \brief A subscriber keeping the events until its owner asks for them
+ *
+ * The thread notifying the events only copies them in a lock-free ring.
+ * The owner, usually a system in HandleEvents(), gets all the events
+ * received since its last call as one batch, on its own thread.
+ *
+ * When the ring is full, the events are kept in a vector protected by a
+ * mutex, so that no event is lost nor reordered.
+ *
+ * The events must be default-constructible.
+ */
+template<typename T>
+class DeferredEvents : public Subscriber<T> {
+public:
+    struct Event {
+        // the entity of the event, if not for any entity
+        unsigned int entity_id;
+        bool any_entity;
+        T data;
+    };
+
+    /** \brief Constructor
+     *
+     * \param capacity size_t the number of events kept without locking
+     *
+     */
+    DeferredEvents(size_t capacity = 256) : dispatcher(Dispatcher<T>::GetInstance()),
+        ring(capacity), spilling(false), any_entity(false) { }
+
+    /** \brief Destructor
+     *
+     * The buffer unsubscribes and waits for the notifications in progress.
+     */
+    ~DeferredEvents() {
+        for (auto entity_id : entities) {
+            this->dispatcher->Unsubscribe(entity_id, this);
+        }
+        if (this->any_entity) {
+            this->dispatcher->Unsubscribe(this);
+        }
+        this->dispatcher->Synchronize();
+    }
+
+    DeferredEvents(const DeferredEvents&) = delete;
+    DeferredEvents& operator=(const DeferredEvents&) = delete;
+
+    /** \brief Subscribes the buffer to the events of an entity
+     *
+     * \param const unsigned int entity_id ID of the entity to subscribe to.
+     */
+    void Subscribe(const unsigned int entity_id) {
+        this->entities.push_back(entity_id);
+        this->dispatcher->Subscribe(entity_id, this);
+    }
+
+    /** \brief Subscribes the buffer to the events for any entity ID
+     *
+     */
+    void Subscribe() {
+        this->any_entity = true;
+        this->dispatcher->Subscribe(this);
+    }
+
+    void Notify(const unsigned int entity_id, const T* data) override {
+        Push(Event{entity_id, false, *data});
+    }
+
+    void Notify(const T* data) override {
+        Push(Event{0, true, *data});
+    }
+
+    /** \brief Get the events received since the last call, from the owner thread
+     *
+     * The batch is valid until the next call.
+     *
+     * \return const std::vector<Event>& the events in the order they were notified
+     */
+    const std::vector<Event>& Poll() {
+        this->batch.clear();
+        Event event;
+        while (this->ring.Pop(event)) {
+            this->batch.push_back(std::move(event));
+        }
+        if (this->spilling.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> locker(this->m_spill);
+            // the events in the ring are older than the spilled ones
+            while (this->ring.Pop(event)) {
+                this->batch.push_back(std::move(event));
+            }
+            for (auto& e : this->spill) {
+                this->batch.push_back(std::move(e));
+            }
+            this->spill.clear();
+            this->spilling.store(false, std::memory_order_release);
+        }
+        return this->batch;
+    }
+
+    /** \brief Notify a subscriber of the events received since the last call, from the owner thread
+     *
+     * \param Subscriber<T>* target the subscriber receiving the events.
+     */
+    void Deliver(Subscriber<T>* target) {
+        for (auto& event : Poll()) {
+            if (event.any_entity) {
+                target->Notify(&event.data);
+            }
+            else {
+                target->Notify(event.entity_id, &event.data);
+            }
+        }
+    }
+
+private:
+    void Push(Event&& event) {
+        if (! this->spilling.load(std::memory_order_acquire) && this->ring.TryPush(std::move(event))) {
+            return;
+        }
+        std::lock_guard<std::mutex> locker(this->m_spill);
+        this->spilling.store(true, std::memory_order_release);
+        this->spill.push_back(std::move(event));
+    }
+
+    // keeps the dispatcher alive until the buffer unsubscribes
+    std::shared_ptr<Dispatcher<T>> dispatcher;
+    AtomicRingQueue<Event> ring;
+    // the events received while the ring was full
+    std::atomic<bool> spilling;
+    std::vector<Event> spill;
+    std::mutex m_spill;
+    // the batch given to the owner
+    std::vector<Event> batch;
+    std::vector<unsigned int> entities;
+    bool any_entity;
+};
+
+} // End of event
+} // End of trillek
+
+#endif // DEFERREDEVENTS_HPP_INCLUDED
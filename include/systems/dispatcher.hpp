@@ -1,10 +1,14 @@
 #ifndef DISPATCHER_HPP
 #define DISPATCHER_HPP
 
-#include <list>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace trillek {
 namespace event {
@@ -18,11 +22,25 @@ public:
 };
 
 // Dispatches data change notifications to the various subscribers.
+//
+// The subscribers are stored in a flat table, with the entity IDs hashed
+// with open addressing. The table is never modified: Subscribe() and
+// Unsubscribe() publish a new table and retire the old one, which is
+// deleted when no notification is reading it anymore (read-copy-update).
+// Notifying does not lock, copy nor allocate, and can be done from any thread.
+//
+// A subscriber can still be notified by a notification that started before
+// it was unsubscribed: call Synchronize() before destroying it.
 template <typename T>
 class Dispatcher {
 private:
-    Dispatcher() { }
-    Dispatcher(const Dispatcher& right) {
+    Dispatcher() : table(new Table()), epoch(0) {
+        readers[0].store(0, std::memory_order_relaxed);
+        readers[1].store(0, std::memory_order_relaxed);
+    }
+    Dispatcher(const Dispatcher& right) : table(new Table()), epoch(0) {
+        readers[0].store(0, std::memory_order_relaxed);
+        readers[1].store(0, std::memory_order_relaxed);
         instance = right.instance;
     }
     Dispatcher& operator=(const Dispatcher& right) {
@@ -44,7 +62,12 @@ public:
 
         return Dispatcher<T>::instance;
     }
-    ~Dispatcher() { }
+    ~Dispatcher() {
+        delete table.load(std::memory_order_relaxed);
+        for (auto& r : retired) {
+            delete r.second;
+        }
+    }
 
     /**
      * \brief Subscribes to be notified of data change events.
@@ -54,21 +77,15 @@ public:
      * \return void
      */
     void Subscribe(const unsigned int entity_id, Subscriber<T>* subscriber) {
-        auto sube = this->subcriberss.find(entity_id);
-        if(sube == this->subcriberss.end()) {
-            // no subscriptions for entity, add the entity and subscriber
-            this->subcriberss[entity_id].push_back(subscriber);
-            return;
-        }
-        else {
-            // check if subscriber already exists
-            for(auto sub : sube->second) {
-                if(sub == subscriber) {
-                    return; // already subscribed
-                }
+        std::lock_guard<std::mutex> locker(m_write);
+        auto& list = this->subcriberss[entity_id];
+        for (auto sub : list) {
+            if (sub == subscriber) {
+                return; // already subscribed
             }
-            sube->second.push_back(subscriber);
         }
+        list.push_back(subscriber);
+        Publish();
     }
 
     /**
@@ -78,7 +95,9 @@ public:
      * \return void
      */
     void Subscribe(Subscriber<T>* subscriber) {
+        std::lock_guard<std::mutex> locker(m_write);
         this->subcriberss[0].push_back(subscriber);
+        Publish();
     }
 
     /**
@@ -89,8 +108,17 @@ public:
      * \return void
      */
     void Unsubscribe(const unsigned int entity_id, Subscriber<T>* subscriber)  {
-        if (this->subcriberss.find(entity_id) != this->subcriberss.end()) {
-            this->subcriberss[entity_id].remove(subscriber);
+        std::lock_guard<std::mutex> locker(m_write);
+        auto sube = this->subcriberss.find(entity_id);
+        if (sube != this->subcriberss.end()) {
+            auto& list = sube->second;
+            for (auto it = list.begin(); it != list.end(); ) {
+                it = *it == subscriber ? list.erase(it) : it + 1;
+            }
+            if (list.empty()) {
+                this->subcriberss.erase(sube);
+            }
+            Publish();
         }
     }
 
@@ -101,8 +129,21 @@ public:
      * \return void
      */
     void Unsubscribe(Subscriber<T>* subscriber) {
-        if (this->subcriberss.find(0) != this->subcriberss.end()) {
-            this->subcriberss[0].remove(subscriber);
+        Unsubscribe(0, subscriber);
+    }
+
+    /**
+     * \brief Waits for the notifications that started before the call.
+     *
+     * After the call, the unsubscribed subscribers are not notified anymore.
+     * It must not be called from a notification.
+     *
+     * \return void
+     */
+    void Synchronize() {
+        std::lock_guard<std::mutex> locker(m_write);
+        while (! Reclaim()) {
+            std::this_thread::yield();
         }
     }
 
@@ -114,11 +155,10 @@ public:
      * \return void
      */
     void NotifySubscribers(const unsigned int entity_id, const T* data) {
-        if (this->subcriberss.find(entity_id) != this->subcriberss.end()) {
-            auto subscriber_list = this->subcriberss.at(entity_id);
-            for (Subscriber<T>* subscriber : subscriber_list) {
-                subscriber->Notify(entity_id, data);
-            }
+        ReadLock lock(*this);
+        auto range = lock.table->Find(entity_id);
+        for (auto it = range.first; it != range.second; ++it) {
+            (*it)->Notify(entity_id, data);
         }
     }
 
@@ -129,15 +169,130 @@ public:
      * \return void
      */
     void NotifySubscribers(const T* data) {
-        if (this->subcriberss.find(0) != this->subcriberss.end()) {
-            auto subscriber_list = this->subcriberss.at(0);
-            for (Subscriber<T>* subscriber : subscriber_list) {
-                subscriber->Notify(data);
-            }
+        ReadLock lock(*this);
+        auto range = lock.table->Find(0);
+        for (auto it = range.first; it != range.second; ++it) {
+            (*it)->Notify(data);
         }
     }
 private:
-    std::map<unsigned int, std::list<Subscriber<T>*>> subcriberss;
+    // The subscribers of all entities, read by the notifications
+    class Table {
+    public:
+        typedef Subscriber<T>* const* iterator;
+
+        Table() : mask(0), slots(1) { }
+
+        explicit Table(const std::map<unsigned int, std::vector<Subscriber<T>*>>& subscribers) {
+            // keep at least half of the slots empty
+            size_t capacity = 2;
+            while (capacity < subscribers.size() * 2) {
+                capacity <<= 1;
+            }
+            mask = capacity - 1;
+            slots.resize(capacity);
+            for (auto& entity : subscribers) {
+                size_t i = Hash(entity.first) & mask;
+                while (slots[i].count) {
+                    i = (i + 1) & mask;
+                }
+                slots[i].entity_id = entity.first;
+                slots[i].first = static_cast<uint32_t>(this->subscribers.size());
+                slots[i].count = static_cast<uint32_t>(entity.second.size());
+                this->subscribers.insert(this->subscribers.end(), entity.second.begin(), entity.second.end());
+            }
+        }
+
+        // the subscribers of an entity
+        std::pair<iterator, iterator> Find(unsigned int entity_id) const {
+            for (size_t i = Hash(entity_id) & mask; slots[i].count; i = (i + 1) & mask) {
+                if (slots[i].entity_id == entity_id) {
+                    iterator first = subscribers.data() + slots[i].first;
+                    return std::make_pair(first, first + slots[i].count);
+                }
+            }
+            return std::make_pair(iterator(nullptr), iterator(nullptr));
+        }
+
+    private:
+        struct Slot {
+            Slot() : entity_id(0), first(0), count(0) { }
+            unsigned int entity_id;
+            uint32_t first;
+            // 0 if the slot is empty
+            uint32_t count;
+        };
+
+        static size_t Hash(unsigned int entity_id) {
+            // Fibonacci hashing spreads the consecutive IDs
+            const uint32_t h = static_cast<uint32_t>(entity_id) * 2654435761u;
+            return static_cast<size_t>(h ^ (h >> 16));
+        }
+
+        size_t mask;
+        std::vector<Slot> slots;
+        std::vector<Subscriber<T>*> subscribers;
+    };
+
+    // Marks a notification as reading the table
+    struct ReadLock {
+        explicit ReadLock(const Dispatcher& dispatcher) : counter(nullptr) {
+            while (1) {
+                const unsigned int e = dispatcher.epoch.load(std::memory_order_seq_cst);
+                counter = &dispatcher.readers[e & 1];
+                counter->fetch_add(1, std::memory_order_seq_cst);
+                if (dispatcher.epoch.load(std::memory_order_seq_cst) == e) {
+                    break;
+                }
+                // a table was retired meanwhile, count in the new epoch
+                counter->fetch_sub(1, std::memory_order_release);
+            }
+            table = dispatcher.table.load(std::memory_order_seq_cst);
+        }
+        ~ReadLock() {
+            counter->fetch_sub(1, std::memory_order_release);
+        }
+        std::atomic<unsigned int>* counter;
+        const Table* table;
+    };
+
+    // Replace the table by a copy of the subscribers, under m_write
+    void Publish() {
+        std::unique_ptr<Table> next(new Table(this->subcriberss));
+        const Table* old = table.exchange(next.release(), std::memory_order_seq_cst);
+        // the readers counted in the epoch that ends may read the old table
+        const unsigned int e = epoch.fetch_add(1, std::memory_order_seq_cst);
+        retired.push_back(std::make_pair(e, old));
+        Reclaim();
+    }
+
+    // Delete the retired tables that nobody reads, under m_write
+    //
+    // A reader counted in an epoch can load a table published after the
+    // epoch began, until the next epoch starts: the tables retired later
+    // than one still read can be read too. They are deleted in the order
+    // they were retired, stopping at the first one whose epoch has readers.
+    bool Reclaim() {
+        auto it = retired.begin();
+        for (; it != retired.end(); ++it) {
+            if (readers[it->first & 1].load(std::memory_order_seq_cst)) {
+                break;
+            }
+            delete it->second;
+        }
+        retired.erase(retired.begin(), it);
+        return retired.empty();
+    }
+
+    std::map<unsigned int, std::vector<Subscriber<T>*>> subcriberss;
+    // the table read by the notifications
+    std::atomic<const Table*> table;
+    // the number of readers in each epoch, by parity
+    mutable std::atomic<unsigned int> readers[2];
+    std::atomic<unsigned int> epoch;
+    // the replaced tables, with the epoch of their last readers
+    std::vector<std::pair<unsigned int, const Table*>> retired;
+    std::mutex m_write;
 };
 
 template<typename T>
@@ -12,6 +12,7 @@
 #include <future>
 #include <iostream>
 #include "trillek.hpp"
+#include "symbol.hpp"
 #include "type-id.hpp"
 #include "trillek-scheduler.hpp"
 #include "component-factory.hpp"
@@ -22,7 +23,9 @@
 #include "graphics/render-layer.hpp"
 #include "graphics/texture.hpp"
 #include <map>
-#include "systems/dispatcher.hpp"
+#include <unordered_map>
+#include "systems/deferred-events.hpp"
+#include "systems/transform-system.hpp"
 #include "os.hpp"
 
 namespace trillek {
@@ -81,6 +84,9 @@ public:
      */
     void ThreadInit() override;
 
+    // the graphic context is current on one thread only
+    bool ThreadBound() const override { return true; };
+
     /** \brief Renders all the passes for a scene and updates screen.
      */
     void RenderScene() const;
@@ -187,7 +193,7 @@ public:
                 std::string obj_name(section_itr->name.GetString(), section_itr->name.GetStringLength());
                 std::shared_ptr<RT> objgen_ptr(new RT);
                 if(objgen_ptr->Parse(obj_name, section_itr->value)) {
-                    rensys.Add(obj_name, objgen_ptr);
+                    rensys.Add(Symbol(obj_name), objgen_ptr);
                 }
             }
             return true;
@@ -198,8 +204,11 @@ public:
     void RegisterStaticParsers();
     void RegisterListResolvers();
 
+    /**
+     * \brief Gets a graphics object by name.
+     */
     template<class T>
-    std::shared_ptr<T> Get(const std::string & instancename) const {
+    std::shared_ptr<T> Get(Symbol instancename) const {
         unsigned int type_id = reflection::GetTypeID<T>();
         auto typedmap = this->graphics_instances.find(type_id);
         if(typedmap == this->graphics_instances.end()) {
@@ -215,7 +224,7 @@ public:
      * \brief Adds a graphics object to the system.
      */
     template<typename T>
-    void Add(const std::string & instancename, std::shared_ptr<T> instanceptr) {
+    void Add(Symbol instancename, std::shared_ptr<T> instanceptr) {
         unsigned int type_id = reflection::GetTypeID<T>();
         graphics_instances[type_id][instancename] = instanceptr;
     }
@@ -267,7 +276,7 @@ private:
         }
     }
 
-    void UpdateModelMatrices();
+    void UpdateModelMatrices(const TransformUpdates& transforms);
 
     int gl_version[3];
     int debugmode;
@@ -307,17 +316,20 @@ private:
 
     std::map<RenderCmd, std::function<bool(RenderCommandItem&)>> list_resolvers;
 
-    std::map<unsigned int, std::map<std::string, std::shared_ptr<GraphicsBase>>> graphics_instances;
+    std::map<unsigned int, std::unordered_map<Symbol, std::shared_ptr<GraphicsBase>>> graphics_instances;
     std::map<unsigned int, glm::mat4> model_matrices;
+    // the first commit of the updated transforms not applied yet
+    uint64_t next_transforms;
     std::list<MaterialGroup> material_groups;
-    std::shared_future<std::shared_ptr<const std::map<unsigned int,const Transform*>>> updated_transforms;
+    // The keyboard events, handled in HandleEvents()
+    event::DeferredEvents<KeyboardEvent> keyboard_events;
 };
 
 /**
  * \brief Adds a graphics Texture to the system.
  */
 template<>
-void RenderSystem::Add(const std::string & instancename, std::shared_ptr<Texture> instanceptr);
+void RenderSystem::Add(Symbol instancename, std::shared_ptr<Texture> instanceptr);
 
 /**
  * \brief Adds a renderable component to the system.
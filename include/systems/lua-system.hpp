@@ -5,7 +5,7 @@
 #include <map>
 #include <list>
 
-#include "dispatcher.hpp"
+#include "deferred-events.hpp"
 #include "os-event.hpp"
 #include "trillek.hpp"
 #include "systems/system-base.hpp"
@@ -125,6 +125,10 @@ private:
     lua_State* L;
     frame_unit delta; // The time since the last HandleEvents was called.
     std::map<int, std::list<std::string>> event_handlers; // Mapping of event ID to script function.
+    // The input events, delivered to the scripts in HandleEvents()
+    event::DeferredEvents<KeyboardEvent> keyboard_events;
+    event::DeferredEvents<MouseBtnEvent> mousebtn_events;
+    event::DeferredEvents<MouseMoveEvent> mousemove_events;
 };
 
 } // End of script
@@ -5,6 +5,15 @@
 
 namespace trillek {
 class MetaEngineSystem : public SystemBase {
+public:
+    MetaEngineSystem() {
+        DeclareWrite(SystemData::TRANSFORMS);
+    };
+
+    // the graphic system needs its context
+    bool ThreadBound() const override { return true; };
+
+private:
     void ThreadInit() override;
 
     void RunBatch() const override;
@@ -9,7 +9,7 @@
 #include "trillek.hpp"
 #include "async-data.hpp"
 #include "trillek-scheduler.hpp"
-#include "atomic-map.hpp"
+#include "atomic-hash-map.hpp"
 #include "systems/system-base.hpp"
 
 namespace trillek {
@@ -134,8 +134,8 @@ private:
 
     std::map<unsigned int, std::shared_ptr<Collidable>> bodies;
 
-    AtomicMap<unsigned int, btVector3> forces;
-    AtomicMap<unsigned int, btVector3> torques;
+    AtomicHashMap<unsigned int, btVector3> forces;
+    AtomicHashMap<unsigned int, btVector3> torques;
     AsyncData<std::map<id_t,btVector3>> async_forces;
     AsyncData<std::map<id_t,btVector3>> async_torques;
 
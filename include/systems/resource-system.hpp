@@ -2,12 +2,16 @@
 #define RESOURCE_SYSTEM_HPP_INCLUDED
 
 #include <string>
+#include <functional>
 #include <memory>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 #include "property.hpp"
+#include "symbol.hpp"
 #include "trillek.hpp"
+#include "trillek-allocator.hpp"
 #include "util/json-parser.hpp"
 
 namespace trillek {
@@ -50,7 +54,7 @@ public:
             ResourceMap::instance.reset(new ResourceMap());
 
                 // Set up the default factory for an unknown type to return false.
-                auto lambda = [ ] (const std::string& name, const std::vector<Property> &properties) {
+                auto lambda = [ ] (Symbol name, const std::vector<Property> &properties) {
                     return nullptr;
                 };
 
@@ -75,7 +79,7 @@ public:
         resource_type_id[reflection::GetTypeName<T>()] = reflection::GetTypeID<T>();
 
         // Create a lambda function that calls Create with the correct template type.
-        auto lambda = [] (const std::string& name, const std::vector<Property> &properties) {
+        auto lambda = [] (Symbol name, const std::vector<Property> &properties) {
             return instance->Create<T>(name, properties);
         };
 
@@ -98,16 +102,19 @@ public:
     /**
      * \brief Gets a resource by the given name.
      *
-     * \param[in] const std::string& name Name of the resource to retrieve.
+     * \param[in] Symbol name Name of the resource to retrieve.
      * \return std::shared_ptr<T> Returns nullptr if the resource hasn't been created yet, otherwise the requested resource..
      */
     template<class T>
-    static std::shared_ptr<T> Get(const std::string& name) {
+    static std::shared_ptr<T> Get(Symbol name) {
         unsigned int type_id = reflection::GetTypeID<T>();
-        if (instance->resources[type_id].find(name) == instance->resources[type_id].end()) {
+        std::lock_guard<std::recursive_mutex> locker(m_resources);
+        auto& typed_resources = instance->resources[type_id];
+        auto resource = typed_resources.find(name);
+        if (resource == typed_resources.end()) {
             return nullptr;
         }
-        return std::static_pointer_cast<T>(instance->resources[type_id][name]);
+        return std::static_pointer_cast<T>(resource->second);
     }
 
     /**
@@ -117,11 +124,11 @@ public:
      * only return wether it was created successfully or not. This is because you can't template the retrun value
      * if you don't have the type information.
      * \param[in] const std::string type_name The string name of the type of resource to create. This is used to select the correct factory.
-     * \param[in] const std::string & name What the created resource will be named.
+     * \param[in] Symbol name What the created resource will be named.
      * \param[in] const std::vector<Property> & properties The creation properties for the resource.
      * \return bool True if the resource loaded successfully. Get must be used, later, where the type information is known to retrieve the resource if it was loaded correctly.
      */
-    static bool Create(const std::string type_name, const std::string& name, const std::vector<Property> &properties) {
+    static bool Create(const std::string type_name, Symbol name, const std::vector<Property> &properties) {
         if (instance->factories.find(type_name) != instance->factories.end()) {
             return instance->factories[type_name](name, properties) != nullptr;
         }
@@ -131,15 +138,16 @@ public:
     /**
      * \brief Creates a resource with the given name and initializes it. This is used at compile time when type information is known.
      *
-     * \param[in] const std::string & name The name of the resource to create.
+     * \param[in] Symbol name The name of the resource to create.
      * \param[in] const std::vector<Property> & properties The creation properties for the resource.
      * \return std::shared_ptr<T> Returns nullptr if it failed to be created, otherwise the created resource.
      */
     template<class T>
-    static std::shared_ptr<T> Create(const std::string& name, const std::vector<Property> &properties) {
+    static std::shared_ptr<T> Create(Symbol name, const std::vector<Property> &properties) {
         unsigned int type_id = reflection::GetTypeID<T>();
+        std::lock_guard<std::recursive_mutex> locker(m_resources);
         if (instance->resources[type_id].find(name) == instance->resources[type_id].end()) {
-            instance->resources[type_id][name] = std::make_shared<T>();
+            instance->resources[type_id][name] = std::allocate_shared<T>(TrillekAllocator<T, MemoryTag::RESOURCES>());
             if (!instance->resources[type_id][name]->Initialize(properties)) {
                 instance->resources[type_id].erase(name);
                 return nullptr;
@@ -148,16 +156,53 @@ public:
         return std::static_pointer_cast<T>(instance->resources[type_id][name]);
     }
 
+    /**
+     * \brief Creates a resource with the given name without blocking the calling thread.
+     *
+     * The resource is initialized in the I/O lane of the scheduler, then added and passed to the
+     * callback in a task of the frame threads. If the resource already exists, it is passed to the
+     * callback at once.
+     * \param[in] Symbol name The name of the resource to create.
+     * \param[in] const std::vector<Property> & properties The creation properties for the resource.
+     * \param[in] std::function<void(std::shared_ptr<T>)> callback Called with the created resource, or nullptr if it failed to be created.
+     * \return void
+     */
+    template<class T>
+    static void CreateAsync(Symbol name, const std::vector<Property> &properties,
+                            std::function<void(std::shared_ptr<T>)> callback) {
+        auto existing = Get<T>(name);
+        if (existing) {
+            callback(existing);
+            return;
+        }
+        auto resource = std::allocate_shared<T>(TrillekAllocator<T, MemoryTag::RESOURCES>());
+        QueueLoad([resource, properties] () { return resource->Initialize(properties); },
+            [name, resource, callback] (bool loaded) {
+                if (!loaded) {
+                    callback(nullptr);
+                    return;
+                }
+                // keep the resource created by another call meanwhile
+                auto created = Get<T>(name);
+                if (!created) {
+                    Add<T>(name, resource);
+                    created = resource;
+                }
+                callback(created);
+            });
+    }
+
     /**
      * \brief Adds a resource to be managed by the system.
      *
-     * \param[in] const std::string & name The name of the resource.
+     * \param[in] Symbol name The name of the resource.
      * \param[in] std::shared_ptr<T> r The resource to add.
      * \return void
      */
     template<class T>
-    static void Add(const std::string& name, std::shared_ptr<T> r) {
+    static void Add(Symbol name, std::shared_ptr<T> r) {
         unsigned int type_id = reflection::GetTypeID<T>();
+        std::lock_guard<std::recursive_mutex> locker(m_resources);
         instance->resources[type_id][name] = r;
     }
 
@@ -167,10 +212,11 @@ public:
      * This doesn't invalidate any strong references to the resource as it doesn't destroy the resource.
      * Any weak references to the resource should be checked to make sure they are valid and haven't been
      * removed.
-     * \param[in] const std::string & name Name of the resource to remove.
+     * \param[in] Symbol name Name of the resource to remove.
      * \return void
      */
-    static void Remove(const std::string& name) {
+    static void Remove(Symbol name) {
+        std::lock_guard<std::recursive_mutex> locker(m_resources);
         for (const auto& list : instance->resources) {
             if (list.second.find(name) != list.second.end()) {
                 instance->resources[list.first].erase(name);
@@ -182,10 +228,11 @@ public:
     /**
      * \brief Checks if a resource exists with the given name.
      *
-     * \param[in] const std::string& name Name of the resource to check if it exists.
+     * \param[in] Symbol name Name of the resource to check if it exists.
      * \return bool True if the resource exists.
      */
-    static bool Exists(const std::string& name) {
+    static bool Exists(Symbol name) {
+        std::lock_guard<std::recursive_mutex> locker(m_resources);
         for (const auto& list : instance->resources) {
             if (list.second.find(name) != list.second.end()) {
                 return true;
@@ -211,9 +258,19 @@ public:
     // Inherited from Parse
     virtual bool Parse(rapidjson::Value& node);
 private:
-    static std::map<unsigned int, std::map<std::string, std::shared_ptr<ResourceBase>>> resources; // Mapping of resource TypeID to loaded resources
+    /**
+     * \brief Runs a loading function in the I/O lane of the scheduler, then a callback in a frame task.
+     *
+     * \param[in] std::function<bool(void)> && load The loading function.
+     * \param[in] std::function<void(bool)> && done The callback, called with the result of the loading function.
+     * \return void
+     */
+    static void QueueLoad(std::function<bool(void)>&& load, std::function<void(bool)>&& done);
+
+    static std::recursive_mutex m_resources; // Guards the resources, that can be added from any thread
+    static std::map<unsigned int, std::unordered_map<Symbol, std::shared_ptr<ResourceBase>>> resources; // Mapping of resource TypeID to loaded resources
     static std::map<std::string, unsigned int> resource_type_id; // Stores a mapping of TypeName to TypeID
-    static std::map<std::string, std::function<std::shared_ptr<ResourceBase>(const std::string& name, const std::vector<Property> &properties)>> factories; // Mapping of type ID to factory function.
+    static std::map<std::string, std::function<std::shared_ptr<ResourceBase>(Symbol name, const std::vector<Property> &properties)>> factories; // Mapping of type ID to factory function.
 };
 
 } // End of system
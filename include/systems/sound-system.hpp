@@ -72,7 +72,10 @@ public:
 
 class System : public util::Parser, public SystemBase {
 private:
-    System() : Parser("sounds") { }
+    System() : Parser("sounds"), next_transforms(0) {
+        DeclareRead(SystemData::TRANSFORMS);
+        SetTickRate(30);
+    }
     System(const System& right) : Parser("sounds")  {
         instance = right.instance;
     }
@@ -147,6 +150,8 @@ private:
     };
 
     std::unordered_map<std::string, std::shared_ptr<sound_info>> sounds;
+    // the first commit of the updated transforms not read yet
+    uint64_t next_transforms;
 }; // end of class System
 
 } // end of namespace sound
@@ -3,16 +3,34 @@
 
 #include "trillek-scheduler.hpp"
 #include <memory>
+#include <vector>
 
 namespace trillek {
 
 class ComponentBase;
 
+/** \brief Data shared between systems during a frame
+ *
+ * Systems declare the data they read and write, and the scheduler orders
+ * them in each frame from these declarations.
+ */
+enum class SystemData : unsigned int {
+    TRANSFORMS      // the transforms updated by the physics
+};
+
+/** \brief What the scheduler does when a system is late by several ticks
+ */
+enum class CatchUpPolicy {
+    SKIP,   // run one tick and drop the others
+    CLAMP,  // run a limited number of late ticks, drop the others
+    BURST   // run all the late ticks back to back
+};
+
 class SystemBase {
 
 public:
 
-    SystemBase() {};
+    SystemBase() : tick_period(0), catch_up(CatchUpPolicy::SKIP), max_catch_up(4) {};
     virtual ~SystemBase() {};
 
     /** \brief This function is executed when a thread is attached to the system
@@ -58,6 +76,86 @@ public:
      * \param std::shared_ptr<ComponentBase> component The component to add.
      */
     virtual void AddComponent(const unsigned int entity_id, std::shared_ptr<ComponentBase> component) { }
+
+    /** \brief Tell if the system must always run on the same thread
+     *
+     * When true, HandleEvents() and RunBatch() are always called by the
+     * thread that called ThreadInit(), e.g to keep a graphic context current.
+     *
+     * \return bool true if the system is bound to its thread
+     */
+    virtual bool ThreadBound() const { return false; };
+
+    /** \brief Set how often the system runs
+     *
+     * Must be called before the scheduler is initialized. By default, the
+     * system runs once per frame of the scheduler.
+     *
+     * \param rate unsigned int the number of ticks per second, 0 for once per frame
+     * \param policy CatchUpPolicy what to do when the system is late
+     * \param max_catch_up unsigned int the number of late ticks run with CLAMP
+     */
+    void SetTickRate(unsigned int rate, CatchUpPolicy policy = CatchUpPolicy::SKIP, unsigned int max_catch_up = 4) {
+        tick_period = rate ? frame_unit(1000000000 / rate) : frame_unit(0);
+        catch_up = policy;
+        this->max_catch_up = max_catch_up;
+    };
+
+    /** \brief Get the duration between two ticks
+     *
+     * \return frame_unit the duration, 0 for once per frame
+     */
+    frame_unit TickPeriod() const { return tick_period; };
+
+    /** \brief Get what the scheduler does when the system is late
+     *
+     * \return CatchUpPolicy the policy
+     */
+    CatchUpPolicy GetCatchUpPolicy() const { return catch_up; };
+
+    /** \brief Get the number of late ticks run with CLAMP
+     *
+     * \return unsigned int the number of ticks
+     */
+    unsigned int MaxCatchUp() const { return max_catch_up; };
+
+    /** \brief Get the data read by the system during a frame
+     *
+     * \return const std::vector<SystemData>& the data
+     */
+    const std::vector<SystemData>& GetReads() const { return reads; };
+
+    /** \brief Get the data written by the system during a frame
+     *
+     * \return const std::vector<SystemData>& the data
+     */
+    const std::vector<SystemData>& GetWrites() const { return writes; };
+
+protected:
+    /** \brief Declare that the system reads data during a frame
+     *
+     * In a frame, the system runs after the systems registered before it
+     * that write the data.
+     *
+     * \param data SystemData the data
+     */
+    void DeclareRead(SystemData data) { reads.push_back(data); };
+
+    /** \brief Declare that the system writes data during a frame
+     *
+     * In a frame, the system runs after the systems registered before it
+     * that read or write the data.
+     *
+     * \param data SystemData the data
+     */
+    void DeclareWrite(SystemData data) { writes.push_back(data); };
+
+private:
+    std::vector<SystemData> reads;
+    std::vector<SystemData> writes;
+    frame_unit tick_period;
+    CatchUpPolicy catch_up;
+    unsigned int max_catch_up;
 };
 
 } // namespace trillek
@@ -4,11 +4,14 @@
 #include <memory>
 #include <map>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "trillek.hpp"
 #include "util/json-parser.hpp"
 #include "systems/async-data.hpp"
-#include "atomic-map.hpp"
+#include "atomic-hash-map.hpp"
+#include "pool-allocator.hpp"
 
 namespace trillek {
 
@@ -17,11 +20,16 @@ namespace physics {
 class PhysicsSystem;
 }
 
+// The transforms updated during a tick of the physics, in no particular order
+typedef std::vector<std::pair<id_t,const Transform*>> TransformUpdates;
+
 // Stores a mapping of entity ID to transform that can
 // be accessed via static methods anywhere.
 class TransformMap : public util::Parser {
 private:
-    TransformMap() : Parser("transforms") { }
+    // keep 12 ticks of updated transforms (100 ms at 120 Hz): the render and sound
+    // systems read every tick since their last frame, i.e. 2 and 4 ticks
+    TransformMap() : Parser("transforms"), async_updated_transforms(15, 12) { }
     TransformMap(const TransformMap& right) : Parser("transforms") {
         instance = right.instance;
     }
@@ -70,7 +78,16 @@ public:
     */
     static void RemoveTransform(const unsigned int entity_id);
 
-    static AsyncData<std::map<id_t,const Transform*>>& GetAsyncUpdatedTransforms() {
+    /**
+    * \brief Gets the statistics of the pool of the transforms.
+    *
+    * \return PoolStats The capacity and the usage of the pool.
+    */
+    static PoolStats GetPoolStats() {
+        return PoolAllocator<Transform>::Stats();
+    }
+
+    static AsyncData<TransformUpdates>& GetAsyncUpdatedTransforms() {
         return instance->async_updated_transforms;
     }
 
@@ -84,14 +101,14 @@ private:
     friend class Transform;
     friend class physics::PhysicsSystem;
 
-    static AtomicMap<id_t,const Transform*>& GetUpdatedTransforms() {
+    static AtomicHashMap<id_t,const Transform*>& GetUpdatedTransforms() {
         return instance->updated_transforms;
     };
 
     std::map<unsigned int, std::shared_ptr<Transform>> transforms;
 
-    AtomicMap<id_t,const Transform*> updated_transforms;
-    AsyncData<std::map<id_t,const Transform*>> async_updated_transforms;
+    AtomicHashMap<id_t,const Transform*> updated_transforms;
+    AsyncData<TransformUpdates> async_updated_transforms;
 };
 
 } // End of trillek
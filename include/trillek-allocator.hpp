@@ -3,12 +3,16 @@
 
 #include <cstddef>
 #include <stdlib.h>
-
-extern size_t gAllocatedSize;
+#include <utility>
+#include "memory-accounting.hpp"
 
 namespace trillek {
 
-template<typename T>
+/** \brief An allocator counting its memory for a subsystem
+ *
+ * See MemoryAccounting.
+ */
+template<typename T, MemoryTag Tag = MemoryTag::GENERAL>
 class TrillekAllocator {
 public:
     typedef size_t size_type;
@@ -19,26 +23,24 @@ public:
     typedef const T& const_reference;
     typedef T value_type;
 
-    /// Define a global that holds the allocated size
-
     /// Default constructor
     TrillekAllocator() throw() { }
     /// Copy constructor
     TrillekAllocator(const TrillekAllocator&) throw() { }
     /// Copy constructor with another type
     template<typename U>
-    TrillekAllocator(const TrillekAllocator<U>&) throw() { }
+    TrillekAllocator(const TrillekAllocator<U, Tag>&) throw() { }
 
     /// Destructor
     ~TrillekAllocator() { }
 
     /// Copy
-    TrillekAllocator<T>& operator=(const TrillekAllocator&) {
+    TrillekAllocator& operator=(const TrillekAllocator&) {
         return *this;
     }
     /// Copy with another type
     template<typename U>
-    TrillekAllocator& operator=(const TrillekAllocator<U>&) {
+    TrillekAllocator& operator=(const TrillekAllocator<U, Tag>&) {
         return *this;
     }
 
@@ -58,14 +60,14 @@ public:
     /// Allocate memory
     pointer allocate(size_type n, const void* = 0) {
         size_type size = n * sizeof(value_type);
-        gAllocatedSize += size;
+        MemoryAccounting::Allocate(Tag, size);
         return (pointer)::malloc(size);
     }
 
     /// Deallocate memory
     void deallocate(void* p, size_type n) {
         size_type size = n * sizeof(T);
-        gAllocatedSize -= size;
+        MemoryAccounting::Deallocate(Tag, size);
         ::free(p);
     }
 
@@ -99,7 +101,7 @@ public:
     /// A struct to rebind the allocator to another allocator of type U
     template<typename U>
     struct rebind {
-        typedef TrillekAllocator<U> other;
+        typedef TrillekAllocator<U, Tag> other;
     };
 };
 
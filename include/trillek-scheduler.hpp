@@ -1,188 +1,199 @@
 #ifndef TRILLEKSCHEDULER_H_INCLUDED
 #define TRILLEKSCHEDULER_H_INCLUDED
 
-#define MAX_CONCURRENT_THREAD   4
-
 #include <chrono>
 #include <functional>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <queue>
-#include <list>
-#include <iterator>
+#include <vector>
 #include "atomic-queue.hpp"
-
-#define		STOP		0
-#define 	SPLIT		1
-#define		CONTINUE	2
-#define		REQUEUE		3
-#define		REPEAT		4
+#include "memory-accounting.hpp"
+#include "scheduler/task-request.hpp"
+#include "scheduler/task-pool.hpp"
+#include "scheduler/system-graph.hpp"
+#include "scheduler/parallel-job.hpp"
+#include "scheduler/concurrency-controller.hpp"
+#include "scheduler/clock.hpp"
+#include "scheduler/io-lane.hpp"
+#include "scheduler/scheduler-telemetry.hpp"
 
 namespace trillek {
 
-using namespace std::chrono;
-
 class SystemBase;
 
-typedef std::function<int(void)> block_t;
-typedef std::list<block_t> chain_t;
-
-typedef std::chrono::nanoseconds frame_unit;
-#if defined(_MSC_VER)
-// Visual Studio implements steady_clock as system_clock
-// TODO : wait for the fix from Microsoft
-typedef time_point<system_clock, frame_unit> frame_tp;
-typedef time_point<system_clock, frame_unit> glfw_tp;
-#else
-typedef time_point<steady_clock, frame_unit> frame_tp;
-typedef time_point<steady_clock, frame_unit> glfw_tp;
-#endif
-
-class TaskRequestBase {
-public:
-    TaskRequestBase(frame_tp&& timestamp) :
-        timestamp(std::move(timestamp))
-        {};
+/** \brief How the queued tasks are shared between the threads
+ */
+enum class TaskPoolMode {
+    GLOBAL_QUEUE,   // one queue shared by all threads
+    WORK_STEALING   // one queue per thread, idle threads steal from the others
+};
 
-    virtual ~TaskRequestBase() {};
+/** \brief Scheduler for trillek engine
+ */
+class TrillekScheduler {
+public:
+    // by default, one frame has a duration of 16666666 nanoseconds of real time
+    TrillekScheduler() : frame_begin(0), frame_number(0), memory_report_frames(0),
+        memory_report_out(nullptr), one_frame(16666666), sleepers(0), nr_worker(0),
+        pool_mode(TaskPoolMode::GLOBAL_QUEUE), pool(new GlobalTaskPool()), clock(new RealClock()) {};
+    virtual ~TrillekScheduler() {};
 
-    bool operator<(const TaskRequestBase& tqe) const {
-        return this->timestamp < tqe.timestamp;
+    /** \brief Choose how the tasks are shared between the threads
+     *
+     * The mode is applied by Initialize(). The default is GLOBAL_QUEUE.
+     *
+     * \param mode TaskPoolMode the mode
+     *
+     */
+    void SetTaskPoolMode(TaskPoolMode mode) {
+        pool_mode = mode;
     }
 
-    virtual void RunTask() = 0;
-
-    glfw_tp Now() const;
-
-    bool IsNow() const {
-        return timestamp < Now();
+    /** \brief Set the minimum share of the background tasks
+     *
+     * The frame-critical tasks run first. While both kinds of tasks are
+     * waiting, a background task runs at least once every interval tasks.
+     * The default is 8.
+     *
+     * \param interval unsigned int the interval, at least 1
+     *
+     */
+    void SetBackgroundInterval(unsigned int interval) {
+        pool->SetBackgroundInterval(interval);
     }
 
-    void Reschedule(frame_unit&& delay) {
-        timestamp = Now() + delay;
+    /** \brief Choose the source of time
+     *
+     * Must be called before Initialize(). The default is RealClock.
+     *
+     * \param new_clock std::unique_ptr<Clock>&& the clock
+     *
+     */
+    void SetClock(std::unique_ptr<Clock>&& new_clock) {
+        clock = std::move(new_clock);
     }
 
-    frame_tp Timepoint() const {
-        return timestamp;
+    /** \brief Get the source of time
+     *
+     * \return Clock& the clock
+     *
+     */
+    Clock& GetClock() {
+        return *clock;
     }
 
-protected:
-    frame_tp timestamp;
-};
-
-template<class T>
-class TaskRequest : public TaskRequestBase {
-public:
-    TaskRequest(T&& funct) :
-        funct(std::forward<T>(funct)),
-        TaskRequestBase(Now())
-        {};
+    /** \brief Get the current time
+     *
+     * \return frame_tp the time
+     *
+     */
+    frame_tp Now() const {
+        return clock->Now();
+    }
 
-    TaskRequest(T&& funct, const frame_unit& delay) :
-        funct(std::forward<T>(funct)),
-        TaskRequestBase(Now() + delay)
-        {};
+    /** \brief Set the duration of a frame
+     *
+     * Must be called before Initialize(). The default is 1/60 second.
+     *
+     * \param length const frame_unit& the duration
+     *
+     */
+    void SetFrameLength(const frame_unit& length) {
+        one_frame = length;
+    }
 
-    virtual ~TaskRequest() {};
+    /** \brief Get the duration of a frame
+     *
+     * \return frame_unit the duration
+     *
+     */
+    frame_unit FrameLength() const {
+        return one_frame;
+    }
 
-    void RunTask() override {
-        funct();
+    /** \brief Set the maximum number of threads of the I/O lane
+     *
+     * The default is 2.
+     *
+     * \param max unsigned int the maximum, at least 1
+     *
+     */
+    void SetIOThreads(unsigned int max) {
+        io_lane.SetMaxThreads(max);
     }
-private:
-    const T funct;
-};
 
-template<>
-class TaskRequest<chain_t> : public TaskRequestBase {
-public:
-    TaskRequest(const chain_t& chain) :
-        block(chain.cbegin()),
-        block_end(chain.cend()),
-        TaskRequestBase(Now())
-        {};
-
-    TaskRequest(const chain_t& chain, const frame_unit& delay) :
-        block(chain.cbegin()),
-        block_end(chain.cend()),
-        TaskRequestBase(Now() + delay)
-        {};
-
-    TaskRequest(chain_t&& chain) = delete;
-
-    TaskRequest(chain_t&& chain, const frame_unit& delay) = delete;
-
-    TaskRequest(std::shared_ptr<chain_t>&& chain) :
-        chain(std::move(chain)),
-        block(this->chain->cbegin()),
-        block_end(this->chain->cend()),
-        TaskRequestBase(Now())
-        {};
-
-    TaskRequest(std::shared_ptr<chain_t>&& chain, const frame_unit& delay) :
-        chain(std::move(chain)),
-        block(this->chain->cbegin()),
-        block_end(this->chain->cend()),
-        TaskRequestBase(Now() + delay)
-        {};
-
-    virtual ~TaskRequest() {};
-
-    TaskRequest<chain_t>& operator++() {
-        if (block_end != block) {
-            ++block;
-        }
-        return *this;
-    }
-
-    void RunTask() override {
-        for(auto& b = block; block_end != b; ++b) {
-            auto s = (*b)();
-            switch(s) {
-            case REQUEUE:
-                // "*this" is now undefined
-                // we delay the execution of 1/10 frame
-                queue_task(std::make_shared<TaskRequest<chain_t>>(std::move(*this)), frame_unit(1666666));
-            case STOP:
-                return;
-            case SPLIT:
-                // Queue a thread to execute this block again, and continue the chain
-                // we delay the execution of 1/10 frame
-                queue_task(std::make_shared<TaskRequest<chain_t>>(*this), frame_unit(1666666));
-                break;
-            case REPEAT:
-                --b;
-            case CONTINUE:
-            default:
-                break;
-            }
-        }
+    /** \brief Get the lane running the blocking I/O jobs
+     *
+     * \return IOLane& the lane
+     *
+     */
+    IOLane& GetIOLane() {
+        return io_lane;
     }
 
-    static void Initialize(std::function<void(std::shared_ptr<TaskRequest<chain_t>>&&, frame_unit&&)>&& f) {
-        queue_task = std::move(f);
-    };
+    /** \brief Get the tick counters of a system
+     *
+     * \param system const SystemBase* the system
+     * \return SystemTickStats the counters, all 0 if the system is not run by the scheduler
+     *
+     */
+    SystemTickStats GetTickStats(const SystemBase* system) const {
+        return graph ? graph->GetTickStats(system) : SystemTickStats();
+    }
 
-private:
-    static std::function<void(std::shared_ptr<TaskRequest<chain_t>>&&, frame_unit&&)> queue_task;
-    const std::shared_ptr<chain_t> chain;
-    chain_t::const_iterator block;
-    const chain_t::const_iterator block_end;
-};
+    /** \brief Get the controller limiting the number of tasks running at once
+     *
+     * The tasks are taken from the pool only when their class has a free
+     * slot, the systems bound to a thread are not limited. The limits can be
+     * changed at any time, a sleeping thread sees a raised limit at the next
+     * frame.
+     *
+     * \return ConcurrencyController& the controller
+     *
+     */
+    ConcurrencyController& GetConcurrencyController() {
+        return concurrency;
+    }
 
+    /** \brief Write the memory accounting report periodically
+     *
+     * The report is written by a background task, see MemoryAccounting::Dump().
+     *
+     * \param frames unsigned int the number of frames between two reports, 0 to stop
+     * \param out std::ostream& the stream, it must live until the reports stop
+     *
+     */
+    void SetMemoryReportInterval(unsigned int frames, std::ostream& out = std::clog) {
+        memory_report_out.store(&out);
+        memory_report_frames.store(frames);
+    }
 
-/** \brief Scheduler for trillek engine
- */
-class TrillekScheduler {
-public:
-    // one frame has a duration of 16666666 nanoseconds
-    TrillekScheduler() : counter(0), one_frame(16666666) {};
-    virtual ~TrillekScheduler() {};
+    /** \brief Get the measures of the scheduler
+     *
+     * The measures are always recorded. Call Dump() on the result to get
+     * a report.
+     *
+     * \return SchedulerTelemetry& the measures
+     *
+     */
+    SchedulerTelemetry& GetTelemetry() {
+        return telemetry;
+    }
 
-    /** \brief Launch the threads and attach them to system
+    /** \brief Launch the threads and run the systems each frame
+     *
+     * The systems are ordered by the data they read and write, in
+     * registration order (see SystemGraph). Independent systems run
+     * concurrently on any thread, except the systems bound to a thread.
      *
      * \param nr_thread unsigned int number of threads to launch
-     * \param systems std::queue<System*>&& list of systems to attach
+     * \param systems std::queue<System*>&& list of systems to run
      *
      */
     void Initialize(unsigned int nr_thread, std::queue<SystemBase*>& systems);
@@ -204,30 +215,235 @@ public:
      */
     template<class T>
     void Queue(T&& task) {
-        m_queue.lock();
-        taskqueue.push(std::forward<T>(task));
-        m_queue.unlock();
-        queuecheck.notify_one();
+        std::shared_ptr<TaskRequestBase> queued(std::forward<T>(task));
+        const auto now = Now();
+        SetReadyTime(*queued, now);
+        pool->Push(std::move(queued), current_worker, now);
+        WakeUp();
+    }
+
+    /** \brief Queue the tasks of a range for asynchronous execution
+     *
+     * The tasks are put in the pool at once, and at most one sleeping
+     * thread per task is woken up.
+     *
+     * \param range const Range& the tasks, e.g a std::vector of std::shared_ptr
+     *
+     */
+    template<class Range>
+    void QueueBatch(const Range& range) {
+        std::vector<std::shared_ptr<TaskRequestBase>> tasks;
+        for (const auto& task : range) {
+            tasks.push_back(task);
+        }
+        PushBatch(tasks);
+    }
+
+    /** \brief Queue tasks created by a generator for asynchronous execution
+     *
+     * Like QueueBatch(range), with the tasks generator(0) to generator(count - 1).
+     *
+     * \param count size_t the number of tasks
+     * \param generator Generator&& the function returning the task of an index
+     *
+     */
+    template<class Generator>
+    void QueueBatch(size_t count, Generator&& generator) {
+        std::vector<std::shared_ptr<TaskRequestBase>> tasks;
+        tasks.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tasks.push_back(generator(i));
+        }
+        PushBatch(tasks);
+    }
+
+    /** \brief Run a blocking function in the I/O lane
+     *
+     * The function runs in a thread of the I/O lane, not in the threads
+     * running the frames. An exception thrown by the function is passed to
+     * the future.
+     *
+     * \param fn Function&& the function, e.g loading a file
+     * \return std::future<R> the result of the function
+     *
+     */
+    template<class Function>
+    auto QueueIO(Function&& fn) -> std::future<decltype(fn())> {
+        typedef decltype(fn()) result_t;
+        auto job = std::make_shared<std::packaged_task<result_t(void)>>(std::forward<Function>(fn));
+        auto result = job->get_future();
+        io_lane.Push([job]() { (*job)(); });
+        return result;
+    }
+
+    /** \brief Run a blocking function in the I/O lane, then a callback in the frame threads
+     *
+     * When the function returns, the callback is queued as a background
+     * task and gets the result as a ready std::shared_future<R>.
+     *
+     * \param fn Function&& the function, e.g loading a file
+     * \param callback Callback&& the callback, called as callback(std::shared_future<R>)
+     *
+     */
+    template<class Function, class Callback>
+    void QueueIO(Function&& fn, Callback&& callback) {
+        typedef decltype(fn()) result_t;
+        auto job = std::make_shared<std::packaged_task<result_t(void)>>(std::forward<Function>(fn));
+        std::shared_future<result_t> result = job->get_future().share();
+        std::function<void(std::shared_future<result_t>)> done(std::forward<Callback>(callback));
+        io_lane.Push([this, job, result, done]() {
+            (*job)();
+            std::function<void(void)> completion = std::bind(done, result);
+            auto task = std::make_shared<TaskRequest<std::function<void(void)>>>(std::move(completion));
+            task->SetClass(TaskClass::BACKGROUND_IO);
+            Queue(std::move(task));
+        });
+    }
+
+    /** \brief Call a function on the chunks of a range, using the idle threads
+     *
+     * The range is split in chunks of at least grain elements, and the
+     * function is called as fn(first, last) on each chunk, possibly in
+     * several threads at once. The calling thread takes part and returns
+     * when all the chunks are done. No thread is created: the other threads
+     * help when they are idle.
+     *
+     * \param begin Iterator the beginning of the range, a random access iterator or an integer
+     * \param end Iterator the end of the range
+     * \param grain size_t the minimum number of elements of a chunk
+     * \param fn const Function& the function
+     *
+     */
+    template<class Iterator, class Function>
+    void ParallelFor(Iterator begin, Iterator end, size_t grain, const Function& fn) {
+        auto job = std::make_shared<ParallelForJob<Iterator,Function>>(
+                        begin, end - begin, grain, Participants(), fn);
+        RunParallel(job);
+    }
+
+    /** \brief Reduce the values computed on the chunks of a range, using the idle threads
+     *
+     * Like ParallelFor(), but fn(first, last) returns the value of a chunk.
+     * The values are merged with combine(a, b), that must be associative
+     * and commutative.
+     *
+     * \param begin Iterator the beginning of the range, a random access iterator or an integer
+     * \param end Iterator the end of the range
+     * \param grain size_t the minimum number of elements of a chunk
+     * \param identity const T& the value of an empty range
+     * \param fn const Function& the function computing the value of a chunk
+     * \param combine const Combine& the function merging two values
+     * \return T the value of the range
+     *
+     */
+    template<class Iterator, class T, class Function, class Combine>
+    T ParallelReduce(Iterator begin, Iterator end, size_t grain, const T& identity,
+                     const Function& fn, const Combine& combine) {
+        auto job = std::make_shared<ParallelReduceJob<Iterator,T,Function,Combine>>(
+                        begin, end - begin, grain, Participants(), identity, fn, combine);
+        RunParallel(job);
+        return job->Result();
     }
 
 private:
 
+    /** \brief Queue the tasks, and wake up one sleeping thread per task
+     *
+     * \param tasks std::vector<std::shared_ptr<TaskRequestBase>>& the tasks, moved from
+     *
+     */
+    void PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks);
+
+    /** \brief Set the wall clock time when a task is due, to measure its wait
+     *
+     * \param task TaskRequestBase& the task
+     * \param now const frame_tp& the current time of the scheduler clock
+     *
+     */
+    void SetReadyTime(TaskRequestBase& task, const frame_tp& now) const {
+        const auto delay = now < task.Timepoint() ? clock->RealDuration(task.Timepoint() - now) : frame_unit(0);
+        task.SetReadyTime(SchedulerTelemetry::Now() + delay);
+    }
+
+    /** \brief Share a job with the idle threads and take part in it
+     *
+     * Once no chunk is left to claim, the calling thread blocks until the
+     * chunks running in the other threads are done.
+     *
+     * \param job const std::shared_ptr<ParallelJob>& the job
+     *
+     */
+    void RunParallel(const std::shared_ptr<ParallelJob>& job);
+
+    /** \brief Get the number of threads that can take part in a job
+     *
+     * \return unsigned int the workers, and the calling thread if it is not one of them
+     *
+     */
+    unsigned int Participants() const {
+        const unsigned int workers = nr_worker.load();
+        return current_worker == TaskPool::NO_WORKER ? workers + 1 : workers;
+    }
+
     /** \brief Main loop of each thread
      *
-     * \param now start time
-     * \param system SystemBase* system to attach
+     * \param worker unsigned int index of the thread
+     *
+     */
+    void DayWork(unsigned int worker);
+
+    /** \brief Block the thread until there is something to do
+     *
+     * i.e until a task is queued, the next task is due, or the next frame
+     * can begin.
+     *
+     * \param worker unsigned int index of the thread
      *
      */
-    void DayWork(const frame_tp& now, SystemBase* system);
+    void Sleep(unsigned int worker);
 
-    std::priority_queue<std::shared_ptr<TaskRequestBase>> taskqueue;
-    std::condition_variable countercheck;
-    std::atomic<int> counter;
-    std::mutex m_count;
-    std::mutex m_queue;
-    std::mutex m_timer;
+    /** \brief Wake up one sleeping thread, if any
+     *
+     */
+    void WakeUp();
+
+    /** \brief Wake up several sleeping threads, if any
+     *
+     * \param count size_t the maximum number of threads to wake up
+     *
+     */
+    void WakeUp(size_t count);
+
+    /** \brief Wake up all the sleeping threads
+     *
+     */
+    void WakeUpAll();
+
+    // the index of the worker running on this thread, NO_WORKER for other threads
+    static thread_local unsigned int current_worker;
+
+    ConcurrencyController concurrency;
+    SchedulerTelemetry telemetry;
+    // the wall clock time when the current frame began
+    std::atomic<frame_unit::rep> frame_begin;
+    // the number of frames begun, the workers reset their frame arena when it changes
+    std::atomic<uint64_t> frame_number;
+    // the number of frames between two memory reports, 0 if disabled
+    std::atomic<unsigned int> memory_report_frames;
+    std::atomic<std::ostream*> memory_report_out;
+    std::mutex m_sleep;
     std::condition_variable queuecheck;
-    const frame_unit one_frame;
+    std::atomic<unsigned int> sleepers;
+    frame_unit one_frame;
+    std::atomic<unsigned int> nr_worker;
+    TaskPoolMode pool_mode;
+    std::unique_ptr<TaskPool> pool;
+    std::unique_ptr<Clock> clock;
+    std::unique_ptr<SystemGraph> graph;
+    // tasks of the systems bound to a thread, one queue per thread
+    std::vector<std::unique_ptr<AtomicQueue<std::shared_ptr<TaskRequestBase>>>> bound_tasks;
+    // the threads running the blocking jobs, destroyed first
+    IOLane io_lane;
 };
 }
 
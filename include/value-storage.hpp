@@ -0,0 +1,251 @@
+#ifndef VALUESTORAGE_HPP_INCLUDED
+#define VALUESTORAGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "trillek.hpp"
+
+namespace trillek {
+
+/** \brief The storage of a value of any type, used by Container and Property
+ *
+ * A value of at most INLINE_SIZE bytes that can be moved without throwing
+ * is stored inside the object, the others are allocated on the heap.
+ * The operations depending on the type are reached through a table of
+ * functions shared by all the values of the type, instead of virtual calls.
+ * A trivially copyable value stored inline is copied, moved and destroyed
+ * without calling any function, and the pointer to a value allocated on
+ * the heap is moved the same way.
+ *
+ * Copying a value that is not copy constructible throws std::logic_error.
+ */
+class ValueStorage {
+public:
+    // the largest value stored inline
+    static const std::size_t INLINE_SIZE = 32;
+
+    /** \brief Tell if the values of a type are stored inline
+     */
+    template<typename T>
+    struct IsInline : std::integral_constant<bool,
+            sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<T>::value> { };
+
+    // an empty storage
+    ValueStorage() : ops(nullptr), type_id(0) { }
+
+    /** \brief Store a value
+     *
+     * \param value T the value
+     */
+    template<typename T>
+    explicit ValueStorage(T value) : ops(&Handler<T>::table), type_id(reflection::GetTypeID<T>()) {
+        Handler<T>::Create(*this, std::move(value));
+    }
+
+    ValueStorage(const ValueStorage& that) : ops(nullptr), type_id(0) {
+        CopyFrom(that);
+    }
+
+    ValueStorage(ValueStorage&& that) noexcept : ops(nullptr), type_id(0) {
+        MoveFrom(that);
+    }
+
+    ValueStorage& operator=(const ValueStorage& that) {
+        if (this != &that) {
+            Clear();
+            CopyFrom(that);
+        }
+        return *this;
+    }
+
+    ValueStorage& operator=(ValueStorage&& that) noexcept {
+        if (this != &that) {
+            Clear();
+            MoveFrom(that);
+        }
+        return *this;
+    }
+
+    ~ValueStorage() {
+        Clear();
+    }
+
+    /** \brief Destroy the value
+     */
+    void Clear() {
+        if (this->ops && ! this->ops->trivial) {
+            this->ops->destroy(*this);
+        }
+        this->ops = nullptr;
+        this->type_id = 0;
+    }
+
+    /** \brief Get the value, the type is not checked
+     *
+     * \return T* the value, nullptr if the storage is empty
+     */
+    template<typename T>
+    T* Get() const {
+        if (! this->ops) {
+            return nullptr;
+        }
+        return Handler<T>::Pointer(*this);
+    }
+
+    /** \brief Tell if no value is stored
+     *
+     * \return bool true if empty
+     */
+    bool IsEmpty() const {
+        return this->ops == nullptr;
+    }
+
+    /** \brief Get the type ID of the value
+     *
+     * \return unsigned the ID, 0 if the storage is empty
+     */
+    unsigned GetType() const {
+        return this->type_id;
+    }
+
+    /** \brief Get the size of the value
+     *
+     * \return std::size_t the size, 0 if the storage is empty
+     */
+    std::size_t GetSize() const {
+        return this->ops ? this->ops->size : 0;
+    }
+
+private:
+    typedef void (*CopyFunction)(ValueStorage& to, const ValueStorage& from);
+
+    // the functions handling the values of one type
+    struct Operations {
+        std::size_t size;
+        // stored inline and trivially copyable
+        bool trivial;
+        // stored inline
+        bool local;
+        // sets the operations of the copy
+        CopyFunction copy;
+        void (*move)(ValueStorage& to, ValueStorage& from);
+        void (*destroy)(ValueStorage& storage);
+    };
+
+    template<typename T, bool Local = IsInline<T>::value>
+    struct Handler;
+
+    void CopyFrom(const ValueStorage& that) {
+        if (! that.ops) {
+            return;
+        }
+        if (that.ops->trivial) {
+            std::memcpy(&this->data, &that.data, sizeof(this->data));
+            this->ops = that.ops;
+        }
+        else {
+            that.ops->copy(*this, that);
+        }
+        this->type_id = that.type_id;
+    }
+
+    void MoveFrom(ValueStorage& that) {
+        if (! that.ops) {
+            return;
+        }
+        if (that.ops->trivial || ! that.ops->local) {
+            // the value or the pointer to the value
+            std::memcpy(&this->data, &that.data, sizeof(this->data));
+        }
+        else {
+            that.ops->move(*this, that);
+            that.ops->destroy(that);
+        }
+        this->ops = that.ops;
+        this->type_id = that.type_id;
+        that.ops = nullptr;
+        that.type_id = 0;
+    }
+
+    union Data {
+        typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type buffer;
+        void* pointer;
+    } data;
+    const Operations* ops;
+    // kept out of the operations to be read without a call
+    unsigned type_id;
+};
+
+// a value stored inline
+template<typename T>
+struct ValueStorage::Handler<T, true> {
+    static void Create(ValueStorage& storage, T&& value) {
+        new (&storage.data.buffer) T(std::move(value));
+    }
+    static T* Pointer(const ValueStorage& storage) {
+        return reinterpret_cast<T*>(const_cast<Data*>(&storage.data));
+    }
+    static void Copy(ValueStorage& to, const ValueStorage& from) {
+        Copy(to, from, std::is_copy_constructible<T>());
+    }
+    static void Copy(ValueStorage& to, const ValueStorage& from, std::true_type) {
+        new (&to.data.buffer) T(*Pointer(from));
+        to.ops = &table;
+    }
+    static void Copy(ValueStorage&, const ValueStorage&, std::false_type) {
+        throw std::logic_error("ValueStorage: the value can not be copied");
+    }
+    static void Move(ValueStorage& to, ValueStorage& from) {
+        new (&to.data.buffer) T(std::move(*Pointer(from)));
+    }
+    static void Destroy(ValueStorage& storage) {
+        Pointer(storage)->~T();
+    }
+
+    static const Operations table;
+};
+
+// a value allocated on the heap
+template<typename T>
+struct ValueStorage::Handler<T, false> {
+    static void Create(ValueStorage& storage, T&& value) {
+        storage.data.pointer = new T(std::move(value));
+    }
+    static T* Pointer(const ValueStorage& storage) {
+        return static_cast<T*>(storage.data.pointer);
+    }
+    static void Copy(ValueStorage& to, const ValueStorage& from) {
+        Copy(to, from, std::is_copy_constructible<T>());
+    }
+    static void Copy(ValueStorage& to, const ValueStorage& from, std::true_type) {
+        to.data.pointer = new T(*Pointer(from));
+        to.ops = &table;
+    }
+    static void Copy(ValueStorage&, const ValueStorage&, std::false_type) {
+        throw std::logic_error("ValueStorage: the value can not be copied");
+    }
+    static void Destroy(ValueStorage& storage) {
+        delete Pointer(storage);
+    }
+
+    static const Operations table;
+};
+
+template<typename T>
+const ValueStorage::Operations ValueStorage::Handler<T, true>::table = {
+    sizeof(T), std::is_trivially_copyable<T>::value, true, static_cast<CopyFunction>(&Copy), &Move, &Destroy
+};
+
+template<typename T>
+const ValueStorage::Operations ValueStorage::Handler<T, false>::table = {
+    sizeof(T), false, false, static_cast<CopyFunction>(&Copy), nullptr, &Destroy
+};
+
+} // End of trillek
+
+#endif // VALUESTORAGE_HPP_INCLUDED
@@ -10,8 +10,6 @@
 #include "systems/sound-system.hpp"
 #include <cstddef>
 
-size_t gAllocatedSize = 0;
-
 int main(int argCount, char **argValues) {
     // create the window
     auto& os = trillek::TrillekGame::GetOS();
@@ -50,8 +48,11 @@ int main(int argCount, char **argValues) {
     // register the fake system. Comment this to cancel
 //    systems.push(&trillek::TrillekGame::GetFakeSystem());
 
-    // register the engine system, i.e graphics + physics
-    systems.push(&trillek::TrillekGame::GetEngineSystem());
+    // register the physics system first: it writes the transforms read by the others
+    systems.push(&trillek::TrillekGame::GetPhysicsSystem());
+
+    // register the graphic system
+    systems.push(&trillek::TrillekGame::GetGraphicSystem());
 
     // register the sound system
     systems.push(&trillek::TrillekGame::GetSoundSystem());
@@ -68,6 +69,9 @@ int main(int argCount, char **argValues) {
     // Detach the window from the current thread
     os.DetachContext();
 
+    // each thread has its own task queue and steals from the others when idle
+    trillek::TrillekGame::GetScheduler().SetTaskPoolMode(trillek::TaskPoolMode::WORK_STEALING);
+
     // start the scheduler in another thread
     std::thread tp(
                    &trillek::TrillekScheduler::Initialize,
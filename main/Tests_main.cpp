@@ -2,14 +2,40 @@
 
 #include "tests/PropertyTest.h"
 #include "tests/AtomicQueueTest.h"
+#include "tests/AtomicRingQueueTest.h"
 #include "tests/AtomicMapTest.h"
+#include "tests/AtomicHashMapTest.h"
 #include "tests/ResourceSystemTest.h"
 #include "tests/UtilityTest.h"
 #include "tests/DecompressorTest.h"
 #include "tests/ImageLoaderTest.h"
 #include "tests/transform-system-test.h"
-
-size_t gAllocatedSize = 0;
+#include "tests/TaskPoolTest.h"
+#include "tests/TimerWheelTest.h"
+#include "tests/SystemGraphTest.h"
+#include "tests/ChainTaskTest.h"
+#include "tests/ParallelJobTest.h"
+#include "tests/ConcurrencyControllerTest.h"
+#include "tests/ClockTest.h"
+#include "tests/IOLaneTest.h"
+#include "tests/SchedulerTelemetryTest.h"
+#include "tests/AsyncDataTest.h"
+#include "tests/DispatcherTest.h"
+#include "tests/FrameAllocatorTest.h"
+#include "tests/PoolAllocatorTest.h"
+#include "tests/MemoryAccountingTest.h"
+#include "tests/AllocationTracerTest.h"
+#include "tests/SymbolTest.h"
+// The benchmarks are disabled, run them with
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+#include "tests/SchedulerBenchmark.h"
+#include "tests/AtomicQueueBenchmark.h"
+#include "tests/AtomicMapBenchmark.h"
+#include "tests/DispatcherBenchmark.h"
+#include "tests/FrameAllocatorBenchmark.h"
+#include "tests/PoolAllocatorBenchmark.h"
+#include "tests/PropertyBenchmark.h"
+#include "tests/SymbolBenchmark.h"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
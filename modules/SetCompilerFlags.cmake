@@ -1,11 +1,13 @@
 # check for gcc version to set c++11 or c++0x.
 # thanks to http://stackoverflow.com/questions/10984442/how-to-detect-c11-support-of-a-compiler-with-cmake .
 IF ("${CMAKE_CXX_COMPILER_ID}" MATCHES "GNU")
-  execute_process(COMMAND ${CMAKE_CXX_COMPILER} -dumpversion OUTPUT_VARIABLE GCC_VERSION)
-  IF (GCC_VERSION VERSION_GREATER 4.7 OR GCC_VERSION VERSION_EQUAL 4.7)
-    MESSAGE("Supported GCC!")
-    SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++11")
-  ENDIF (GCC_VERSION VERSION_GREATER 4.7 OR GCC_VERSION VERSION_EQUAL 4.7)
+  execute_process(COMMAND ${CMAKE_CXX_COMPILER} -dumpversion OUTPUT_VARIABLE GCC_VERSION OUTPUT_STRIP_TRAILING_WHITESPACE)
+  # GCC 5 is the first release with std::is_trivially_copyable and std::max_align_t
+  IF (GCC_VERSION VERSION_LESS 5.0)
+    MESSAGE(FATAL_ERROR "GCC ${GCC_VERSION} is not supported, GCC 5 or newer is required.")
+  ENDIF (GCC_VERSION VERSION_LESS 5.0)
+  MESSAGE("Supported GCC!")
+  SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -std=c++11")
 ELSEIF ("${CMAKE_CXX_COMPILER_ID}" MATCHES "Clang") # Clang 3.3 and up support c++11.
   MESSAGE("Clang Version: " ${CMAKE_CXX_COMPILER_VERSION})
   # On OS X, Clang 3.3 would be Clang/LLVM 5.0.
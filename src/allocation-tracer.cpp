@@ -0,0 +1,257 @@
+#include "allocation-tracer.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(__GNUC__) && ! defined(_WIN32)
+#include <execinfo.h>
+#define TRILLEK_HAS_BACKTRACE
+#endif
+
+namespace trillek {
+
+const unsigned int AllocationTracer::DEPTH;
+const unsigned int AllocationTracer::MAX_SITES;
+std::atomic<bool> AllocationTracer::enabled(false);
+std::atomic<uint64_t> AllocationTracer::frames(0);
+
+namespace {
+// the state is constant-initialized: operator new can be called before the static constructors
+AllocationTracer::Site sites[AllocationTracer::MAX_SITES];
+uint64_t site_hashes[AllocationTracer::MAX_SITES];
+// the samples that did not find room in the table
+uint64_t lost_count = 0;
+uint64_t lost_bytes = 0;
+std::mutex m_sites;
+std::atomic<uint64_t> total_count(0);
+std::atomic<uint64_t> total_bytes(0);
+std::atomic<unsigned int> sampling_period(1);
+
+// set while the tracer runs on this thread: its own allocations are not traced
+thread_local bool in_tracer = false;
+// the allocations to skip before the next sample
+thread_local unsigned int countdown = 0;
+
+struct Guard {
+    Guard() {
+        in_tracer = true;
+    }
+    ~Guard() {
+        in_tracer = false;
+    }
+};
+
+uint64_t Hash(void* const* frames, unsigned int depth) {
+    // FNV-1a on the addresses, never 0 which marks the empty slots
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned int i = 0; i < depth; ++i) {
+        h = (h ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+    return h ? h : 1;
+}
+
+void ReportAtExit() {
+    const char* path = std::getenv("TRILLEK_ALLOCATION_TRACE_FILE");
+    std::FILE* file = path ? std::fopen(path, "w") : nullptr;
+    AllocationTracer::Report(file ? file : stderr);
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+// Read the environment before main()
+struct Initializer {
+    Initializer() {
+        const char* value = std::getenv("TRILLEK_ALLOCATION_TRACE");
+#ifdef TRILLEK_ALLOCATION_TRACING
+        // on by default, the variable can change the period or disable it with 0
+        const int period = value ? std::atoi(value) : 1;
+#else
+        const int period = value ? std::atoi(value) : 0;
+#endif
+        if (period > 0) {
+            AllocationTracer::Enable(period);
+            std::atexit(ReportAtExit);
+        }
+    }
+} initializer;
+}
+
+void AllocationTracer::Enable(unsigned int period) {
+    sampling_period.store(std::max(period, 1u));
+    enabled.store(true);
+}
+
+void AllocationTracer::Disable() {
+    enabled.store(false);
+}
+
+void AllocationTracer::Sample(size_t size) {
+    if (in_tracer) {
+        return;
+    }
+    Guard guard;
+    total_count.fetch_add(1, std::memory_order_relaxed);
+    total_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (countdown) {
+        --countdown;
+        return;
+    }
+    const unsigned int period = sampling_period.load(std::memory_order_relaxed);
+    countdown = period - 1;
+
+    // skip this function and the allocation hook
+    const unsigned int SKIP = 2;
+    void* stack[DEPTH + SKIP];
+    unsigned int depth = 0;
+#ifdef TRILLEK_HAS_BACKTRACE
+    const int n = backtrace(stack, DEPTH + SKIP);
+    depth = n > static_cast<int>(SKIP) ? n - SKIP : 0;
+#endif
+    const uint64_t hash = Hash(stack + SKIP, depth);
+
+    std::lock_guard<std::mutex> locker(m_sites);
+    for (unsigned int i = 0; i < MAX_SITES; ++i) {
+        const unsigned int slot = (hash + i) & (MAX_SITES - 1);
+        Site& site = sites[slot];
+        if (! site_hashes[slot]) {
+            site_hashes[slot] = hash;
+            std::memcpy(site.frames, stack + SKIP, depth * sizeof(void*));
+            site.depth = depth;
+        }
+        else if (site_hashes[slot] != hash || site.depth != depth
+                 || std::memcmp(site.frames, stack + SKIP, depth * sizeof(void*))) {
+            continue;
+        }
+        site.count += period;
+        site.bytes += static_cast<uint64_t>(size) * period;
+        return;
+    }
+    lost_count += period;
+    lost_bytes += static_cast<uint64_t>(size) * period;
+}
+
+std::vector<AllocationTracer::Site> AllocationTracer::Sites(size_t max_sites) {
+    Guard guard;
+    std::vector<Site> result;
+    {
+        std::lock_guard<std::mutex> locker(m_sites);
+        for (unsigned int i = 0; i < MAX_SITES; ++i) {
+            if (site_hashes[i]) {
+                result.push_back(sites[i]);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Site& a, const Site& b) {
+        return a.bytes > b.bytes;
+    });
+    if (result.size() > max_sites) {
+        result.resize(max_sites);
+    }
+    return result;
+}
+
+void AllocationTracer::Clear() {
+    std::lock_guard<std::mutex> locker(m_sites);
+    std::memset(sites, 0, sizeof(sites));
+    std::memset(site_hashes, 0, sizeof(site_hashes));
+    lost_count = 0;
+    lost_bytes = 0;
+    total_count.store(0);
+    total_bytes.store(0);
+    frames.store(0);
+}
+
+void AllocationTracer::Report(std::FILE* out, size_t max_sites) {
+    const auto top = Sites(max_sites);
+    Guard guard;
+    const uint64_t nr_frame = std::max<uint64_t>(frames.load(), 1);
+    std::fprintf(out, "allocation trace: %llu allocations, %llu bytes, %llu frames, sampling period %u\n",
+                 static_cast<unsigned long long>(total_count.load()),
+                 static_cast<unsigned long long>(total_bytes.load()),
+                 static_cast<unsigned long long>(frames.load()), sampling_period.load());
+    {
+        std::lock_guard<std::mutex> locker(m_sites);
+        if (lost_count) {
+            std::fprintf(out, "not recorded (too many sites): %llu allocations, %llu bytes\n",
+                         static_cast<unsigned long long>(lost_count), static_cast<unsigned long long>(lost_bytes));
+        }
+    }
+    for (size_t i = 0; i < top.size(); ++i) {
+        const Site& site = top[i];
+        std::fprintf(out, "#%u: %llu allocations (%.1f per frame), %llu bytes (%.1f per frame)\n",
+                     static_cast<unsigned int>(i + 1), static_cast<unsigned long long>(site.count),
+                     static_cast<double>(site.count) / nr_frame, static_cast<unsigned long long>(site.bytes),
+                     static_cast<double>(site.bytes) / nr_frame);
+#ifdef TRILLEK_HAS_BACKTRACE
+        char** symbols = backtrace_symbols(site.frames, site.depth);
+        for (unsigned int f = 0; f < site.depth; ++f) {
+            std::fprintf(out, "    %s\n", symbols ? symbols[f] : "?");
+        }
+        std::free(symbols);
+#endif
+    }
+    std::fflush(out);
+}
+
+} // End of trillek
+
+// Trace the global operator new, when tracing is enabled. The memory comes
+// from malloc, the operator delete must be replaced too.
+namespace {
+void* TracedNew(std::size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (! p) {
+        throw std::bad_alloc();
+    }
+    trillek::AllocationTracer::Record(size);
+    return p;
+}
+}
+
+void* operator new(std::size_t size) {
+    return TracedNew(size);
+}
+
+void* operator new[](std::size_t size) {
+    return TracedNew(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    void* p = std::malloc(size ? size : 1);
+    if (p) {
+        trillek::AllocationTracer::Record(size);
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+// the sized versions, called by the code built for C++14 and later
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,68 @@
+#include "frame-allocator.hpp"
+#include <algorithm>
+#include "memory-accounting.hpp"
+
+namespace trillek {
+
+const size_t FrameArena::BLOCK_SIZE;
+
+FrameArena::FrameArena(size_t block_size) : block_size(std::max<size_t>(block_size, 64)),
+    current(0), offset(0), used(0), peak(0), capacity(0), block_allocations(0), managed(false) { }
+
+FrameArena::~FrameArena() {
+    Release();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    // look for room in the block in use, then in the blocks kept from the previous frames
+    for (; this->current < this->blocks.size(); ++this->current, this->offset = 0) {
+        const Block& block = this->blocks[this->current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const uintptr_t start = (base + this->offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (start + size <= base + block.size) {
+            this->offset = start + size - base;
+            this->used += size;
+            return reinterpret_cast<void*>(start);
+        }
+    }
+    // a new block, after the ones in use
+    const size_t new_size = std::max(this->block_size, size + alignment);
+    char* data = static_cast<char*>(::malloc(new_size));
+    if (! data) {
+        throw std::bad_alloc();
+    }
+    MemoryAccounting::Allocate(MemoryTag::SCHEDULER, new_size);
+    this->blocks.push_back(Block{data, new_size});
+    this->capacity += new_size;
+    ++this->block_allocations;
+    this->current = this->blocks.size() - 1;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(data);
+    const uintptr_t start = (base + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    this->offset = start + size - base;
+    this->used += size;
+    return reinterpret_cast<void*>(start);
+}
+
+void FrameArena::Reset() {
+    this->peak = Peak();
+    this->used = 0;
+    this->current = 0;
+    this->offset = 0;
+}
+
+void FrameArena::Release() {
+    Reset();
+    for (auto& block : this->blocks) {
+        ::free(block.data);
+        MemoryAccounting::Deallocate(MemoryTag::SCHEDULER, block.size);
+    }
+    this->blocks.clear();
+    this->capacity = 0;
+}
+
+FrameArena& FrameArena::Local() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+} // End of trillek
@@ -13,10 +13,10 @@ bool LightBase::Initialize(const std::vector<Property> &properties) {
     float radius = 200.0f;
 
     for(auto vec_itr = properties.begin(); vec_itr != properties.end(); vec_itr++) {
-        if(vec_itr->GetName() == "enabled") {
+        if(vec_itr->GetSymbol() == "enabled"_sym) {
             this->enabled = vec_itr->Get<bool>();
         }
-        else if(vec_itr->GetName() == "radius") {
+        else if(vec_itr->GetSymbol() == "radius"_sym) {
             if(vec_itr->Is<double>()) {
                 radius = vec_itr->Get<double>();
             }
@@ -30,15 +30,16 @@ bool LightBase::Initialize(const std::vector<Property> &properties) {
                 radius = vec_itr->Get<float>();
             }
         }
-        else if(vec_itr->GetName() == "color" && vec_itr->Is<glm::vec3>()) {
+        else if(vec_itr->GetSymbol() == "color"_sym && vec_itr->Is<glm::vec3>()) {
             color = vec_itr->Get<glm::vec3>();
         }
-        else if(vec_itr->GetName() == "shadow" && vec_itr->Is<std::string>()) {
-            light_props.push_back(Property("shadow", vec_itr->Get<std::string>()));
+        else if(vec_itr->GetSymbol() == "shadow"_sym && vec_itr->Is<std::string>()) {
+            // interned once, the shadow layer is looked up at each frame
+            light_props.push_back(Property("shadow"_sym, Symbol(vec_itr->Get<std::string>())));
             shadows = true;
         }
     }
-    light_props.push_back(Property("radius", radius));
+    light_props.push_back(Property("radius"_sym, radius));
 
     return true;
 }
@@ -73,20 +73,20 @@ RenderAttachment& RenderAttachment::operator=(RenderAttachment &&that) {
 bool RenderAttachment::SystemStart(const std::list<Property> &settings) {
     int samples;
     for(auto prop : settings) {
-        if(prop.GetName() == "screen-width") {
+        if(prop.GetSymbol() == "screen-width"_sym) {
             if(!customsize) {
                 width = prop.Get<int>();
             }
         }
-        else if(prop.GetName() == "screen-height") {
+        else if(prop.GetSymbol() == "screen-height"_sym) {
             if(!customsize) {
                 height = prop.Get<int>();
             }
         }
-        else if(prop.GetName() == "multisample") {
+        else if(prop.GetSymbol() == "multisample"_sym) {
             this->multisample = this->multisample || prop.Get<bool>();
         }
-        else if(prop.GetName() == "samples") {
+        else if(prop.GetSymbol() == "samples"_sym) {
             samples = prop.Get<int>();
         }
     }
@@ -97,20 +97,20 @@ bool RenderAttachment::SystemStart(const std::list<Property> &settings) {
 bool RenderAttachment::SystemReset(const std::list<Property> &settings) {
     int samples;
     for(auto prop : settings) {
-        if(prop.GetName() == "screen-width") {
+        if(prop.GetSymbol() == "screen-width"_sym) {
             if(!customsize) {
                 width = prop.Get<int>();
             }
         }
-        else if(prop.GetName() == "screen-height") {
+        else if(prop.GetSymbol() == "screen-height"_sym) {
             if(!customsize) {
                 height = prop.Get<int>();
             }
         }
-        else if(prop.GetName() == "multisample") {
+        else if(prop.GetSymbol() == "multisample"_sym) {
             this->multisample = this->multisample || prop.Get<bool>();
         }
-        else if(prop.GetName() == "samples") {
+        else if(prop.GetSymbol() == "samples"_sym) {
             samples = prop.Get<int>();
         }
     }
@@ -300,13 +300,13 @@ void RenderAttachment::Generate(int width, int height, int samplecount) {
         if(texture->GetID()) return;
     }
     else {
-        auto texptr = TrillekGame::GetGraphicSystem().Get<Texture>(texturename);
+        auto texptr = TrillekGame::GetGraphicSystem().Get<Texture>(Symbol(texturename));
         if(texptr) {
             texture = std::move(texptr);
         }
         else {
             texture.reset(new Texture());
-            TrillekGame::GetGraphicSystem().Add(texturename, texture);
+            TrillekGame::GetGraphicSystem().Add(Symbol(texturename), texture);
         }
     }
     texture->SetCompare(this->shadowcompare);
@@ -457,17 +457,17 @@ static const char * GetFramebufferStatusMessage(GLuint status) {
 bool RenderLayer::SystemStart(const std::list<Property> &settings) {
     for(auto prop : settings) {
         if(!customsize) {
-            if(prop.GetName() == "screen-width") {
+            if(prop.GetSymbol() == "screen-width"_sym) {
                 width = prop.Get<int>();
             }
-            else if(prop.GetName() == "screen-height") {
+            else if(prop.GetSymbol() == "screen-height"_sym) {
                 height = prop.Get<int>();
             }
         }
     }
     this->attachments.clear();
     for(auto attachname : this->attachmentnames) {
-        auto attachptr = TrillekGame::GetGraphicSystem().Get<RenderAttachment>(attachname);
+        auto attachptr = TrillekGame::GetGraphicSystem().Get<RenderAttachment>(Symbol(attachname));
         if(attachptr) {
             this->attachments.push_back(attachptr);
         }
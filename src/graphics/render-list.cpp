@@ -74,22 +74,22 @@ bool RenderList::Parse(const std::string &object_name, const rapidjson::Value& n
                 else {
                     if(rloitem->value.IsString()) {
                         rprops.push_back(Property(
-                            rli_name,
+                            Symbol(rli_name),
                             std::string(rloitem->value.GetString(),
                                         rloitem->value.GetStringLength())
                         ));
                     }
                     else if(rloitem->value.IsBool()) {
-                        rprops.push_back(Property(rli_name, rloitem->value.GetBool()));
+                        rprops.push_back(Property(Symbol(rli_name), rloitem->value.GetBool()));
                     }
                     else if(rloitem->value.IsNull()) {
-                        rprops.push_back(Property(rli_name, 0u));
+                        rprops.push_back(Property(Symbol(rli_name), 0u));
                     }
                     else if(rloitem->value.IsUint()) {
-                        rprops.push_back(Property(rli_name, rloitem->value.GetUint()));
+                        rprops.push_back(Property(Symbol(rli_name), rloitem->value.GetUint()));
                     }
                     else if(rloitem->value.IsDouble()) {
-                        rprops.push_back(Property(rli_name, rloitem->value.GetDouble()));
+                        rprops.push_back(Property(Symbol(rli_name), rloitem->value.GetDouble()));
                     }
                 }
             }
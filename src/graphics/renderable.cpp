@@ -47,10 +47,10 @@ void Renderable::UpdateBufferGroups() {
 
         // TODO: Loop through all the texture names in the mesh group and add the textures to the material.
         for (std::string texture_name : temp_meshgroup->textures) {
-            std::shared_ptr<Texture> texture = TrillekGame::GetGraphicSystem().Get<Texture>(texture_name);
+            std::shared_ptr<Texture> texture = TrillekGame::GetGraphicSystem().Get<Texture>(Symbol(texture_name));
             if (!texture) {
                 std::vector<Property> props;
-                props.push_back(Property("filename", texture_name));
+                props.push_back(Property("filename"_sym, texture_name));
                 std::stringstream name;
                 if (this->dyn_textures) {
                     name << this->entity_id << "_" << texture_name;
@@ -59,7 +59,7 @@ void Renderable::UpdateBufferGroups() {
                     name << texture_name;
                 }
 
-                auto pixel_data = resource::ResourceMap::Create<resource::PixelBuffer>(name.str(), props);
+                auto pixel_data = resource::ResourceMap::Create<resource::PixelBuffer>(Symbol(name.str()), props);
                 if (pixel_data) {
                     if (this->dyn_textures) {
                         texture = std::make_shared<Texture>(pixel_data);
@@ -67,7 +67,7 @@ void Renderable::UpdateBufferGroups() {
                     else {
                         texture = std::make_shared<Texture>(*pixel_data.get());
                     }
-                    TrillekGame::GetGraphicSystem().Add(name.str(), texture);
+                    TrillekGame::GetGraphicSystem().Add(Symbol(name.str()), texture);
                 }
             }
 
@@ -166,35 +166,35 @@ bool Renderable::Initialize(const std::vector<Property> &properties) {
     std::string animation_name;
     this->dyn_textures = true;
     for (const Property& p : properties) {
-        std::string name = p.GetName();
-        if (name == "mesh") {
+        Symbol name = p.GetSymbol();
+        if (name == "mesh"_sym) {
             mesh_name = p.Get<std::string>();
         }
-        else if (name == "shader") {
+        else if (name == "shader"_sym) {
             shader_name = p.Get<std::string>();
         }
-        else if (name == "animation") {
+        else if (name == "animation"_sym) {
             animation_name = p.Get<std::string>();
         }
-        else if (name == "dynamic_textures") {
+        else if (name == "dynamic_textures"_sym) {
             this->dyn_textures = p.Get<bool>();
         }
-        else if (name == "entity_id") {
+        else if (name == "entity_id"_sym) {
             this->entity_id = p.Get<unsigned int>();
         }
     }
 
-    this->mesh = resource::ResourceMap::Get<resource::Mesh>(mesh_name);
+    this->mesh = resource::ResourceMap::Get<resource::Mesh>(Symbol(mesh_name));
     if (!this->mesh) {
         return false;
     }
 
-    this->shader = TrillekGame::GetGraphicSystem().Get<graphics::Shader>(shader_name);
+    this->shader = TrillekGame::GetGraphicSystem().Get<graphics::Shader>(Symbol(shader_name));
     if (!this->shader) {
         return false;
     }
 
-    auto animation_file = resource::ResourceMap::Get<resource::MD5Anim>(animation_name);
+    auto animation_file = resource::ResourceMap::Get<resource::MD5Anim>(Symbol(animation_name));
     if (animation_file) {
         // Make sure the mesh is valid for the animation file.
         if (animation_file->CheckMesh(this->mesh)) {
@@ -120,10 +120,10 @@ void Shader::UnUse() {
     glUseProgram(0);
 }
 
-GLint Shader::Attribute(const std::string & attribute) {
+GLint Shader::Attribute(Symbol attribute) {
     auto attrib = attributes_list.find(attribute);
     if(attrib == attributes_list.end()) {
-        GLint attrib_id = glGetAttribLocation(program, attribute.c_str());
+        GLint attrib_id = glGetAttribLocation(program, attribute.GetName());
         if(attrib_id) {
             attributes_list[attribute] = attrib_id;
         }
@@ -132,10 +132,10 @@ GLint Shader::Attribute(const std::string & attribute) {
     return attrib->second;
 }
 
-GLint Shader::Uniform(const std::string & uniform) {
+GLint Shader::Uniform(Symbol uniform) {
     auto uniform_itr = uniforms_list.find(uniform);
     if(uniform_itr == uniforms_list.end()) {
-        GLint uniform_id = glGetUniformLocation(program, uniform.c_str());
+        GLint uniform_id = glGetUniformLocation(program, uniform.GetName());
         if(uniform_id) {
             uniforms_list[uniform] = uniform_id;
         }
@@ -145,28 +145,12 @@ GLint Shader::Uniform(const std::string & uniform) {
 }
 
 //An indexer that returns the location of the attribute
-GLint Shader::operator [](const std::string & attribute) {
-    auto attrib = attributes_list.find(attribute);
-    if(attrib == attributes_list.end()) {
-        GLint attrib_id = glGetAttribLocation(program, attribute.c_str());
-        if(attrib_id) {
-            attributes_list[attribute] = attrib_id;
-        }
-        return attrib_id;
-    }
-    return attrib->second;
+GLint Shader::operator [](Symbol attribute) {
+    return Attribute(attribute);
 }
 
-GLint Shader::operator()(const std::string &uniform) {
-    auto uniform_itr = uniforms_list.find(uniform);
-    if(uniform_itr == uniforms_list.end()) {
-        GLint uniform_id = glGetUniformLocation(program, uniform.c_str());
-        if(uniform_id) {
-            uniforms_list[uniform] = uniform_id;
-        }
-        return uniform_id;
-    }
-    return uniform_itr->second;
+GLint Shader::operator()(Symbol uniform) {
+    return Uniform(uniform);
 }
 GLuint Shader::GetProgram() {
     return program;
@@ -210,7 +194,7 @@ bool Shader::Parse(const std::string &shader_name, const rapidjson::Value& node)
 
             auto param_scan = Shader::shaderclass.find(param_name);
             if(param_scan != Shader::shaderclass.end()) {
-                auto textdata = resource::ResourceMap::Get<resource::TextFile>(param_val);
+                auto textdata = resource::ResourceMap::Get<resource::TextFile>(Symbol(param_val));
                 if(textdata) {
                     std::vector<std::string> shadersrc;
                     shadersrc.push_back(globdefines);
@@ -241,7 +225,7 @@ bool Shader::Parse(const std::string &shader_name, const rapidjson::Value& node)
                     else if(ssec_name == "src" || ssec_name == "source") {
                         if(sdef_itr->value.IsString()) {
                             std::string ssec_val(sdef_itr->value.GetString(), sdef_itr->value.GetStringLength());
-                            auto textdata = resource::ResourceMap::Get<resource::TextFile>(ssec_val);
+                            auto textdata = resource::ResourceMap::Get<resource::TextFile>(Symbol(ssec_val));
                             if(textdata) {
                                 shadertext = textdata->GetText();
                             }
@@ -257,7 +241,7 @@ bool Shader::Parse(const std::string &shader_name, const rapidjson::Value& node)
                         if(sdef_itr->value.IsString()) {
                             std::string ssec_val(sdef_itr->value.GetString(), sdef_itr->value.GetStringLength());
                             std::vector<Property> fileprop;
-                            fileprop.push_back(Property("filename", ssec_val));
+                            fileprop.push_back(Property("filename"_sym, ssec_val));
                             resource::TextFile textdata;
                             if(textdata.Initialize(fileprop)) {
                                 shadertext = textdata.GetText();
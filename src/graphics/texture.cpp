@@ -79,7 +79,7 @@ void Texture::Load(const resource::PixelBuffer & image) {
     }
     GLint magfilter = GL_LINEAR;
     for(auto &metaprop : image.meta) {
-        if(metaprop.GetName() == "mag-filter") {
+        if(metaprop.GetSymbol() == "mag-filter"_sym) {
             if(metaprop.Is<std::string>()) {
                 std::string filtermode = metaprop.Get<std::string>();
                 if(filtermode == "nearest") {
@@ -936,11 +936,11 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
                 }
                 switch(header.interlace) {
                 case 0:
-                    pix.meta.push_back(Property("interlace", false));
+                    pix.meta.push_back(Property("interlace"_sym, false));
                     interlace = std::unique_ptr<InterlaceType>(new InterlaceType(filtermethod, header));
                     break;
                 case 1:
-                    pix.meta.push_back(Property("interlace", true));
+                    pix.meta.push_back(Property("interlace"_sym, true));
                     interlace = std::unique_ptr<InterlaceType>(new InterlaceTypeAdam7(filtermethod, header));
                     break;
                 default:
@@ -985,7 +985,7 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
                 return void_er(-1, "Multiple gAMA chunk");
             }
             chunk >> gama;
-            pix.meta.push_back(Property("gama", (uint32_t)gama));
+            pix.meta.push_back(Property("gama"_sym, (uint32_t)gama));
 #ifdef PNG_DEBUG_OUTPUT
             std::cerr << "Gama: " << gama << '\n';
 #endif
@@ -999,7 +999,7 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
 
             chunk >> mtime.year >> mtime.month >> mtime.day;
             chunk >> mtime.hour >> mtime.minute >> mtime.second;
-            pix.meta.push_back(Property("modified", mtime));
+            pix.meta.push_back(Property("modified"_sym, mtime));
 #ifdef PNG_DEBUG_OUTPUT
             // XXX: debug info
             std::fprintf(stderr, "Modification: %d:%d:%d %dD %dM %dY\n"
@@ -1014,7 +1014,7 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
 
             background.type = header.colortype;
             chunk >> background;
-            pix.meta.push_back(Property("background", background));
+            pix.meta.push_back(Property("background"_sym, background));
 #ifdef PNG_DEBUG_OUTPUT
             // XXX: debug info
             if(background.type == 0 || background.type == 4) {
@@ -1037,8 +1037,8 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
             PNGLong pix_x, pix_y;
             uint8_t unit;
             chunk >> pix_x >> pix_y >> unit;
-            pix.meta.push_back(Property("scale-x", (uint32_t)pix_x));
-            pix.meta.push_back(Property("scale-y", (uint32_t)pix_y));
+            pix.meta.push_back(Property("scale-x"_sym, (uint32_t)pix_x));
+            pix.meta.push_back(Property("scale-y"_sym, (uint32_t)pix_y));
 #ifdef PNG_DEBUG_OUTPUT
             // XXX: debug info
             std::fprintf(stderr, "Pixelsize: %d x %d ", pix_x, pix_y);
@@ -1091,7 +1091,7 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
                 textdata.append((char*)&c, 1);
             }
             // TODO: something with the text, log it maybe
-            pix.meta.push_back(Property(keyword, textdata));
+            pix.meta.push_back(Property(Symbol(keyword), textdata));
 #ifdef PNG_DEBUG_OUTPUT
             std::cerr << "Keyword: \"" << keyword << "\" = \"" << textdata << "\"\n";
 #endif
@@ -1135,7 +1135,7 @@ util::void_er Load(util::InputStream & f, resource::PixelBuffer & pix) {
             // TODO: something with the text, log it maybe
 
             std::string stringdata((const char*)textdata.data(), textdata.length());
-            pix.meta.push_back(Property(keyword, stringdata));
+            pix.meta.push_back(Property(Symbol(keyword), stringdata));
 #ifdef PNG_DEBUG_OUTPUT
             std::cerr << "zKeyword: \"" << keyword << "\" = \"";
             std::cerr.write((const char*)textdata.data(), textdata.length());
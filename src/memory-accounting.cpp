@@ -0,0 +1,201 @@
+#include "memory-accounting.hpp"
+#include <algorithm>
+#include "allocation-tracer.hpp"
+#include <mutex>
+#include <vector>
+
+namespace trillek {
+
+const int64_t MemoryAccounting::FLUSH_SIZE;
+
+namespace {
+const unsigned int NR_TAG = static_cast<unsigned int>(MemoryTag::COUNT);
+
+struct Counters {
+    Counters() {
+        for (unsigned int i = 0; i < NR_TAG; ++i) {
+            bytes[i].store(0, std::memory_order_relaxed);
+            allocations[i].store(0, std::memory_order_relaxed);
+            deallocations[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<int64_t> bytes[NR_TAG];
+    std::atomic<uint64_t> allocations[NR_TAG];
+    std::atomic<uint64_t> deallocations[NR_TAG];
+};
+
+// the counters of the threads, never destroyed: memory can be freed after the end of main()
+struct Registry {
+    Registry() {
+        for (unsigned int i = 0; i < NR_TAG; ++i) {
+            flushed[i].store(0, std::memory_order_relaxed);
+            peak[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void UpdatePeak(unsigned int tag, int64_t value) {
+        int64_t p = peak[tag].load(std::memory_order_relaxed);
+        while (value > p && ! peak[tag].compare_exchange_weak(p, value, std::memory_order_relaxed)) { }
+    }
+
+    std::mutex m_threads;
+    std::vector<Counters*> threads;
+    // the counters of the threads that have ended, and of the memory counted during their exit
+    Counters ended;
+    // the bytes added by the threads when they reach FLUSH_SIZE
+    std::atomic<int64_t> flushed[NR_TAG];
+    std::atomic<int64_t> peak[NR_TAG];
+};
+
+Registry& GetRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+// the counters of a thread and its bytes not flushed yet
+struct ThreadCounters {
+    ThreadCounters() {
+        for (unsigned int i = 0; i < NR_TAG; ++i) {
+            unflushed[i] = 0;
+        }
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> locker(registry.m_threads);
+        registry.threads.push_back(&counters);
+    }
+
+    ~ThreadCounters();
+
+    Counters counters;
+    int64_t unflushed[NR_TAG];
+};
+
+// set when the counters of the thread are destroyed
+thread_local bool thread_ended = false;
+
+ThreadCounters::~ThreadCounters() {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> locker(registry.m_threads);
+    for (unsigned int i = 0; i < NR_TAG; ++i) {
+        registry.ended.bytes[i].fetch_add(counters.bytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        registry.ended.allocations[i].fetch_add(counters.allocations[i].load(std::memory_order_relaxed),
+                                                std::memory_order_relaxed);
+        registry.ended.deallocations[i].fetch_add(counters.deallocations[i].load(std::memory_order_relaxed),
+                                                  std::memory_order_relaxed);
+        registry.flushed[i].fetch_add(unflushed[i], std::memory_order_relaxed);
+    }
+    registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), &counters));
+    thread_ended = true;
+}
+
+ThreadCounters* LocalCounters() {
+    if (thread_ended) {
+        return nullptr;
+    }
+    static thread_local ThreadCounters local;
+    return &local;
+}
+
+// only the owner thread writes in its counters
+void Add(std::atomic<int64_t>& counter, int64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void Increment(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+}
+
+void MemoryAccounting::Allocate(MemoryTag tag, size_t size) {
+    AllocationTracer::Record(size);
+    const unsigned int t = static_cast<unsigned int>(tag);
+    auto local = LocalCounters();
+    if (! local) {
+        // the thread is ending
+        auto& registry = GetRegistry();
+        registry.ended.bytes[t].fetch_add(size, std::memory_order_relaxed);
+        registry.ended.allocations[t].fetch_add(1, std::memory_order_relaxed);
+        registry.UpdatePeak(t, registry.flushed[t].fetch_add(size, std::memory_order_relaxed) + size);
+        return;
+    }
+    Add(local->counters.bytes[t], size);
+    Increment(local->counters.allocations[t]);
+    local->unflushed[t] += size;
+    if (local->unflushed[t] >= FLUSH_SIZE) {
+        auto& registry = GetRegistry();
+        const int64_t added = local->unflushed[t];
+        local->unflushed[t] = 0;
+        registry.UpdatePeak(t, registry.flushed[t].fetch_add(added, std::memory_order_relaxed) + added);
+    }
+}
+
+void MemoryAccounting::Deallocate(MemoryTag tag, size_t size) {
+    const unsigned int t = static_cast<unsigned int>(tag);
+    auto local = LocalCounters();
+    if (! local) {
+        auto& registry = GetRegistry();
+        registry.ended.bytes[t].fetch_sub(size, std::memory_order_relaxed);
+        registry.ended.deallocations[t].fetch_add(1, std::memory_order_relaxed);
+        registry.flushed[t].fetch_sub(size, std::memory_order_relaxed);
+        return;
+    }
+    Add(local->counters.bytes[t], -static_cast<int64_t>(size));
+    Increment(local->counters.deallocations[t]);
+    local->unflushed[t] -= size;
+    if (local->unflushed[t] <= -FLUSH_SIZE) {
+        GetRegistry().flushed[t].fetch_add(local->unflushed[t], std::memory_order_relaxed);
+        local->unflushed[t] = 0;
+    }
+}
+
+MemoryStats MemoryAccounting::Stats(MemoryTag tag) {
+    const unsigned int t = static_cast<unsigned int>(tag);
+    auto& registry = GetRegistry();
+    MemoryStats stats;
+    std::lock_guard<std::mutex> locker(registry.m_threads);
+    stats.current = registry.ended.bytes[t].load(std::memory_order_relaxed);
+    stats.allocations = registry.ended.allocations[t].load(std::memory_order_relaxed);
+    stats.deallocations = registry.ended.deallocations[t].load(std::memory_order_relaxed);
+    for (auto counters : registry.threads) {
+        stats.current += counters->bytes[t].load(std::memory_order_relaxed);
+        stats.allocations += counters->allocations[t].load(std::memory_order_relaxed);
+        stats.deallocations += counters->deallocations[t].load(std::memory_order_relaxed);
+    }
+    registry.UpdatePeak(t, stats.current);
+    stats.peak = registry.peak[t].load(std::memory_order_relaxed);
+    return stats;
+}
+
+MemoryStats MemoryAccounting::Total() {
+    MemoryStats total = {0, 0, 0, 0};
+    for (unsigned int t = 0; t < NR_TAG; ++t) {
+        const auto stats = Stats(static_cast<MemoryTag>(t));
+        total.current += stats.current;
+        total.peak += stats.peak;
+        total.allocations += stats.allocations;
+        total.deallocations += stats.deallocations;
+    }
+    return total;
+}
+
+const char* MemoryAccounting::TagName(MemoryTag tag) {
+    static const char* const names[NR_TAG] = {
+        "general", "scheduler", "resources", "graphics", "physics", "lua", "sound"
+    };
+    const unsigned int t = static_cast<unsigned int>(tag);
+    return t < NR_TAG ? names[t] : "unknown";
+}
+
+void MemoryAccounting::Dump(std::ostream& out) {
+    out << "memory accounting" << std::endl;
+    for (unsigned int t = 0; t < NR_TAG; ++t) {
+        const auto stats = Stats(static_cast<MemoryTag>(t));
+        out << TagName(static_cast<MemoryTag>(t)) << ": current " << stats.current
+            << " bytes, peak " << stats.peak << " bytes, " << stats.allocations << " allocations, "
+            << stats.deallocations << " deallocations" << std::endl;
+    }
+    const auto total = Total();
+    out << "total: current " << total.current << " bytes, peak " << total.peak << " bytes" << std::endl;
+}
+
+} // End of trillek
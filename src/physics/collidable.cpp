@@ -39,26 +39,26 @@ bool Collidable::Initialize(const std::vector<Property> &properties) {
     this->mass = 1.0;
     unsigned int entity_id;
     for (const Property& p : properties) {
-        std::string name = p.GetName();
-        if (name == "radius") {
+        Symbol name = p.GetSymbol();
+        if (name == "radius"_sym) {
             this->radius = p.Get<double>();
         }
-        else if (name == "disable_deactivation") {
+        else if (name == "disable_deactivation"_sym) {
             this->disable_deactivation = p.Get<bool>();
         }
-        else if (name == "mass") {
+        else if (name == "mass"_sym) {
             this->mass = p.Get<double>();
         }
-        else if (name == "height") {
+        else if (name == "height"_sym) {
             this->height = p.Get<double>();
         }
-        else if (name == "shape") {
+        else if (name == "shape"_sym) {
             shape = p.Get<std::string>();
         }
-        else if (name == "mesh") {
+        else if (name == "mesh"_sym) {
             mesh_name = p.Get<std::string>();
         }
-        else if (name == "entity_id") {
+        else if (name == "entity_id"_sym) {
             entity_id = p.Get<unsigned int>();
         }
     }
@@ -75,7 +75,7 @@ bool Collidable::Initialize(const std::vector<Property> &properties) {
         this->shape = std::move(std::unique_ptr<btCollisionShape>(new btSphereShape(this->radius)));
     }
     else if (shape == "static_mesh") {
-        this->mesh_file = resource::ResourceMap::Get<resource::Mesh>(mesh_name);
+        this->mesh_file = resource::ResourceMap::Get<resource::Mesh>(Symbol(mesh_name));
         this->mesh = GenerateTriangleMesh(this->mesh_file);
         if (!this->mesh) {
             return false;
@@ -91,7 +91,7 @@ bool Collidable::Initialize(const std::vector<Property> &properties) {
         this->mass = 0;
     }
     else if (shape == "dynamic_mesh") {
-        this->mesh_file = resource::ResourceMap::Get<resource::Mesh>(mesh_name);
+        this->mesh_file = resource::ResourceMap::Get<resource::Mesh>(Symbol(mesh_name));
         this->mesh = GenerateTriangleMesh(this->mesh_file);
         if (!this->mesh) {
             return false;
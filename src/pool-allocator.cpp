@@ -0,0 +1,89 @@
+#include "pool-allocator.hpp"
+#include <algorithm>
+#include <stdlib.h>
+
+namespace trillek {
+
+const size_t SlabPool::CHUNK_SIZE;
+
+SlabPool::SlabPool(size_t chunk_size, MemoryTag tag) : free_slots(nullptr), cursor(nullptr), end(nullptr),
+    chunk_size(chunk_size), tag(tag), slot_size(0), slot_alignment(0), used(0), peak(0), overflows(0) { }
+
+SlabPool::~SlabPool() {
+    for (auto chunk : this->chunks) {
+        ::free(chunk);
+        MemoryAccounting::Deallocate(this->tag, ChunkBytes());
+    }
+}
+
+void* SlabPool::Allocate(size_t size, size_t alignment) {
+    {
+        std::lock_guard<std::mutex> locker(this->m_pool);
+        if (! this->slot_size && alignment <= alignof(std::max_align_t)) {
+            // the first object gives the size of the slots, a free slot holds a pointer
+            this->slot_alignment = std::max(alignment, alignof(FreeSlot));
+            const size_t s = std::max(size, sizeof(FreeSlot));
+            this->slot_size = (s + this->slot_alignment - 1) & ~(this->slot_alignment - 1);
+        }
+        if (Fits(size, alignment)) {
+            void* p;
+            if (this->free_slots) {
+                p = this->free_slots;
+                this->free_slots = this->free_slots->next;
+            }
+            else {
+                if (this->cursor == this->end) {
+                    char* chunk = static_cast<char*>(::malloc(ChunkBytes()));
+                    if (! chunk) {
+                        throw std::bad_alloc();
+                    }
+                    MemoryAccounting::Allocate(this->tag, ChunkBytes());
+                    this->chunks.push_back(chunk);
+                    this->cursor = chunk;
+                    this->end = chunk + ChunkBytes();
+                }
+                p = this->cursor;
+                this->cursor += this->slot_size;
+            }
+            this->peak = std::max(this->peak, ++this->used);
+            return p;
+        }
+        ++this->overflows;
+    }
+    // from malloc, the memory is already counted
+    void* p = ::malloc(size);
+    if (! p) {
+        throw std::bad_alloc();
+    }
+    MemoryAccounting::Allocate(this->tag, size);
+    return p;
+}
+
+void SlabPool::Deallocate(void* p, size_t size, size_t alignment) {
+    {
+        std::lock_guard<std::mutex> locker(this->m_pool);
+        if (Fits(size, alignment)) {
+            auto slot = static_cast<FreeSlot*>(p);
+            slot->next = this->free_slots;
+            this->free_slots = slot;
+            --this->used;
+            return;
+        }
+    }
+    MemoryAccounting::Deallocate(this->tag, size);
+    ::free(p);
+}
+
+PoolStats SlabPool::Stats() const {
+    std::lock_guard<std::mutex> locker(this->m_pool);
+    PoolStats stats;
+    stats.slot_size = this->slot_size;
+    stats.capacity = this->chunks.empty() ? 0 : this->chunks.size() * ChunkBytes() / this->slot_size;
+    stats.used = this->used;
+    stats.peak = this->peak;
+    stats.chunks = this->chunks.size();
+    stats.overflows = this->overflows;
+    return stats;
+}
+
+} // End of trillek
@@ -50,8 +50,8 @@ extern std::string CleanString(std::string str);
 
 bool MD5Anim::Initialize(const std::vector<Property> &properties) {
     for (const Property& p : properties) {
-        std::string name = p.GetName();
-        if (name == "filename") {
+        Symbol name = p.GetSymbol();
+        if (name == "filename"_sym) {
             this->fname = p.Get<std::string>();
         }
     }
@@ -264,11 +264,11 @@ bool MD5Anim::CheckMesh(std::shared_ptr<Mesh> mesh_file) {
     return false;
 }
 
-MD5Anim::FrameSkeleton MD5Anim::InterpolateSkeletons(size_t frame_index_start,
+MD5Anim::InterpolatedSkeleton MD5Anim::InterpolateSkeletons(size_t frame_index_start,
     size_t frame_index_end, float delta) {
     const auto& skeleton0 = this->frames[frame_index_start]->skeleton;
     const auto& skeleton1 = this->frames[frame_index_end]->skeleton;
-    FrameSkeleton final_skeleton;
+    InterpolatedSkeleton final_skeleton;
 
     size_t num_joints = this->joints.size();
 
@@ -125,8 +125,8 @@ MD5Mesh::Weight ParsesWeight(std::stringstream& ss) {
 
 bool MD5Mesh::Initialize(const std::vector<Property> &properties) {
     for (const Property& p : properties) {
-        std::string name = p.GetName();
-        if (name == "filename") {
+        Symbol name = p.GetSymbol();
+        if (name == "filename"_sym) {
             this->fname = p.Get<std::string>();
         }
     }
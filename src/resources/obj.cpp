@@ -101,8 +101,8 @@ bool OBJ::ParseMTL(std::string fname) {
 
 bool OBJ::Initialize(const std::vector<Property> &properties) {
     for (const Property& p : properties) {
-        std::string name = p.GetName();
-        if (name == "filename") {
+        Symbol name = p.GetSymbol();
+        if (name == "filename"_sym) {
             this->fname = p.Get<std::string>();
         }
     }
@@ -186,8 +186,8 @@ void PixelBuffer::UnlockWrite() {
 bool PixelBuffer::Initialize(const std::vector<Property> &properties) {
     std::string fname;
     for(const Property& p : properties) {
-        std::string name = p.GetName();
-        if(name == "filename") {
+        Symbol name = p.GetSymbol();
+        if(name == "filename"_sym) {
             fname = p.Get<std::string>();
             meta.push_back(Property(p));
         }
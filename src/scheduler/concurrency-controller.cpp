@@ -0,0 +1,82 @@
+#include "scheduler/concurrency-controller.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace trillek {
+
+ConcurrencyController::ConcurrencyController() : counts(0), waiting(0) {
+    const unsigned int hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    limit.store(hardware);
+    quotas[static_cast<unsigned int>(TaskClass::FRAME_CRITICAL)].store(hardware);
+    quotas[static_cast<unsigned int>(TaskClass::BACKGROUND_IO)].store(std::max(hardware / 4, 1u));
+    quotas[static_cast<unsigned int>(TaskClass::SCRIPTING)].store(std::max(hardware / 4, 1u));
+}
+
+void ConcurrencyController::SetLimit(unsigned int l) {
+    limit.store(std::max(std::min(l, (1u << FIELD_BITS) - 1), 1u));
+    // a higher limit can let several tasks run
+    Grant(~0u);
+}
+
+void ConcurrencyController::SetQuota(TaskClass task_class, unsigned int quota) {
+    quotas[static_cast<unsigned int>(task_class)].store(std::max(std::min(quota, (1u << FIELD_BITS) - 1), 1u));
+    Grant(~0u);
+}
+
+bool ConcurrencyController::TryAcquire(TaskClass task_class) {
+    const unsigned int field = 1 + static_cast<unsigned int>(task_class);
+    const unsigned int quota = quotas[field - 1].load(std::memory_order_relaxed);
+    const unsigned int max = limit.load(std::memory_order_relaxed);
+    uint64_t state = counts.load();
+    do {
+        if (Field(state, 0) >= max || Field(state, field) >= quota) {
+            return false;
+        }
+    } while (! counts.compare_exchange_weak(state, state + One(0) + One(field)));
+    return true;
+}
+
+void ConcurrencyController::Acquire(TaskClass task_class) {
+    if (TryAcquire(task_class)) {
+        return;
+    }
+    std::unique_lock<std::mutex> locker(m_waiters);
+    Waiter waiter(task_class);
+    auto it = waiters.insert(waiters.end(), &waiter);
+    // register before trying again, so that a thread releasing a slot
+    // after the try sees us and gives us the slot
+    waiting.fetch_add(1);
+    if (TryAcquire(task_class)) {
+        waiters.erase(it);
+        waiting.fetch_sub(1);
+        return;
+    }
+    waiter.cv.wait(locker, [&waiter]() { return waiter.granted; });
+}
+
+void ConcurrencyController::Release(TaskClass task_class) {
+    counts.fetch_sub(One(0) + One(1 + static_cast<unsigned int>(task_class)));
+    if (waiting.load()) {
+        Grant(1);
+    }
+}
+
+void ConcurrencyController::Grant(unsigned int max_grants) {
+    std::lock_guard<std::mutex> locker(m_waiters);
+    for (auto it = waiters.begin(); it != waiters.end() && max_grants;) {
+        Waiter& waiter = **it;
+        if (TryAcquire(waiter.task_class)) {
+            // the slot is taken on behalf of the waiter
+            it = waiters.erase(it);
+            waiting.fetch_sub(1);
+            waiter.granted = true;
+            waiter.cv.notify_one();
+            --max_grants;
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+} // namespace trillek
@@ -0,0 +1,81 @@
+#include "scheduler/io-lane.hpp"
+#include <algorithm>
+
+namespace trillek {
+
+IOLane::IOLane(unsigned int max_thread) :
+    max_thread(std::max(max_thread, 1u)), idle(0), stopping(false) {}
+
+IOLane::~IOLane() {
+    Stop();
+}
+
+void IOLane::SetMaxThreads(unsigned int max) {
+    std::lock_guard<std::mutex> locker(m_jobs);
+    max_thread = std::max(max, 1u);
+}
+
+unsigned int IOLane::MaxThreads() const {
+    std::lock_guard<std::mutex> locker(m_jobs);
+    return max_thread;
+}
+
+unsigned int IOLane::Threads() const {
+    std::lock_guard<std::mutex> locker(m_jobs);
+    return threads.size();
+}
+
+size_t IOLane::Pending() const {
+    std::lock_guard<std::mutex> locker(m_jobs);
+    return jobs.size();
+}
+
+void IOLane::Push(std::function<void(void)>&& job) {
+    std::lock_guard<std::mutex> locker(m_jobs);
+    jobs.push_back(std::move(job));
+    if (jobs.size() > idle && threads.size() < max_thread) {
+        // the idle threads will not take all the jobs
+        threads.push_back(std::thread(&IOLane::Loop, this));
+    }
+    else {
+        jobcheck.notify_one();
+    }
+}
+
+void IOLane::Stop() {
+    std::vector<std::thread> stopped;
+    {
+        std::lock_guard<std::mutex> locker(m_jobs);
+        stopping = true;
+        stopped.swap(threads);
+        jobcheck.notify_all();
+    }
+    // the threads leave when no job is left
+    for (auto& t : stopped) {
+        t.join();
+    }
+    std::lock_guard<std::mutex> locker(m_jobs);
+    stopping = false;
+}
+
+void IOLane::Loop() {
+    std::unique_lock<std::mutex> locker(m_jobs);
+    while (1) {
+        while (jobs.empty() && ! stopping) {
+            ++idle;
+            // threads wait here (blocking point)
+            jobcheck.wait(locker);
+            --idle;
+        }
+        if (jobs.empty()) {
+            return;
+        }
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+        locker.unlock();
+        job();
+        locker.lock();
+    }
+}
+
+} // namespace trillek
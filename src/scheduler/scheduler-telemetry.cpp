@@ -0,0 +1,170 @@
+#include "scheduler/scheduler-telemetry.hpp"
+#include <algorithm>
+
+namespace trillek {
+
+const unsigned int LatencyHistogram::BUCKETS;
+const unsigned int SchedulerTelemetry::DEPTH_SAMPLES;
+
+uint64_t LatencyHistogram::Count() const {
+    uint64_t count = 0;
+    for (auto& b : buckets) {
+        count += b.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+frame_unit LatencyHistogram::Mean() const {
+    const uint64_t count = Count();
+    return frame_unit(count ? total.load(std::memory_order_relaxed) / count : 0);
+}
+
+frame_unit LatencyHistogram::Percentile(double percent) const {
+    const uint64_t count = Count();
+    if (! count) {
+        return frame_unit(0);
+    }
+    // the rank of the duration, from 1
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(count * percent / 100.0 + 0.5));
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return UpperBound(i);
+        }
+    }
+    return UpperBound(BUCKETS - 1);
+}
+
+SchedulerTelemetry::SchedulerTelemetry() : frame_overruns(0), depth_count(0) {
+    for (auto& d : depths) {
+        d.store(0, std::memory_order_relaxed);
+    }
+}
+
+void SchedulerTelemetry::Initialize(unsigned int nr_worker) {
+    slots.clear();
+    for (unsigned int i = 0; i < nr_worker; ++i) {
+        slots.push_back(std::unique_ptr<Slot>(new Slot()));
+    }
+}
+
+void SchedulerTelemetry::RecordTask(unsigned int worker, const frame_unit& wait, const frame_unit& run) {
+    if (worker >= slots.size()) {
+        return;
+    }
+    auto& slot = *slots[worker];
+    // only this worker writes in the slot
+    slot.busy.store(slot.busy.load(std::memory_order_relaxed) + run.count(), std::memory_order_relaxed);
+    slot.tasks.store(slot.tasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slot.wait.Record(wait);
+    slot.run.Record(run);
+}
+
+void SchedulerTelemetry::RecordIdle(unsigned int worker, const frame_unit& idle) {
+    if (worker >= slots.size()) {
+        return;
+    }
+    auto& slot = *slots[worker];
+    slot.idle.store(slot.idle.load(std::memory_order_relaxed) + idle.count(), std::memory_order_relaxed);
+}
+
+void SchedulerTelemetry::RecordFrameStart(const frame_unit& lateness, size_t queue_depth) {
+    frame_lateness.Record(lateness);
+    const auto index = depth_count.fetch_add(1, std::memory_order_relaxed);
+    depths[index % DEPTH_SAMPLES].store(queue_depth, std::memory_order_relaxed);
+}
+
+void SchedulerTelemetry::RecordFrameEnd(const frame_unit& duration, const frame_unit& budget) {
+    frame_times.Record(duration);
+    if (budget < duration) {
+        frame_overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+WorkerTelemetry SchedulerTelemetry::Worker(unsigned int worker) const {
+    WorkerTelemetry result;
+    if (worker < slots.size()) {
+        auto& slot = *slots[worker];
+        result.busy = frame_unit(slot.busy.load(std::memory_order_relaxed));
+        result.idle = frame_unit(slot.idle.load(std::memory_order_relaxed));
+        result.tasks = slot.tasks.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+LatencyHistogram SchedulerTelemetry::WaitTimes() const {
+    LatencyHistogram result;
+    for (auto& slot : slots) {
+        result.Merge(slot->wait);
+    }
+    return result;
+}
+
+LatencyHistogram SchedulerTelemetry::RunTimes() const {
+    LatencyHistogram result;
+    for (auto& slot : slots) {
+        result.Merge(slot->run);
+    }
+    return result;
+}
+
+std::vector<size_t> SchedulerTelemetry::QueueDepths() const {
+    const uint64_t count = depth_count.load(std::memory_order_relaxed);
+    const uint64_t first = count > DEPTH_SAMPLES ? count - DEPTH_SAMPLES : 0;
+    std::vector<size_t> result;
+    for (uint64_t i = first; i < count; ++i) {
+        result.push_back(depths[i % DEPTH_SAMPLES].load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+namespace {
+void DumpHistogram(std::ostream& out, const char* name, const LatencyHistogram& histogram) {
+    out << name << ": " << histogram.Count() << " samples, mean " << histogram.Mean().count()
+        << " ns, p50 < " << histogram.Percentile(50).count()
+        << " ns, p99 < " << histogram.Percentile(99).count()
+        << " ns, max < " << histogram.Percentile(100).count() << " ns" << std::endl;
+}
+}
+
+void SchedulerTelemetry::Dump(std::ostream& out) const {
+    out << "scheduler telemetry" << std::endl;
+    for (unsigned int i = 0; i < slots.size(); ++i) {
+        const auto worker = Worker(i);
+        out << "worker " << i << ": " << worker.tasks << " tasks, busy "
+            << duration_cast<milliseconds>(worker.busy).count() << " ms, idle "
+            << duration_cast<milliseconds>(worker.idle).count() << " ms" << std::endl;
+    }
+    DumpHistogram(out, "task wait", WaitTimes());
+    DumpHistogram(out, "task run", RunTimes());
+    DumpHistogram(out, "frame lateness", frame_lateness);
+    DumpHistogram(out, "frame duration", frame_times);
+    out << "frame overruns: " << FrameOverruns() << std::endl;
+    const auto samples = QueueDepths();
+    if (! samples.empty()) {
+        size_t max_depth = 0, sum = 0;
+        for (auto d : samples) {
+            max_depth = std::max(max_depth, d);
+            sum += d;
+        }
+        out << "queue depth: last " << samples.back() << ", mean " << sum / samples.size()
+            << ", max " << max_depth << " over " << samples.size() << " frames" << std::endl;
+    }
+}
+
+void SchedulerTelemetry::Reset() {
+    for (auto& slot : slots) {
+        slot->busy.store(0, std::memory_order_relaxed);
+        slot->idle.store(0, std::memory_order_relaxed);
+        slot->tasks.store(0, std::memory_order_relaxed);
+        slot->wait.Reset();
+        slot->run.Reset();
+    }
+    frame_lateness.Reset();
+    frame_times.Reset();
+    frame_overruns.store(0, std::memory_order_relaxed);
+    depth_count.store(0, std::memory_order_relaxed);
+}
+
+} // namespace trillek
@@ -0,0 +1,215 @@
+#include "scheduler/system-graph.hpp"
+#include <algorithm>
+#include <limits>
+#include "scheduler/task-pool.hpp"
+#include "systems/system-base.hpp"
+
+namespace trillek {
+
+const size_t SystemGraph::STOPPED;
+
+/** \brief The task running a system in a frame
+ */
+class SystemGraph::SystemTask : public TaskRequestBase {
+public:
+    SystemTask(SystemGraph& graph, size_t index, const frame_tp& frame) :
+        TaskRequestBase(frame_tp(frame)), graph(graph), index(index) {};
+
+    void RunTask() override {
+        graph.Run(index);
+    };
+
+private:
+    SystemGraph& graph;
+    const size_t index;
+};
+
+namespace {
+bool Intersect(const std::vector<SystemData>& a, const std::vector<SystemData>& b) {
+    for (auto data : a) {
+        if (std::find(b.begin(), b.end(), data) != b.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+SystemGraph::SystemGraph(push_t push, std::function<void(void)> frame_done, frame_start_t frame_start) :
+    push(std::move(push)), frame_done(std::move(frame_done)), frame_start(std::move(frame_start)), remaining(0),
+    next_frame(std::numeric_limits<frame_unit::rep>::max()) {}
+
+void SystemGraph::Build(std::queue<SystemBase*>& systems, unsigned int nr_worker,
+                        const frame_tp& start, const frame_unit& frame_length) {
+    nodes.clear();
+    frame_tp first = frame_tp::max();
+    while (! systems.empty()) {
+        std::unique_ptr<Node> node(new Node());
+        node->system = systems.front();
+        node->home = nodes.size() % std::max(nr_worker, 1u);
+        node->bound = node->system->ThreadBound();
+        node->pending = 0;
+        node->due = false;
+        node->period = node->system->TickPeriod().count() ? node->system->TickPeriod() : frame_length;
+        node->next_tick = start + node->period;
+        node->ticks = 0;
+        node->overruns = 0;
+        node->skipped = 0;
+        first = std::min(first, node->next_tick);
+        systems.pop();
+        // the systems registered before that conflict with this one are predecessors
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            auto& previous = *nodes[i];
+            if (Intersect(previous.system->GetWrites(), node->system->GetReads())
+                || Intersect(previous.system->GetWrites(), node->system->GetWrites())
+                || Intersect(previous.system->GetReads(), node->system->GetWrites())) {
+                previous.successors.push_back(nodes.size());
+                node->predecessors.push_back(i);
+            }
+        }
+        nodes.push_back(std::move(node));
+    }
+    next_frame.store(first.time_since_epoch().count());
+}
+
+void SystemGraph::ThreadInit(unsigned int worker) {
+    for (auto& node : nodes) {
+        if (node->home == worker) {
+            node->system->ThreadInit();
+        }
+    }
+}
+
+void SystemGraph::Terminate(unsigned int worker) {
+    for (auto& node : nodes) {
+        if (node->home == worker) {
+            node->system->Terminate();
+        }
+    }
+}
+
+bool SystemGraph::Stop() {
+    size_t idle = 0;
+    if (remaining.compare_exchange_strong(idle, STOPPED)) {
+        next_frame.store(std::numeric_limits<frame_unit::rep>::max());
+        return true;
+    }
+    return idle == STOPPED;
+}
+
+bool SystemGraph::StartFrame(const frame_tp& now) {
+    if (nodes.empty() || now < NextFrame()) {
+        return false;
+    }
+    size_t idle = 0;
+    if (! remaining.compare_exchange_strong(idle, nodes.size())) {
+        // the previous frame is running, or the graph is stopped
+        return false;
+    }
+    // we own the frame, the next frame can not have been started meanwhile
+    const frame_tp frame = NextFrame();
+    if (now < frame) {
+        remaining.store(0);
+        frame_done();
+        return false;
+    }
+    current_frame = frame;
+    // the systems whose tick is the frame
+    size_t count = 0;
+    frame_tp next = frame_tp::max();
+    for (auto& node : nodes) {
+        node->due = ! (frame < node->next_tick);
+        if (node->due) {
+            Tick(*node, now);
+            ++count;
+        }
+        next = std::min(next, node->next_tick);
+    }
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        unsigned int due_predecessors = 0;
+        for (auto p : nodes[i]->predecessors) {
+            if (nodes[p]->due) {
+                ++due_predecessors;
+            }
+        }
+        nodes[i]->pending.store(due_predecessors);
+        if (nodes[i]->due && ! due_predecessors) {
+            roots.push_back(i);
+        }
+    }
+    remaining.store(count);
+    next_frame.store(next.time_since_epoch().count());
+    if (frame_start) {
+        frame_start(frame, now);
+    }
+    // the frame can be finished and the next one begun before the end of the loop
+    for (auto index : roots) {
+        Queue(index, frame);
+    }
+    return true;
+}
+
+void SystemGraph::Tick(Node& node, const frame_tp& now) {
+    ++node.ticks;
+    // the number of ticks that are due after this one
+    const auto missed = static_cast<uint64_t>((now - node.next_tick) / node.period);
+    uint64_t dropped = 0;
+    if (missed) {
+        ++node.overruns;
+        switch (node.system->GetCatchUpPolicy()) {
+        case CatchUpPolicy::SKIP:
+            dropped = missed;
+            break;
+        case CatchUpPolicy::CLAMP:
+            dropped = missed > node.system->MaxCatchUp() ? missed - node.system->MaxCatchUp() : 0;
+            break;
+        case CatchUpPolicy::BURST:
+        default:
+            break;
+        }
+        node.skipped += dropped;
+    }
+    node.next_tick += node.period * (dropped + 1);
+}
+
+SystemTickStats SystemGraph::GetTickStats(const SystemBase* system) const {
+    SystemTickStats stats;
+    for (auto& node : nodes) {
+        if (node->system == system) {
+            stats.ticks = node->ticks.load();
+            stats.overruns = node->overruns.load();
+            stats.skipped = node->skipped.load();
+        }
+    }
+    return stats;
+}
+
+frame_tp SystemGraph::NextFrame() const {
+    return frame_tp(frame_unit(next_frame.load()));
+}
+
+void SystemGraph::Queue(size_t index, const frame_tp& frame) {
+    auto& node = *nodes[index];
+    auto task = std::make_shared<SystemTask>(*this, index, frame);
+    // the tick must be done before the next tick of the system
+    task->SetDeadline(node.next_tick);
+    push(std::move(task), node.bound ? node.home : TaskPool::NO_WORKER);
+}
+
+void SystemGraph::Run(size_t index) {
+    auto& node = *nodes[index];
+    node.system->HandleEvents(current_frame);
+    node.system->RunBatch();
+    for (auto s : node.successors) {
+        if (nodes[s]->due && nodes[s]->pending.fetch_sub(1) == 1) {
+            // all the predecessors are done
+            Queue(s, current_frame);
+        }
+    }
+    if (remaining.fetch_sub(1) == 1) {
+        frame_done();
+    }
+}
+
+} // namespace trillek
@@ -0,0 +1,295 @@
+#include "scheduler/task-pool.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace trillek {
+
+const unsigned int TaskPool::NO_WORKER;
+const unsigned int TaskPool::CRITICAL_LANE;
+const unsigned int TaskPool::BACKGROUND_LANE;
+const unsigned int TaskPool::LANES;
+
+void GlobalTaskPool::Push(std::shared_ptr<TaskRequestBase>&& task, unsigned int /*worker*/, const frame_tp& now) {
+    std::lock_guard<std::mutex> locker(m_queue);
+    PushLocked(std::move(task), now);
+}
+
+void GlobalTaskPool::PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks, unsigned int /*worker*/, const frame_tp& now) {
+    std::lock_guard<std::mutex> locker(m_queue);
+    for (auto& task : tasks) {
+        PushLocked(std::move(task), now);
+    }
+}
+
+void GlobalTaskPool::PushLocked(std::shared_ptr<TaskRequestBase>&& task, const frame_tp& now) {
+    if (now < task->Timepoint()) {
+        auto tp = task->Timepoint();
+        timers.Insert(std::move(task), tp, now);
+        return;
+    }
+    const auto lane = Lane(*task);
+    taskqueue[lane].push(std::move(task));
+}
+
+bool GlobalTaskPool::Pop(std::shared_ptr<TaskRequestBase>& task, unsigned int /*worker*/, const frame_tp& now) {
+    std::lock_guard<std::mutex> locker(m_queue);
+    if (! timers.Empty() && ! (now < timers.NextTimepoint())) {
+        timers.Advance(now, due);
+        for (auto& t : due) {
+            const auto lane = Lane(*t);
+            taskqueue[lane].push(std::move(t));
+        }
+        due.clear();
+    }
+    bool ready[LANES];
+    for (unsigned int lane = 0; lane < LANES; ++lane) {
+        ready[lane] = ! taskqueue[lane].empty() && ! (now < taskqueue[lane].top()->Timepoint());
+    }
+    const unsigned int first_lane = ready[CRITICAL_LANE] && ready[BACKGROUND_LANE] ? ChooseLane(critical_run)
+                                    : ready[CRITICAL_LANE] ? CRITICAL_LANE : BACKGROUND_LANE;
+    for (unsigned int i = 0; i < LANES; ++i) {
+        const unsigned int lane = (first_lane + i) % LANES;
+        if (ready[lane] && Admit(lane, *taskqueue[lane].top())) {
+            // only count the frame-critical tasks run while background tasks wait
+            critical_run = lane == CRITICAL_LANE && ready[BACKGROUND_LANE] ? critical_run + 1 : 0;
+            task = taskqueue[lane].top();
+            taskqueue[lane].pop();
+            return true;
+        }
+    }
+    return false;
+}
+
+frame_tp GlobalTaskPool::NextTimepoint() const {
+    std::lock_guard<std::mutex> locker(m_queue);
+    frame_tp next = timers.NextTimepoint();
+    for (unsigned int lane = 0; lane < LANES; ++lane) {
+        if (! taskqueue[lane].empty() && ! Refused(lane)) {
+            next = std::min(next, taskqueue[lane].top()->Timepoint());
+        }
+    }
+    return next;
+}
+
+size_t GlobalTaskPool::Size() const {
+    std::lock_guard<std::mutex> locker(m_queue);
+    size_t size = timers.Size();
+    for (auto& q : taskqueue) {
+        size += q.size();
+    }
+    return size;
+}
+
+WorkStealingTaskPool::WorkStealingTaskPool(unsigned int nr_worker) :
+    ready_count(0), background_count(0), next_target(0), delayed_count(0),
+    next_delayed(std::numeric_limits<frame_unit::rep>::max()) {
+    for (auto& count : deadline_count) {
+        count.store(0);
+    }
+    for (unsigned int i = 0; i < std::max(nr_worker, 1u); ++i) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+}
+
+unsigned int WorkStealingTaskPool::Target(unsigned int worker) {
+    if (worker < queues.size()) {
+        return worker;
+    }
+    // not a worker : spread the tasks
+    return next_target.fetch_add(1, std::memory_order_relaxed) % queues.size();
+}
+
+void WorkStealingTaskPool::Push(std::shared_ptr<TaskRequestBase>&& task, unsigned int worker, const frame_tp& now) {
+    if (now < task->Timepoint()) {
+        std::lock_guard<std::mutex> locker(m_delayed);
+        auto tp = task->Timepoint();
+        delayed.Insert(std::move(task), tp, now);
+        delayed_count.fetch_add(1);
+        next_delayed.store(delayed.NextTimepoint().time_since_epoch().count());
+        return;
+    }
+    // count the task before it is visible, so that the counter never wraps
+    ready_count.fetch_add(1);
+    if (Lane(*task) == BACKGROUND_LANE) {
+        background_count.fetch_add(1);
+    }
+    if (HasDeadline(task)) {
+        std::lock_guard<std::mutex> locker(m_deadlines);
+        PushDeadlineLocked(std::move(task));
+        return;
+    }
+    auto& q = *queues[Target(worker)];
+    std::lock_guard<std::mutex> locker(q.m_tasks);
+    PushLocked(q, std::move(task));
+}
+
+void WorkStealingTaskPool::PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks, unsigned int worker, const frame_tp& now) {
+    // the delayed tasks go to the timer wheel, the others stay in order
+    auto ready_end = std::stable_partition(tasks.begin(), tasks.end(),
+                        [&now](const std::shared_ptr<TaskRequestBase>& t) { return ! (now < t->Timepoint()); });
+    const size_t ready = ready_end - tasks.begin();
+    if (ready_end != tasks.end()) {
+        std::lock_guard<std::mutex> locker(m_delayed);
+        for (auto it = ready_end; it != tasks.end(); ++it) {
+            auto tp = (*it)->Timepoint();
+            delayed.Insert(std::move(*it), tp, now);
+        }
+        delayed_count.fetch_add(tasks.end() - ready_end);
+        next_delayed.store(delayed.NextTimepoint().time_since_epoch().count());
+    }
+    if (! ready) {
+        return;
+    }
+    ready_count.fetch_add(ready);
+    background_count.fetch_add(std::count_if(tasks.begin(), ready_end,
+                        [](const std::shared_ptr<TaskRequestBase>& t) { return Lane(*t) == BACKGROUND_LANE; }));
+    const size_t queued = PushDeadlines(tasks.begin(), ready_end) - tasks.begin();
+    if (! queued) {
+        return;
+    }
+    // a worker keeps the batch, another thread spreads it
+    const size_t nr_slice = worker < queues.size() ? 1 : std::min(queued, queues.size());
+    size_t first = 0;
+    for (size_t s = 0; s < nr_slice; ++s) {
+        const size_t last = queued * (s + 1) / nr_slice;
+        auto& q = *queues[Target(worker)];
+        std::lock_guard<std::mutex> locker(q.m_tasks);
+        for (size_t i = first; i < last; ++i) {
+            PushLocked(q, std::move(tasks[i]));
+        }
+        first = last;
+    }
+}
+
+void WorkStealingTaskPool::ReleaseDelayed(unsigned int target, const frame_tp& now) {
+    std::vector<std::shared_ptr<TaskRequestBase>> due;
+    {
+        std::unique_lock<std::mutex> locker(m_delayed, std::try_to_lock);
+        if (! locker.owns_lock()) {
+            // another worker is doing the job
+            return;
+        }
+        delayed.Advance(now, due);
+        next_delayed.store(delayed.NextTimepoint().time_since_epoch().count());
+        if (due.empty()) {
+            return;
+        }
+        // count the tasks as ready before they leave the heap count
+        // so that the pool never looks empty while they move
+        ready_count.fetch_add(due.size());
+        background_count.fetch_add(std::count_if(due.begin(), due.end(),
+                            [](const std::shared_ptr<TaskRequestBase>& t) { return Lane(*t) == BACKGROUND_LANE; }));
+        delayed_count.fetch_sub(due.size());
+    }
+    const auto queued = PushDeadlines(due.begin(), due.end());
+    auto& q = *queues[target];
+    std::lock_guard<std::mutex> locker(q.m_tasks);
+    for (auto it = due.begin(); it != queued; ++it) {
+        PushLocked(q, std::move(*it));
+    }
+}
+
+std::vector<std::shared_ptr<TaskRequestBase>>::iterator WorkStealingTaskPool::PushDeadlines(
+    std::vector<std::shared_ptr<TaskRequestBase>>::iterator first,
+    std::vector<std::shared_ptr<TaskRequestBase>>::iterator last) {
+    auto end = std::stable_partition(first, last,
+                    [](const std::shared_ptr<TaskRequestBase>& t) { return ! HasDeadline(t); });
+    if (end != last) {
+        std::lock_guard<std::mutex> locker(m_deadlines);
+        for (auto it = end; it != last; ++it) {
+            PushDeadlineLocked(std::move(*it));
+        }
+    }
+    return end;
+}
+
+bool WorkStealingTaskPool::Pop(std::shared_ptr<TaskRequestBase>& task, unsigned int worker, const frame_tp& now) {
+    const unsigned int self = Target(worker);
+    if (now.time_since_epoch().count() >= next_delayed.load(std::memory_order_relaxed)) {
+        ReleaseDelayed(self, now);
+    }
+    if (! ready_count.load()) {
+        return false;
+    }
+    auto& critical_run = queues[self]->critical_run;
+    const bool background_waiting = background_count.load() != 0;
+    const unsigned int first_lane = background_waiting ? ChooseLane(critical_run.load(std::memory_order_relaxed))
+                                                       : CRITICAL_LANE;
+    for (unsigned int i = 0; i < LANES; ++i) {
+        const unsigned int lane = (first_lane + i) % LANES;
+        if (PopLane(task, self, lane)) {
+            // only count the frame-critical tasks run while background tasks wait
+            critical_run.store(lane == CRITICAL_LANE && background_waiting ? critical_run.load(std::memory_order_relaxed) + 1 : 0,
+                               std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingTaskPool::PopLane(std::shared_ptr<TaskRequestBase>& task, unsigned int self, unsigned int lane) {
+    std::shared_ptr<TaskRequestBase> popped;
+    if (deadline_count[lane].load()) {
+        // the earliest deadline of all the workers
+        std::lock_guard<std::mutex> locker(m_deadlines);
+        if (! deadline_tasks[lane].empty()) {
+            if (! Admit(lane, *deadline_tasks[lane].top())) {
+                return false;
+            }
+            popped = deadline_tasks[lane].top();
+            deadline_tasks[lane].pop();
+            deadline_count[lane].fetch_sub(1);
+        }
+    }
+    if (! popped) {
+        // our own deque, newest first
+        auto& q = *queues[self];
+        std::lock_guard<std::mutex> locker(q.m_tasks);
+        if (! q.tasks[lane].empty()) {
+            if (! Admit(lane, *q.tasks[lane].back())) {
+                return false;
+            }
+            popped = std::move(q.tasks[lane].back());
+            q.tasks[lane].pop_back();
+        }
+    }
+    // steal the oldest task of another worker
+    for (unsigned int i = 1; i < queues.size() && ! popped; ++i) {
+        auto& q = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> locker(q.m_tasks);
+        if (! q.tasks[lane].empty()) {
+            if (! Admit(lane, *q.tasks[lane].front())) {
+                return false;
+            }
+            popped = std::move(q.tasks[lane].front());
+            q.tasks[lane].pop_front();
+        }
+    }
+    if (! popped) {
+        return false;
+    }
+    // uncount the background task first, so that the ready count never
+    // looks lower than the number of ready frame-critical tasks
+    if (lane == BACKGROUND_LANE) {
+        background_count.fetch_sub(1);
+    }
+    ready_count.fetch_sub(1);
+    task = std::move(popped);
+    return true;
+}
+
+frame_tp WorkStealingTaskPool::NextTimepoint() const {
+    // the ready tasks of the refused lanes are ignored
+    const size_t ready = ready_count.load();
+    const size_t background = background_count.load();
+    if ((ready > background && ! Refused(CRITICAL_LANE)) || (background && ! Refused(BACKGROUND_LANE))) {
+        return frame_tp::min();
+    }
+    return frame_tp(frame_unit(next_delayed.load()));
+}
+
+size_t WorkStealingTaskPool::Size() const {
+    return ready_count.load() + delayed_count.load();
+}
+
+} // namespace trillek
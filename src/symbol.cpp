@@ -0,0 +1,53 @@
+#include "symbol.hpp"
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace trillek {
+
+namespace {
+// the interned names by ID, never destroyed: symbols can be used after the end of main()
+struct SymbolTable {
+    std::mutex m_names;
+    std::unordered_map<uint64_t, std::string> names;
+};
+
+SymbolTable& GetSymbolTable() {
+    static SymbolTable* table = new SymbolTable();
+    return *table;
+}
+
+uint64_t HashString(const char* str, std::size_t length) {
+    // same as Symbol::Hash, without the recursion
+    uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(str[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+}
+
+Symbol::Symbol(const std::string& str) {
+    Intern(str.data(), str.size());
+}
+
+Symbol::Symbol(const char* str) {
+    Intern(str, std::strlen(str));
+}
+
+void Symbol::Intern(const char* str, std::size_t length) {
+    this->id = HashString(str, length);
+    auto& table = GetSymbolTable();
+    std::lock_guard<std::mutex> locker(table.m_names);
+    auto itr = table.names.find(this->id);
+    if (itr == table.names.end()) {
+        itr = table.names.emplace(this->id, std::string(str, length)).first;
+    }
+    else if (itr->second.compare(0, std::string::npos, str, length) != 0) {
+        throw std::logic_error("Symbol: \"" + std::string(str, length) + "\" has the ID of \"" + itr->second + "\"");
+    }
+    this->name = itr->second.c_str();
+}
+
+} // End of trillek
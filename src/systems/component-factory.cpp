@@ -45,13 +45,13 @@ bool ComponentFactory::Parse(rapidjson::Value& node) {
                     }
                     else {
                         std::vector<Property> props;
-                        props.push_back(Property("entity_id", entity_id));
+                        props.push_back(Property("entity_id"_sym, entity_id));
                         unsigned int component_type_id = GetTypeIDFromName(entity_property_name);
                         if (entity_property_itr->value.IsObject()) {
                             for (auto component_property_itr = entity_property_itr->value.MemberBegin();
                                 component_property_itr != entity_property_itr->value.MemberEnd(); ++component_property_itr) {
-                                std::string component_property_name(component_property_itr->name.GetString(),
-                                    component_property_itr->name.GetStringLength());
+                                Symbol component_property_name(std::string(component_property_itr->name.GetString(),
+                                    component_property_itr->name.GetStringLength()));
 
                                 if (component_property_itr->value.IsString()) {
                                     std::string property_value(component_property_itr->value.GetString(),
@@ -19,8 +19,10 @@ namespace trillek {
 namespace graphics {
 
 RenderSystem::RenderSystem() : Parser("graphics") {
+    DeclareRead(SystemData::TRANSFORMS);
     multisample = false;
     this->frame_drop = false;
+    this->next_transforms = 0;
     Shader::InitializeTypes();
 }
 
@@ -34,7 +36,7 @@ const int* RenderSystem::Start(const unsigned int width, const unsigned int heig
     debugmode = 0;
 
     // Subscribe to events
-    event::Dispatcher<KeyboardEvent>::GetInstance()->Subscribe(this);
+    this->keyboard_events.Subscribe();
 
     if(opengl_version < 300) {
         LOGMSGC(FATAL) << "OpenGL version (" << opengl_version << ") less than required minimum (300)";
@@ -105,11 +107,11 @@ const int* RenderSystem::Start(const unsigned int width, const unsigned int heig
     glBindVertexArray(0); CheckGLError(); // unbind VAO when done
 
     std::list<Property> settings;
-    settings.push_back(Property("version", opengl_version));
-    settings.push_back(Property("screen-width", width));
-    settings.push_back(Property("screen-height", height));
-    settings.push_back(Property("multisample", this->multisample));
-    settings.push_back(Property("samples", (int)8));
+    settings.push_back(Property("version"_sym, opengl_version));
+    settings.push_back(Property("screen-width"_sym, width));
+    settings.push_back(Property("screen-height"_sym, height));
+    settings.push_back(Property("multisample"_sym, this->multisample));
+    settings.push_back(Property("samples"_sym, (int)8));
 
     for(unsigned int p = 0; p < 3; p++) {
         for(auto& ginstance : this->graphics_instances) {
@@ -186,8 +188,8 @@ void RenderSystem::RegisterListResolvers() {
             else if(rentype == "post") {
                 rlist.run_values.push_back(Container((long)3));
                 for(auto pitr = rlist.load_properties.begin(); pitr != rlist.load_properties.end(); pitr++) {
-                    if(pitr->GetName() == "shader" && pitr->Is<std::string>()) {
-                        auto shader_ptr = rensys.Get<Shader>(pitr->Get<std::string>());
+                    if(pitr->GetSymbol() == "shader"_sym && pitr->Is<std::string>()) {
+                        auto shader_ptr = rensys.Get<Shader>(Symbol(pitr->Get<std::string>()));
                         if(shader_ptr) {
                             rlist.run_values.push_back(Container(shader_ptr));
                         }
@@ -213,7 +215,7 @@ void RenderSystem::RegisterListResolvers() {
         }
         else if(rlist.cmdvalue.Is<std::string>()) {
             rlist.run_values.push_back(Container(true));
-            auto layerptr = rensys.Get<RenderLayer>(rlist.cmdvalue.Get<std::string>());
+            auto layerptr = rensys.Get<RenderLayer>(Symbol(rlist.cmdvalue.Get<std::string>()));
             if(!layerptr) {
                 LOGMSGON(ERROR, rensys) << "Layer not found: " << rlist.cmdvalue.Get<std::string>();
                 return false;
@@ -232,7 +234,7 @@ void RenderSystem::RegisterListResolvers() {
         }
         else if(rlist.cmdvalue.Is<std::string>()) {
             rlist.run_values.push_back(Container(true));
-            auto layerptr = rensys.Get<RenderLayer>(rlist.cmdvalue.Get<std::string>());
+            auto layerptr = rensys.Get<RenderLayer>(Symbol(rlist.cmdvalue.Get<std::string>()));
             if(!layerptr) {
                 LOGMSGON(ERROR, rensys) << "Layer not found: " << rlist.cmdvalue.Get<std::string>();
                 return false;
@@ -242,7 +244,7 @@ void RenderSystem::RegisterListResolvers() {
         std::shared_ptr<RenderLayer> target;
         GLuint copytypebits = 0;
         for(auto& prop : rlist.load_properties) {
-            if(prop.GetName() == "type") {
+            if(prop.GetSymbol() == "type"_sym) {
                 if(prop.Is<std::string>()) {
                     const std::string& typestring = prop.Get<std::string>();
                     auto fboct = fbo_copytype_map.find(typestring);
@@ -257,9 +259,9 @@ void RenderSystem::RegisterListResolvers() {
                     return false;
                 }
             }
-            else if(prop.GetName() == "to") {
+            else if(prop.GetSymbol() == "to"_sym) {
                 if(prop.Is<std::string>()) {
-                    target = rensys.Get<RenderLayer>(prop.Get<std::string>());
+                    target = rensys.Get<RenderLayer>(Symbol(prop.Get<std::string>()));
                     if(!target) {
                         LOGMSGON(ERROR, rensys) << "Layer not found: " << prop.Get<std::string>();
                         return false;
@@ -505,11 +507,11 @@ void RenderSystem::RenderColorPass(const float *view_matrix, const float *proj_m
         const auto& shader = matgrp.material.GetShader();
         shader->Use();
 
-        glUniformMatrix4fv((*shader)("view"), 1, GL_FALSE, view_matrix);
-        glUniformMatrix4fv((*shader)("projection"), 1, GL_FALSE, proj_matrix);
-        GLint u_model_loc = shader->Uniform("model");
-        GLint u_animatrix_loc = shader->Uniform("animation_matrix");
-        GLint u_animate_loc = shader->Uniform("animated");
+        glUniformMatrix4fv((*shader)("view"_sym), 1, GL_FALSE, view_matrix);
+        glUniformMatrix4fv((*shader)("projection"_sym), 1, GL_FALSE, proj_matrix);
+        GLint u_model_loc = shader->Uniform("model"_sym);
+        GLint u_animatrix_loc = shader->Uniform("animation_matrix"_sym);
+        GLint u_animate_loc = shader->Uniform("animated"_sym);
 
         for (const auto& texgrp : matgrp.texture_groups) {
             // Activate all textures for this texture group.
@@ -569,16 +571,16 @@ void RenderSystem::RenderDepthOnlyPass(const float *view_matrix, const float *pr
         * glm::lookAt(lightpos, lightpos-UP_VECTOR, FORWARD_VECTOR);
     glm::mat4x4 invlight_matrix = glm::inverse(light_matrix);
     CheckGLError();
-    glUniform3f(depthpassshader->Uniform("light_pos"), lightpos.x, lightpos.y, lightpos.z);
-    glUniformMatrix4fv(depthpassshader->Uniform("light_vp"), 1, GL_FALSE, (float*)&light_matrix);
+    glUniform3f(depthpassshader->Uniform("light_pos"_sym), lightpos.x, lightpos.y, lightpos.z);
+    glUniformMatrix4fv(depthpassshader->Uniform("light_vp"_sym), 1, GL_FALSE, (float*)&light_matrix);
     CheckGLError();
     if(light->shadows) {
         light->depthmatrix = light_matrix;
     }
     glDrawBuffer(GL_NONE);
-    GLint u_model_loc = depthpassshader->Uniform("model");
-    GLint u_animatrix_loc = depthpassshader->Uniform("animation_matrix");
-    GLint u_animate_loc = depthpassshader->Uniform("animated");
+    GLint u_model_loc = depthpassshader->Uniform("model"_sym);
+    GLint u_animatrix_loc = depthpassshader->Uniform("animation_matrix"_sym);
+    GLint u_animate_loc = depthpassshader->Uniform("animated"_sym);
     for (auto matgrp : this->material_groups) {
         for (const auto& texgrp : matgrp.texture_groups) {
             // Loop through each renderable group.
@@ -619,19 +621,19 @@ void RenderSystem::RenderLightingPass(const glm::mat4x4 &view_matrix, const floa
     GLint l_sshadow_loc = 0;
     if(lightingshader) {
         lightingshader->Use();
-        l_pos_loc = lightingshader->Uniform("light_pos");
-        l_col_loc = lightingshader->Uniform("light_color");
-        l_dir_loc = lightingshader->Uniform("light_dir");
-        l_type_loc = lightingshader->Uniform("light_type");
-        l_ushadow_loc = lightingshader->Uniform("shadow_enabled");
-        l_tshadow_loc = lightingshader->Uniform("shadow_matrix");
-        l_sshadow_loc = lightingshader->Uniform("shadow_depth");
-        glUniform1i(lightingshader->Uniform("layer0"), 0);
-        glUniform1i(lightingshader->Uniform("layer1"), 1);
-        glUniform1i(lightingshader->Uniform("layer2"), 2);
-        glUniform1i(lightingshader->Uniform("layer3"), 3);
+        l_pos_loc = lightingshader->Uniform("light_pos"_sym);
+        l_col_loc = lightingshader->Uniform("light_color"_sym);
+        l_dir_loc = lightingshader->Uniform("light_dir"_sym);
+        l_type_loc = lightingshader->Uniform("light_type"_sym);
+        l_ushadow_loc = lightingshader->Uniform("shadow_enabled"_sym);
+        l_tshadow_loc = lightingshader->Uniform("shadow_matrix"_sym);
+        l_sshadow_loc = lightingshader->Uniform("shadow_depth"_sym);
+        glUniform1i(lightingshader->Uniform("layer0"_sym), 0);
+        glUniform1i(lightingshader->Uniform("layer1"_sym), 1);
+        glUniform1i(lightingshader->Uniform("layer2"_sym), 2);
+        glUniform1i(lightingshader->Uniform("layer3"_sym), 3);
         if(l_sshadow_loc > 0) glUniform1i(l_sshadow_loc, 4);
-        glUniformMatrix4fv(lightingshader->Uniform("inv_proj"), 1, GL_FALSE, inv_proj_matrix);
+        glUniformMatrix4fv(lightingshader->Uniform("inv_proj"_sym), 1, GL_FALSE, inv_proj_matrix);
     }
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
@@ -649,7 +651,7 @@ void RenderSystem::RenderLightingPass(const glm::mat4x4 &view_matrix, const floa
             if(l_type_loc > 0) glUniform1ui(l_type_loc, activelight->lighttype);
             auto lp_itr = activelight->light_props.begin();
             for(;lp_itr != activelight->light_props.end(); lp_itr++) {
-                GLint uniformloc = lightingshader->Uniform(lp_itr->GetName().c_str());
+                GLint uniformloc = lightingshader->Uniform(lp_itr->GetSymbol());
                 if(uniformloc > 0) {
                     if(lp_itr->Is<float>()) {
                         glUniform1f(uniformloc, lp_itr->Get<float>());
@@ -667,8 +669,8 @@ void RenderSystem::RenderLightingPass(const glm::mat4x4 &view_matrix, const floa
                         glUniform2f(uniformloc, val.x, val.y);
                     }
                 }
-                else if(activelight->shadows && lp_itr->GetName() == "shadow") {
-                    shadowbuf = TrillekGame::GetGraphicSystem().Get<Texture>(lp_itr->Get<std::string>());
+                else if(activelight->shadows && lp_itr->GetSymbol() == "shadow"_sym) {
+                    shadowbuf = TrillekGame::GetGraphicSystem().Get<Texture>(lp_itr->Get<Symbol>());
                     if(shadowbuf) {
                         useshadow = 1 + debugmode;
                         glActiveTexture(GL_TEXTURE4);
@@ -689,14 +691,7 @@ void RenderSystem::RenderLightingPass(const glm::mat4x4 &view_matrix, const floa
     glBindVertexArray(0); CheckGLError();
 }
 
-void RenderSystem::UpdateModelMatrices() {
-    std::map<unsigned int,const Transform*> transforms;
-    try {
-        transforms = *updated_transforms.get();
-    }
-    catch(std::future_error) {
-        LOGMSGC(INFO) << "Render system missed a frame";
-    }
+void RenderSystem::UpdateModelMatrices(const TransformUpdates& transforms) {
     for (auto it = transforms.cbegin(); it != transforms.cend(); ++it) {
         const auto id = it->first;
         const auto transform = it->second;
@@ -717,10 +712,10 @@ void RenderSystem::UpdateModelMatrices() {
 void RenderSystem::RenderPostPass(std::shared_ptr<Shader> postshader) const {
     postshader->Use();
     glBindVertexArray(screenquad.vao); CheckGLError();
-    glUniform1i(postshader->Uniform("layer0"), 0);CheckGLError();
-    glUniform1i(postshader->Uniform("layer1"), 1);CheckGLError();
-    glUniform1i(postshader->Uniform("layer2"), 2);CheckGLError();
-    glUniform1i(postshader->Uniform("layer3"), 3);CheckGLError();
+    glUniform1i(postshader->Uniform("layer0"_sym), 0);CheckGLError();
+    glUniform1i(postshader->Uniform("layer1"_sym), 1);CheckGLError();
+    glUniform1i(postshader->Uniform("layer2"_sym), 2);CheckGLError();
+    glUniform1i(postshader->Uniform("layer3"_sym), 3);CheckGLError();
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);CheckGLError();
     glBindVertexArray(0); CheckGLError();
     Shader::UnUse();
@@ -734,13 +729,13 @@ void RenderSystem::RegisterStaticParsers() {
             if(settingitr->value.IsString()) {
                 std::string settingval = util::MakeString(settingitr->value);
                 if(settingname == "active-graph") {
-                    rensys.activerender = rensys.Get<RenderList>(settingval);
+                    rensys.activerender = rensys.Get<RenderList>(Symbol(settingval));
                 }
                 else if(settingname == "lighting-shader") {
-                    rensys.lightingshader = rensys.Get<Shader>(settingval);
+                    rensys.lightingshader = rensys.Get<Shader>(Symbol(settingval));
                 }
                 else if(settingname == "depth-shader") {
-                    rensys.depthpassshader = rensys.Get<Shader>(settingval);
+                    rensys.depthpassshader = rensys.Get<Shader>(Symbol(settingval));
                 }
             }
         }
@@ -771,7 +766,7 @@ void RenderSystem::SetViewportSize(const unsigned int width, const unsigned int
 }
 
 template<>
-void RenderSystem::Add(const std::string & instancename, std::shared_ptr<Texture> instanceptr) {
+void RenderSystem::Add(Symbol instancename, std::shared_ptr<Texture> instanceptr) {
     unsigned int type_id = reflection::GetTypeID<Texture>();
     if(instanceptr->IsDynamic()) {
         dyn_textures.push_back(instanceptr);
@@ -963,7 +958,8 @@ void RenderSystem::RemoveRenderable(const id_t entity_id) {
 }
 
 void RenderSystem::HandleEvents(const frame_tp& timepoint) {
-    auto now = frame_tp(TrillekGame::GetOS().GetTime());
+    this->keyboard_events.Deliver(this);
+    auto now = TrillekGame::GetScheduler().Now();
     static frame_tp last_tp = now;
     auto delta = now - last_tp;
     if(delta > std::chrono::nanoseconds(66666666ll)) {
@@ -987,12 +983,13 @@ void RenderSystem::HandleEvents(const frame_tp& timepoint) {
             ren.second->GetAnimation()->UpdateAnimation(delta.count() * 1E-9);
         }
     }
-    updated_transforms = TransformMap::GetAsyncUpdatedTransforms().GetFuture(timepoint);
-    if(updated_transforms.valid()) {
-        UpdateModelMatrices();
-    }
-    else {
-        LOGMSGC(INFO) << "HandleEvents() missed the publication of updated transforms";
+    // apply the transforms updated by every tick of the physics since the last frame
+    auto lost = TransformMap::GetAsyncUpdatedTransforms().ReadSince(this->next_transforms,
+        [this] (const AsyncData<TransformUpdates>::Snapshot& updated_transforms) {
+            UpdateModelMatrices(*updated_transforms);
+        });
+    if (lost) {
+        LOGMSGC(WARNING) << "HandleEvents() missed " << lost << " publications of updated transforms";
     }
 };
 
@@ -1,5 +1,7 @@
 #include "systems/lua-system.hpp"
 #include <iostream>
+#include <stdlib.h>
+#include "memory-accounting.hpp"
 
 namespace trillek {
 namespace script {
@@ -7,18 +9,50 @@ namespace script {
 int luaopen_Transform(lua_State*);
 int luaopen_LuaSys(lua_State*);
 
+namespace {
+// The memory of the Lua state, counted for Lua
+void* LuaAllocate(void*, void* ptr, size_t osize, size_t nsize) {
+    // osize is the type of the new object when ptr is null
+    const size_t old_size = ptr ? osize : 0;
+    if (nsize == 0) {
+        if (ptr) {
+            MemoryAccounting::Deallocate(MemoryTag::LUA, old_size);
+            ::free(ptr);
+        }
+        return nullptr;
+    }
+    void* p = ::realloc(ptr, nsize);
+    if (p) {
+        if (ptr) {
+            MemoryAccounting::Deallocate(MemoryTag::LUA, old_size);
+        }
+        MemoryAccounting::Allocate(MemoryTag::LUA, nsize);
+    }
+    return p;
+}
+
+// Same as the panic function of luaL_newstate()
+int LuaPanic(lua_State* L) {
+    std::cerr << "PANIC: unprotected error in call to Lua API (" << lua_tostring(L, -1) << ")" << std::endl;
+    return 0;
+}
+}
+
 LuaSystem::LuaSystem() {
-    event::Dispatcher<KeyboardEvent>::GetInstance()->Subscribe(this);
+    DeclareRead(SystemData::TRANSFORMS);
+    SetTickRate(30);
+    this->keyboard_events.Subscribe();
     this->event_handlers[reflection::GetTypeID<KeyboardEvent>()];
-    event::Dispatcher<MouseBtnEvent>::GetInstance()->Subscribe(this);
+    this->mousebtn_events.Subscribe();
     this->event_handlers[reflection::GetTypeID<MouseBtnEvent>()];
-    event::Dispatcher<MouseMoveEvent>::GetInstance()->Subscribe(this);
+    this->mousemove_events.Subscribe();
     this->event_handlers[reflection::GetTypeID<MouseMoveEvent>()];
 }
 LuaSystem::~LuaSystem() { }
 
 void LuaSystem::Start() {
-    this->L = luaL_newstate();
+    this->L = lua_newstate(LuaAllocate, nullptr);
+    lua_atpanic(L, LuaPanic);
     luaL_openlibs(L);
     RegisterTypes();
 }
@@ -47,8 +81,12 @@ void LuaSystem::HandleEvents(const frame_tp& timepoint) {
     static frame_tp last_tp;
     this->delta = timepoint - last_tp;
     last_tp = timepoint;
-    // Call the Update method from Lua. A time delta is passed in.
     if (this->L) {
+        // Call the script handlers of the input events received since the last frame
+        this->keyboard_events.Deliver(this);
+        this->mousebtn_events.Deliver(this);
+        this->mousemove_events.Deliver(this);
+        // Call the Update method from Lua. A time delta is passed in.
         //lua_getglobal(L, "Update");
         //lua_pushnumber(L, delta.count() * 1.0E-9);
         //lua_pcall(L, 1, 0, 0);
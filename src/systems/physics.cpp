@@ -7,7 +7,11 @@
 namespace trillek {
 namespace physics {
 
-PhysicsSystem::PhysicsSystem() { }
+PhysicsSystem::PhysicsSystem() {
+    DeclareWrite(SystemData::TRANSFORMS);
+    // a late simulation catches up a few steps
+    SetTickRate(120, CatchUpPolicy::CLAMP);
+}
 PhysicsSystem::~PhysicsSystem() { }
 
 void PhysicsSystem::Start() {
@@ -41,8 +45,6 @@ void PhysicsSystem::HandleEvents(const frame_tp& timepoint) {
         shape.second->UpdateMotionState();
     }
 
-    // Remove access to old updated transforms
-    TransformMap::GetAsyncUpdatedTransforms().Unpublish(timepoint);
     // Remove access to forces
     this->async_forces.Unpublish(timepoint);
     // Remove access to torques
@@ -76,9 +78,12 @@ void PhysicsSystem::HandleEvents(const frame_tp& timepoint) {
     for (auto& shape : this->bodies) {
         shape.second->UpdateTransform();
     }
-    // Publish the new updated transforms map
-    auto ntm = std::make_shared<std::map<id_t,const Transform*>>(TransformMap::GetUpdatedTransforms().Poll());
-    TransformMap::GetAsyncUpdatedTransforms().Publish(std::move(ntm));
+    // Publish the updated transforms, in a recycled buffer keeping its capacity
+    auto& async_updated = TransformMap::GetAsyncUpdatedTransforms();
+    auto& updated = async_updated.WriteBuffer();
+    updated.clear();
+    TransformMap::GetUpdatedTransforms().Poll(updated);
+    async_updated.Commit(timepoint);
 }
 
 void PhysicsSystem::Terminate() {
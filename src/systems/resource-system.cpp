@@ -1,4 +1,5 @@
 #include "systems/resource-system.hpp"
+#include "trillek-game.hpp"
 
 namespace trillek {
 namespace resource {
@@ -6,8 +7,15 @@ namespace resource {
 std::once_flag ResourceMap::only_one;
 std::shared_ptr<ResourceMap> ResourceMap::instance = nullptr;
 std::map<std::string, unsigned int> ResourceMap::resource_type_id;
-std::map<std::string, std::function<std::shared_ptr<resource::ResourceBase>(const std::string& name, const std::vector<Property> &properties)>> ResourceMap::factories;
-std::map<unsigned int, std::map<std::string, std::shared_ptr<resource::ResourceBase>>> ResourceMap::resources;
+std::map<std::string, std::function<std::shared_ptr<resource::ResourceBase>(Symbol name, const std::vector<Property> &properties)>> ResourceMap::factories;
+std::map<unsigned int, std::unordered_map<Symbol, std::shared_ptr<resource::ResourceBase>>> ResourceMap::resources;
+std::recursive_mutex ResourceMap::m_resources;
+
+void ResourceMap::QueueLoad(std::function<bool(void)>&& load, std::function<void(bool)>&& done) {
+    TrillekGame::GetScheduler().QueueIO(std::move(load), [done] (std::shared_future<bool> loaded) {
+        done(loaded.get());
+    });
+}
 
 bool ResourceMap::Serialize(rapidjson::Document& document) {
     rapidjson::Value resource_node(rapidjson::kObjectType);
@@ -36,12 +44,12 @@ bool ResourceMap::Parse(rapidjson::Value& node) {
                 // Iterate of the individual resources.
                 for (auto res_itr = type_itr->value.MemberBegin(); res_itr != type_itr->value.MemberEnd(); ++res_itr) {
                     std::vector<Property> props;
-                    std::string resource_name(res_itr->name.GetString(), res_itr->name.GetStringLength());
+                    Symbol resource_name(std::string(res_itr->name.GetString(), res_itr->name.GetStringLength()));
 
                     if (res_itr->value.IsObject()) {
                         // Iterate over the resource's properties.
                         for (auto prop_itr = res_itr->value.MemberBegin(); prop_itr != res_itr->value.MemberEnd(); ++prop_itr) {
-                            std::string property_name(prop_itr->name.GetString(), prop_itr->name.GetStringLength());
+                            Symbol property_name(std::string(prop_itr->name.GetString(), prop_itr->name.GetStringLength()));
 
                             if (prop_itr->value.IsString()) {
                                 std::string property_value(prop_itr->value.GetString(), prop_itr->value.GetStringLength());
@@ -100,23 +100,28 @@ std::shared_ptr<Sound> System::GetSound(const std::string& id) {
 }
 
 void System::HandleEvents(const frame_tp& timepoint) {
-    auto transformfut = TransformMap::GetAsyncUpdatedTransforms().GetFuture(timepoint);
-    if (transformfut.valid()) {
-        // wait for the list to be published
-        auto transformmap = transformfut.get();
-        // assume this is the camera entity id
-        if(transformmap->count(0)) {
-            auto data = transformmap->at(0);
-            const glm::vec3& position = data->GetTranslation();
-            alListener3f(AL_POSITION, position.x, position.y, position.z);
-            const glm::vec3& up = data->GetOrientation() * UP_VECTOR;
-            const glm::vec3& at = data->GetOrientation() * FORWARD_VECTOR;
-            ALfloat orientation[] = {at.x, at.y, at.z, up.x, up.y, up.z};
-            alListenerfv(AL_ORIENTATION, orientation);
-        }
+    // the last update of the camera in the ticks of the physics since the last frame
+    const Transform* data = nullptr;
+    auto lost = TransformMap::GetAsyncUpdatedTransforms().ReadSince(this->next_transforms,
+        [&data] (const AsyncData<TransformUpdates>::Snapshot& transformmap) {
+            for (auto& updated : *transformmap) {
+                // assume this is the camera entity id
+                if (updated.first == 0) {
+                    data = updated.second;
+                    break;
+                }
+            }
+        });
+    if (lost) {
+        LOGMSGC(DEBUG) << "Missed " << lost << " updated transform map publications";
     }
-    else {
-        LOGMSGC(DEBUG) << "Missed the updated transform map publication";
+    if (data) {
+        const glm::vec3& position = data->GetTranslation();
+        alListener3f(AL_POSITION, position.x, position.y, position.z);
+        const glm::vec3& up = data->GetOrientation() * UP_VECTOR;
+        const glm::vec3& at = data->GetOrientation() * FORWARD_VECTOR;
+        ALfloat orientation[] = {at.x, at.y, at.z, up.x, up.y, up.z};
+        alListenerfv(AL_ORIENTATION, orientation);
     }
 }
 
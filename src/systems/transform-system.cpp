@@ -1,5 +1,6 @@
 #include "systems/transform-system.hpp"
 #include "transform.hpp"
+#include "pool-allocator.hpp"
 
 namespace trillek {
 
@@ -16,7 +17,7 @@ std::shared_ptr<Transform> TransformMap::GetTransform(const unsigned int entity_
 
 std::shared_ptr<Transform> TransformMap::AddTransform(const unsigned int entity_id) {
     if (instance->transforms.find(entity_id) == instance->transforms.end()) {
-        std::shared_ptr<Transform> transform = std::make_shared<Transform>(entity_id);
+        std::shared_ptr<Transform> transform = std::allocate_shared<Transform>(PoolAllocator<Transform>(), entity_id);
 
         instance->transforms[entity_id] = transform;
     }
@@ -6,123 +6,270 @@
 #include <functional>
 #include <algorithm>
 
+#include "allocation-tracer.hpp"
+#include "frame-allocator.hpp"
 #include "systems/system-base.hpp"
 #include "trillek-game.hpp"
 
 namespace trillek {
 std::function<void(std::shared_ptr<TaskRequest<chain_t>>&&,frame_unit&&)> TaskRequest<chain_t>::queue_task;
+frame_unit TaskRequest<chain_t>::requeue_delay;
+thread_local unsigned int TrillekScheduler::current_worker = TaskPool::NO_WORKER;
 
-glfw_tp TaskRequestBase::Now() const {
-    return glfw_tp(TrillekGame::GetOS().GetTime());
+namespace {
+/** \brief A task helping a parallel job
+ */
+class ParallelTask : public TaskRequestBase {
+public:
+    // the task is due immediately
+    ParallelTask(const std::shared_ptr<ParallelJob>& job) : TaskRequestBase(frame_tp()), job(job) {};
+
+    void RunTask() override {
+        job->Work();
+    };
+
+private:
+    const std::shared_ptr<ParallelJob> job;
+};
 }
 
+glfw_tp TaskRequestBase::Now() const {
+    return TrillekGame::GetScheduler().Now();
+}
 
 void TrillekScheduler::Initialize(unsigned int nr_thread, std::queue<SystemBase*>& systems) {
     std::list<std::thread> thread_list;
     // initialize
-    frame_tp now = frame_tp(TrillekGame::GetOS().GetTime());
+    frame_tp now = Now();
+    // a suspended chain runs again 1/10 frame later
     TaskRequest<chain_t>::Initialize([&](std::shared_ptr<TaskRequest<chain_t>>&& c, frame_unit&& delay)
                                     {
                                         c->Reschedule(std::move(delay));
                                         Queue(std::move(c));
-                                    });
+                                    }, one_frame / 10);
+    if (pool_mode == TaskPoolMode::WORK_STEALING) {
+        std::unique_ptr<TaskPool> new_pool(new WorkStealingTaskPool(nr_thread));
+        new_pool->SetBackgroundInterval(pool->BackgroundInterval());
+        // move the tasks queued before the threads are launched
+        std::shared_ptr<TaskRequestBase> task;
+        while (pool->Pop(task, TaskPool::NO_WORKER, frame_tp::max())) {
+            new_pool->Push(std::move(task), TaskPool::NO_WORKER, now);
+        }
+        pool = std::move(new_pool);
+    }
+    // a task leaves the pool only with a slot of its class
+    pool->SetAdmission([this](TaskClass task_class) { return concurrency.TryAcquire(task_class); });
+    nr_worker = nr_thread;
+    telemetry.Initialize(nr_thread);
+    for (unsigned int i = 0; i < nr_thread; ++i) {
+        bound_tasks.push_back(std::unique_ptr<AtomicQueue<std::shared_ptr<TaskRequestBase>>>(
+                                new AtomicQueue<std::shared_ptr<TaskRequestBase>>()));
+    }
+    graph.reset(new SystemGraph(
+        [this](std::shared_ptr<TaskRequestBase>&& task, unsigned int worker) {
+            if (worker == TaskPool::NO_WORKER) {
+                Queue(std::move(task));
+            }
+            else {
+                SetReadyTime(*task, Now());
+                bound_tasks[worker]->Push(std::move(task));
+                // we don't know which thread is sleeping
+                WakeUpAll();
+            }
+        },
+        [this]() {
+            // 0 if no frame has begun, StartFrame() also calls us when it gives up
+            const auto begin = frame_begin.exchange(0);
+            if (begin) {
+                telemetry.RecordFrameEnd(SchedulerTelemetry::Now() - frame_tp(frame_unit(begin)),
+                                         clock->RealDuration(one_frame));
+            }
+            // a thread must begin the next frame
+            WakeUp();
+        },
+        [this](const frame_tp& frame, const frame_tp& now) {
+            frame_begin.store(SchedulerTelemetry::Now().time_since_epoch().count());
+            const auto number = frame_number.fetch_add(1, std::memory_order_release) + 1;
+            AllocationTracer::NextFrame();
+            const auto report_frames = memory_report_frames.load(std::memory_order_relaxed);
+            if (report_frames && number % report_frames == 0) {
+                auto out = memory_report_out.load();
+                std::function<void(void)> report = [out]() { MemoryAccounting::Dump(*out); };
+                auto task = std::make_shared<TaskRequest<std::function<void(void)>>>(std::move(report));
+                task->SetClass(TaskClass::BACKGROUND_IO);
+                Queue(std::move(task));
+            }
+            telemetry.RecordFrameStart(now - frame, pool->Size());
+        }));
+    graph->Build(systems, nr_thread, now, one_frame);
     // prepare threads
     for (unsigned int i = 0; i < nr_thread; ++i) {
-        SystemBase* sys = nullptr;
-        if (! systems.empty()) {
-            sys = systems.front();
-            systems.pop();
-        }
-        auto f = std::bind(&TrillekScheduler::DayWork, std::ref(*this), now, sys);
+        auto f = std::bind(&TrillekScheduler::DayWork, std::ref(*this), i);
         thread_list.push_back(std::thread(std::move(f)));
     }
     // run threads and block
     for (auto& t : thread_list) {
         t.join();
     }
+    // finish the loading in progress
+    io_lane.Stop();
 }
 
-void TrillekScheduler::DayWork(const frame_tp& now, SystemBase* system) {
-    frame_tp next_frame_tp = now + one_frame;
-
-    std::function<void(const frame_tp&)> handleEvents_functor;
-    std::function<void(void)> runBatch_functor;
-    std::function<void(void)> terminate_functor;
-    if (system) {
-        handleEvents_functor = std::bind(&SystemBase::HandleEvents, std::ref(*system), std::placeholders::_1);
-        runBatch_functor = std::bind(&SystemBase::RunBatch, std::cref(*system));
-        terminate_functor = std::bind(&SystemBase::Terminate, std::ref(*system));
-        system->ThreadInit();
-    } else {
-        handleEvents_functor = [](const frame_tp& timepoint) {};
-        runBatch_functor = [] () {};
-        terminate_functor = [] () {};
+void TrillekScheduler::PushBatch(std::vector<std::shared_ptr<TaskRequestBase>>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    const auto now = Now();
+    for (auto& task : tasks) {
+        SetReadyTime(*task, now);
     }
+    pool->PushBatch(tasks, current_worker, now);
+    WakeUp(tasks.size());
+}
 
-    while (1) {
-        std::shared_ptr<TaskRequestBase> task;
+void TrillekScheduler::RunParallel(const std::shared_ptr<ParallelJob>& job) {
+    // one helper per chunk at most, the calling thread takes one
+    const size_t helpers = std::min<size_t>(Participants() - 1,
+                                            job->MaxChunks() > 1 ? job->MaxChunks() - 1 : 0);
+    for (size_t i = 0; i < helpers; ++i) {
+        Queue(std::make_shared<ParallelTask>(job));
+    }
+    job->Work();
+    // the remaining chunks are running in other threads
+    job->Wait();
+}
 
-        {
-            // Wait for a task to do
-            // a lock to watch the blocking point
-            std::unique_lock<std::mutex> locker(m_timer);
-            // lock the queue while checking it
-            m_queue.lock();
-            while (taskqueue.empty()
-                   || ! taskqueue.top()->IsNow()
-                   || frame_tp(TrillekGame::GetOS().GetTime()) >= next_frame_tp) {
-                const auto max_timepoint = taskqueue.empty() ? next_frame_tp :
-                                                            std::min(next_frame_tp, taskqueue.top()->Timepoint());
-                // unlock the queue when checking is done
-                m_queue.unlock();
+void TrillekScheduler::Sleep(unsigned int worker) {
+    std::unique_lock<std::mutex> locker(m_sleep);
+    // register as sleeper before checking the pool, so that a thread queuing
+    // a task after the check sees us and waits for the mutex to notify us
+    sleepers.fetch_add(1);
+    if (bound_tasks[worker]->Empty() && ! TrillekGame::GetTerminateFlag()) {
+        const auto now = Now();
+        // while a frame is running, the thread finishing it wakes us up
+        const auto frame_timepoint = graph->Idle() ? graph->NextFrame() : frame_tp::max();
+        const auto max_timepoint = std::min(frame_timepoint, pool->NextTimepoint());
+        if (! (now < max_timepoint)) {
+            // something to do already
+        }
+        else if (clock->Virtual()) {
+            if (sleepers.load() == nr_worker.load() && max_timepoint != frame_tp::max()) {
+                // all the threads are idle : jump to the next thing to do
+                clock->AdvanceTo(max_timepoint);
+                queuecheck.notify_all();
+            }
+            else {
                 // threads wait here (blocking point)
-                if (queuecheck.wait_until(locker, max_timepoint) == std::cv_status::timeout) {
-                    // we are here because we reached a timeout
-                    // release the lock of the blocking point
-                    m_timer.unlock();
-                    if (TrillekGame::GetTerminateFlag()) {
-                        // unblock all other threads waiting above
-                        queuecheck.notify_all();
-                        // save the state of the system
-                        terminate_functor();
-                        // lock the mutex before exiting the block
-                        m_timer.lock();
-                        return;
-                    }
-                    if (frame_tp(TrillekGame::GetOS().GetTime()) >= next_frame_tp) {
-                        // a new frame has begun : let's run the system
-                        handleEvents_functor(next_frame_tp);
-                        runBatch_functor();
-                        next_frame_tp += one_frame;
-                    }
-                    // reacquire the lock of the blocking point
-                    m_timer.lock();
-                }
-                // we arrive directly here if a new task has been queued
-                // relock the queue before checking it
-                m_queue.lock();
+                queuecheck.wait(locker);
             }
         }
-        // Get the task to do
-        task = taskqueue.top();
-        taskqueue.pop();
-        m_queue.unlock();
-
-        {
-            std::unique_lock<std::mutex> locker(m_count);
-            while(counter >= MAX_CONCURRENT_THREAD) {
-                // Wait the counter to be under MAX_CONCURRENT_THREAD
-                countercheck.wait(locker, [&](){return counter < MAX_CONCURRENT_THREAD;});
+        else if (max_timepoint == frame_tp::max()) {
+            // threads wait here (blocking point)
+            queuecheck.wait(locker);
+        }
+        else {
+            // threads wait here (blocking point)
+            queuecheck.wait_for(locker, clock->RealDuration(max_timepoint - now));
+        }
+    }
+    sleepers.fetch_sub(1);
+}
+
+void TrillekScheduler::WakeUp() {
+    if (sleepers.load()) {
+        // wait for the sleeping thread to be blocked
+        { std::lock_guard<std::mutex> locker(m_sleep); }
+        queuecheck.notify_one();
+    }
+}
+
+void TrillekScheduler::WakeUp(size_t count) {
+    const size_t nr_sleeper = sleepers.load();
+    if (nr_sleeper) {
+        // wait for the sleeping threads to be blocked
+        { std::lock_guard<std::mutex> locker(m_sleep); }
+        if (count >= nr_sleeper) {
+            queuecheck.notify_all();
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            queuecheck.notify_one();
+        }
+    }
+}
+
+void TrillekScheduler::WakeUpAll() {
+    if (sleepers.load()) {
+        // wait for the sleeping threads to be blocked
+        { std::lock_guard<std::mutex> locker(m_sleep); }
+        queuecheck.notify_all();
+    }
+}
+
+void TrillekScheduler::DayWork(unsigned int worker) {
+    current_worker = worker;
+    graph->ThreadInit(worker);
+    // the temporaries of the tasks of a frame are released with the frame
+    auto& arena = FrameArena::Local();
+    arena.SetManaged(true);
+    uint64_t arena_frame = frame_number.load(std::memory_order_acquire);
+
+    while (1) {
+        if (TrillekGame::GetTerminateFlag()) {
+            // no frame can begin once the graph is stopped, so that no system
+            // is queued on a thread that has left
+            if (graph->Stop()) {
+                // unblock all other threads waiting
+                {
+                    std::lock_guard<std::mutex> locker(m_sleep);
+                    queuecheck.notify_all();
+                }
+                // save the state of the systems
+                graph->Terminate(worker);
+                return;
             }
-            // increment counter when possible
-            counter.fetch_add(1, std::memory_order::memory_order_relaxed);
+            // the systems of the current frame must finish first
+        }
+        else if (graph->StartFrame(Now())) {
+            // a new frame has begun : the systems are queued
+            continue;
         }
 
+        // Get the task to do, the tasks bound to this thread first.
+        // The systems bound to a thread are not limited, a task of the pool
+        // is only handed out with a slot of its class
+        std::shared_ptr<TaskRequestBase> task;
+        const bool bound = bound_tasks[worker]->Pop(task);
+        if (! bound && ! pool->Pop(task, worker, Now())) {
+            // Wait for a task to do
+            const auto idle_begin = SchedulerTelemetry::Now();
+            Sleep(worker);
+            telemetry.RecordIdle(worker, SchedulerTelemetry::Now() - idle_begin);
+            continue;
+        }
+        const auto task_class = task->Class();
+
+        // the first task of this thread in a new frame releases the temporaries of the previous ones
+        const auto frame = frame_number.load(std::memory_order_acquire);
+        if (frame != arena_frame) {
+            arena_frame = frame;
+            arena.Reset();
+        }
+
+        // read before running, a chain task can be queued again while it runs
+        const auto ready = task->ReadyTime();
+        const auto start = SchedulerTelemetry::Now();
         task->RunTask();
+        const auto end = SchedulerTelemetry::Now();
+        telemetry.RecordTask(worker, start - ready, end - start);
 
-        // decrement counter
-        counter.fetch_sub(1, std::memory_order::memory_order_relaxed);
-        countercheck.notify_all();
+        if (! bound) {
+            concurrency.Release(task_class);
+            if (pool->Readmit()) {
+                // a task refused for lack of slot can run now
+                WakeUp();
+            }
+        }
     }
 }
 }
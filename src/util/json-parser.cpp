@@ -22,10 +22,10 @@ JSONPasrser::JSONPasrser() {
 
 bool JSONPasrser::Parse(const std::string& fname) {
     std::vector<Property> props;
-    Property p("filename", fname);
+    Property p("filename"_sym, fname);
     props.push_back(p);
 
-    auto file = resource::ResourceMap::Create<resource::TextFile>(fname, props);
+    auto file = resource::ResourceMap::Create<resource::TextFile>(Symbol(fname), props);
 
     if (!file) {
         // TODO: Use logger
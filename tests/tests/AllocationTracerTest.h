@@ -0,0 +1,89 @@
+#ifndef ALLOCATIONTRACERTEST_H_INCLUDED
+#define ALLOCATIONTRACERTEST_H_INCLUDED
+
+#include <cstdio>
+#include <string>
+#include "allocation-tracer.hpp"
+#include "memory-accounting.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// one call site
+static void TracedAllocations(unsigned int count, size_t size) {
+    for (unsigned int i = 0; i < count; ++i) {
+        MemoryAccounting::Allocate(MemoryTag::GENERAL, size);
+        MemoryAccounting::Deallocate(MemoryTag::GENERAL, size);
+    }
+}
+
+// one call site of the global operator new
+static void NewAllocations(unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+        // volatile: the pair of new and delete must not be optimized away
+        char* volatile p = new char[24];
+        delete[] p;
+    }
+}
+
+static const AllocationTracer::Site* FindSite(const std::vector<AllocationTracer::Site>& sites,
+                                              uint64_t count, uint64_t bytes) {
+    for (auto& site : sites) {
+        if (site.count == count && site.bytes == bytes) {
+            return &site;
+        }
+    }
+    return nullptr;
+}
+
+TEST(AllocationTracerTest, Sites) {
+    const bool was_enabled = AllocationTracer::Enabled();
+    AllocationTracer::Clear();
+    AllocationTracer::Enable(1);
+    for (int frame = 0; frame < 3; ++frame) {
+        if (frame == 2) {
+            AllocationTracer::Disable();
+        }
+        TracedAllocations(10, 100);
+        AllocationTracer::NextFrame();
+    }
+    auto sites = AllocationTracer::Sites();
+    ASSERT_FALSE(sites.empty()) << "No site recorded";
+    ASSERT_NE(nullptr, FindSite(sites, 20, 2000)) << "Allocations of the site not counted";
+
+    // operator new is traced only when enabled
+    AllocationTracer::Clear();
+    NewAllocations(8);
+    ASSERT_EQ(nullptr, FindSite(AllocationTracer::Sites(), 8, 192)) << "Allocations traced while disabled";
+    AllocationTracer::Enable(1);
+    NewAllocations(8);
+    AllocationTracer::Disable();
+    ASSERT_NE(nullptr, FindSite(AllocationTracer::Sites(), 8, 192)) << "operator new not traced";
+
+    // one stack recorded every 4 allocations
+    AllocationTracer::Clear();
+    AllocationTracer::Enable(4);
+    TracedAllocations(40, 16);
+    AllocationTracer::Disable();
+    sites = AllocationTracer::Sites();
+    ASSERT_NE(nullptr, FindSite(sites, 40, 640)) << "Sampled allocations not counted";
+
+    std::FILE* out = std::tmpfile();
+    ASSERT_NE(nullptr, out);
+    AllocationTracer::Report(out, 5);
+    std::rewind(out);
+    char line[256] = {0};
+    ASSERT_NE(nullptr, std::fgets(line, sizeof(line), out));
+    ASSERT_EQ(0u, std::string(line).find("allocation trace: 40 allocations, 640 bytes")) << line;
+    std::fclose(out);
+
+    AllocationTracer::Clear();
+    if (was_enabled) {
+        AllocationTracer::Enable(1);
+    }
+}
+
+} // End of trillek
+
+#endif // ALLOCATIONTRACERTEST_H_INCLUDED
@@ -0,0 +1,185 @@
+#ifndef ASYNCDATATEST_H_INCLUDED
+#define ASYNCDATATEST_H_INCLUDED
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "systems/async-data.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(AsyncDataTest, Commit) {
+    AsyncData<std::vector<int>> data;
+    ASSERT_FALSE(data.Latest()) << "Data available before the first commit";
+
+    data.WriteBuffer().assign(3, 1);
+    data.Commit(frame_tp(frame_unit(10)));
+    auto snapshot = data.Latest();
+    ASSERT_TRUE(snapshot) << "Committed data not available";
+    ASSERT_EQ(frame_tp(frame_unit(10)), snapshot.Frame()) << "Wrong frame";
+    ASSERT_EQ(std::vector<int>(3, 1), *snapshot) << "Wrong data";
+    ASSERT_NE(&*snapshot, &data.WriteBuffer()) << "The writer writes in the latest buffer";
+
+    // the snapshot is not rewritten by the next frames
+    for (int frame = 2; frame < 10; ++frame) {
+        data.WriteBuffer().assign(3, frame);
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+        ASSERT_NE(&*snapshot, &data.WriteBuffer()) << "The writer writes in a buffer being read";
+    }
+    ASSERT_EQ(std::vector<int>(3, 1), *snapshot) << "Snapshot rewritten";
+    ASSERT_EQ(std::vector<int>(3, 9), *data.Latest()) << "Latest data not returned";
+}
+
+TEST(AsyncDataTest, WaitFor) {
+    AsyncData<int> data;
+    auto snapshot = data.WaitFor(frame_tp(frame_unit(10)), std::chrono::milliseconds(1));
+    ASSERT_FALSE(snapshot) << "Data returned on timeout";
+
+    std::thread writer([&data]() {
+        for (int frame = 1; frame <= 5; ++frame) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            data.WriteBuffer() = frame;
+            data.Commit(frame_tp(frame_unit(frame * 10)));
+        }
+    });
+    snapshot = data.WaitFor(frame_tp(frame_unit(30)), std::chrono::seconds(5));
+    ASSERT_TRUE(snapshot) << "Data of the frame not returned";
+    ASSERT_LE(frame_tp(frame_unit(30)), snapshot.Frame()) << "Data of an older frame returned";
+    ASSERT_LE(3, *snapshot) << "Wrong data";
+    writer.join();
+    ASSERT_EQ(5, *data.WaitFor(frame_tp(frame_unit(10)), frame_unit(0))) << "Latest data not returned";
+}
+
+TEST(AsyncDataTest, Readers) {
+    // 2 readers need 4 buffers so that the writer never waits
+    AsyncData<std::vector<uint32_t>> data(4);
+    const uint32_t nr_frame = 5000;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0), late(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.push_back(std::thread([&]() {
+            frame_tp last;
+            while (! done.load()) {
+                auto snapshot = data.Latest();
+                if (! snapshot) {
+                    continue;
+                }
+                const auto& v = *snapshot;
+                for (auto e : v) {
+                    if (e != v.front()) {
+                        torn.fetch_add(1);
+                    }
+                }
+                if (snapshot.Frame() < last) {
+                    late.fetch_add(1);
+                }
+                last = snapshot.Frame();
+            }
+        }));
+    }
+    for (uint32_t frame = 1; frame <= nr_frame; ++frame) {
+        data.WriteBuffer().assign(16, frame);
+        data.Commit(frame_tp(frame_unit(frame)));
+        if (! (frame % 64)) {
+            // let the readers run on a single core
+            std::this_thread::yield();
+        }
+    }
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    ASSERT_EQ(0, torn.load()) << "Readers saw a buffer being written";
+    ASSERT_EQ(0, late.load()) << "Readers went back in time";
+    ASSERT_EQ(nr_frame, data.Latest()->front()) << "Wrong latest data";
+}
+
+TEST(AsyncDataTest, History) {
+    // 3 frames kept, 2 snapshots held and the buffer of the writer
+    AsyncData<int> data(6, 3);
+    AsyncData<int>::Snapshot before, after;
+    ASSERT_FALSE(data.Closest(frame_tp(frame_unit(10)))) << "Data available before the first commit";
+    ASSERT_FALSE(data.Around(frame_tp(frame_unit(10)), before, after)) << "Data available before the first commit";
+    for (int frame = 1; frame <= 5; ++frame) {
+        data.WriteBuffer() = frame;
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+    }
+    ASSERT_EQ(5, *data.Previous(0)) << "Wrong latest data";
+    ASSERT_EQ(3, *data.Previous(2)) << "Wrong older data";
+    ASSERT_FALSE(data.Previous(3)) << "Data not kept returned";
+    ASSERT_EQ(4, *data.Closest(frame_tp(frame_unit(42)))) << "Wrong closest data";
+    ASSERT_EQ(3, *data.Closest(frame_tp(frame_unit(0)))) << "Oldest data kept not returned for a late reader";
+
+    ASSERT_TRUE(data.Around(frame_tp(frame_unit(35)), before, after)) << "Frames around not found";
+    ASSERT_EQ(3, *before) << "Wrong frame before";
+    ASSERT_EQ(4, *after) << "Wrong frame after";
+    ASSERT_FALSE(data.Around(frame_tp(frame_unit(60)), before, after)) << "Frame after the last commit found";
+    ASSERT_EQ(5, *before) << "Wrong frame before";
+
+    // the kept frames and the snapshots are not rewritten
+    auto held = data.Previous(2);
+    for (int frame = 6; frame <= 20; ++frame) {
+        auto& buffer = data.WriteBuffer();
+        ASSERT_NE(&*held, &buffer) << "The writer writes in a buffer being read";
+        ASSERT_NE(&*before, &buffer) << "The writer writes in a buffer being read";
+        ASSERT_NE(&*data.Previous(1), &buffer) << "The writer writes in a kept buffer";
+        buffer = frame;
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+    }
+    ASSERT_EQ(3, *held) << "Snapshot rewritten";
+    ASSERT_EQ(18, *data.Previous(2)) << "Wrong older data";
+}
+
+TEST(AsyncDataTest, ReadSince) {
+    // a reader running every 2 or 4 commits of the writer
+    AsyncData<int> data(6, 4);
+    uint64_t next = 0;
+    std::vector<int> read;
+    auto reader = [&read] (const AsyncData<int>::Snapshot& snapshot) { read.push_back(*snapshot); };
+    ASSERT_EQ(0u, data.ReadSince(next, reader)) << "Commits lost before the first commit";
+    ASSERT_TRUE(read.empty()) << "Data read before the first commit";
+    for (int frame = 1; frame <= 2; ++frame) {
+        data.WriteBuffer() = frame;
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+    }
+    ASSERT_EQ(0u, data.ReadSince(next, reader)) << "Commits lost";
+    ASSERT_EQ(std::vector<int>({1, 2}), read) << "Wrong commits read";
+    for (int frame = 3; frame <= 6; ++frame) {
+        data.WriteBuffer() = frame;
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+    }
+    ASSERT_EQ(0u, data.ReadSince(next, reader)) << "Commits lost";
+    ASSERT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6}), read) << "Commit read twice or missed";
+    ASSERT_EQ(0u, data.ReadSince(next, reader)) << "Commits lost";
+    ASSERT_EQ(6u, read.size()) << "Commit read twice";
+
+    // the commits out of the history are reported
+    for (int frame = 7; frame <= 12; ++frame) {
+        data.WriteBuffer() = frame;
+        data.Commit(frame_tp(frame_unit(frame * 10)));
+    }
+    ASSERT_EQ(2u, data.ReadSince(next, reader)) << "Commits lost not reported";
+    ASSERT_EQ(std::vector<int>({1, 2, 3, 4, 5, 6, 9, 10, 11, 12}), read) << "Wrong commits read";
+}
+
+TEST(AsyncDataTest, LateFuture) {
+    AsyncData<int> data(3, 2);
+    ASSERT_TRUE(data.GetFuture(frame_tp(frame_unit(0))).valid()) << "Future of the current frame not valid";
+    data.Unpublish(frame_tp(frame_unit(10)));
+    ASSERT_FALSE(data.GetFuture(frame_tp(frame_unit(5))).valid()) << "Late future valid without any publication";
+    for (int frame = 1; frame <= 3; ++frame) {
+        data.Unpublish(frame_tp(frame_unit(frame * 10)));
+        data.Publish(std::make_shared<const int>(frame));
+    }
+    ASSERT_EQ(3, *data.GetFuture(frame_tp(frame_unit(30))).get()) << "Wrong current data";
+    auto late = data.GetFuture(frame_tp(frame_unit(19)));
+    ASSERT_TRUE(late.valid()) << "Late reader gets no data";
+    ASSERT_EQ(2, *late.get()) << "Late reader does not get the closest frame";
+}
+
+} // namespace trillek
+
+#endif // ASYNCDATATEST_H_INCLUDED
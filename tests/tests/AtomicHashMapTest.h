@@ -0,0 +1,119 @@
+#ifndef ATOMICHASHMAPTEST_H_INCLUDED
+#define ATOMICHASHMAPTEST_H_INCLUDED
+
+#include "atomic-hash-map.hpp"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class AtomicHashMapTest: public ::testing::Test {
+public:
+    AtomicHashMapTest() {};
+protected:
+    trillek::AtomicHashMap<std::string, int> q;
+};
+
+using trillek::AtomicHashMap;
+
+namespace trillek {
+TEST_F(AtomicHashMapTest, AtomicHashMapEmpty) {
+    ASSERT_EQ(q.Count("a"), 0) << "New map is not empty";
+    int i = 0;
+    ASSERT_FALSE(q.Pop("a", i)) << "New map can pop inexisting element";
+    ASSERT_EQ(i, 0) << "New map popped  an element";
+    ASSERT_FALSE(q.Compare("a", 1)) << "Comparison in empty map should return false";
+    EXPECT_THROW(i = q.At("a"), std::out_of_range);
+    ASSERT_TRUE(q.Poll().empty()) << "New polled map gives elements";
+}
+
+TEST_F(AtomicHashMapTest, AtomicHashMapOneElement) {
+    std::string k = "a";
+    int i = 1;
+    q.Insert(k, i);
+    ASSERT_EQ(k, "a") << "Insert moved lvalue key";
+    ASSERT_EQ(i, 1) << "Insert moved lvalue value";
+    ASSERT_EQ(q.Count(k), 1) << "Map is empty";
+    EXPECT_NO_THROW(i = q.At("a")) << "At throws an exception";
+    ASSERT_EQ(i, 1) << "At should return 1";
+    ASSERT_TRUE(q.Compare("a", 1)) << "Compare should return true";
+    ASSERT_FALSE(q.Compare("a", 2)) << "Compare should return false";
+    q.Insert("a", 3);
+    ASSERT_EQ(q.Size(), 1) << "Insert of an existing key added an element";
+    i = 0;
+    ASSERT_TRUE(q.Pop("a", i)) << "Map can't pop existing element";
+    ASSERT_EQ(i, 3) << "Map popped  wrong value";
+    ASSERT_EQ(q.Count(k), 0) << "Map is not empty";
+    EXPECT_THROW(i = q.At("a"), std::out_of_range) << "At does not throw when it should";
+}
+
+TEST_F(AtomicHashMapTest, AtomicHashMapErase) {
+    q.Insert("a", 1);
+    q.Erase("a");
+    ASSERT_EQ(q.Count("a"), 0) << "Map is not empty";
+}
+
+TEST(AtomicHashMapShards, AtomicHashMapGrowth) {
+    AtomicHashMap<uint32_t, uint32_t> map(4);
+    ASSERT_EQ(4, map.Shards()) << "Wrong number of shards";
+    for (uint32_t i = 0; i < 1000; ++i) {
+        map.Insert(i, i * 2);
+    }
+    // leave erased slots in the probe sequences
+    for (uint32_t i = 0; i < 1000; i += 2) {
+        map.Erase(i);
+    }
+    ASSERT_EQ(500, map.Size()) << "Wrong number of elements";
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i % 2, map.Count(i)) << "Wrong count of key " << i;
+    }
+    ASSERT_TRUE(map.Compare(999, 1998)) << "Element lost while growing";
+    // the erased slots are reused
+    for (uint32_t round = 0; round < 10; ++round) {
+        for (uint32_t i = 0; i < 1000; i += 2) {
+            map.Insert(i, round);
+        }
+        for (uint32_t i = 0; i < 1000; i += 2) {
+            map.Erase(i);
+        }
+    }
+    ASSERT_EQ(500, map.Size()) << "Wrong number of elements after reusing slots";
+
+    auto content = map.Poll();
+    ASSERT_EQ(500, content.size()) << "Poll does not return all elements";
+    ASSERT_EQ(2, content.at(1)) << "Poll returns a wrong value";
+    ASSERT_EQ(0, map.Size()) << "Map is not empty after Poll";
+    ASSERT_EQ(0, map.Count(1)) << "Polled element still in the map";
+    map.Insert(1, 5);
+    ASSERT_TRUE(map.Compare(1, 5)) << "Element not inserted after Poll";
+
+    AtomicHashMap<uint32_t, uint32_t> copy(map);
+    ASSERT_TRUE(copy.Compare(1, 5)) << "Element not copied";
+    copy.Insert(2, 6);
+    ASSERT_EQ(0, map.Count(2)) << "Copy shares the content";
+}
+
+TEST(AtomicHashMapShards, AtomicHashMapThreads) {
+    AtomicHashMap<uint32_t, uint32_t> map;
+    const uint32_t per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&map, t, per_thread]() {
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                map.Insert(t * per_thread + i, t);
+            }
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto content = map.Poll();
+    ASSERT_EQ(4 * per_thread, content.size()) << "Elements lost";
+    for (uint32_t t = 0; t < 4; ++t) {
+        ASSERT_EQ(t, content.at(t * per_thread + per_thread - 1)) << "Wrong value";
+    }
+}
+}
+#endif // ATOMICHASHMAPTEST_H_INCLUDED
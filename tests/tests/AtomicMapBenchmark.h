@@ -0,0 +1,131 @@
+#ifndef ATOMICMAPBENCHMARK_H_INCLUDED
+#define ATOMICMAPBENCHMARK_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "atomic-map.hpp"
+#include "atomic-hash-map.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+/** \brief Insert nr_entity keys per frame from nr_writer threads, polled by the main thread
+ *
+ * This is the pattern of the transforms marked as modified by the systems.
+ *
+ * \param insert_cost double& the time per insertion in ns
+ * \param poll_cost double& the time per polled element in ns
+ */
+template<class Map>
+static void MapContention(const Map& map, unsigned int nr_writer, uint32_t nr_entity, unsigned int nr_frame,
+                          double& insert_cost, double& poll_cost) {
+    const uint32_t per_writer = nr_entity / nr_writer;
+    size_t polled = 0;
+    std::chrono::duration<double, std::nano> insert_time(0), poll_time(0);
+    for (unsigned int frame = 0; frame < nr_frame; ++frame) {
+        std::atomic<unsigned int> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> writers;
+        for (unsigned int w = 0; w < nr_writer; ++w) {
+            writers.push_back(std::thread([&map, &ready, &go, w, per_writer, frame]() {
+                ready.fetch_add(1);
+                while (! go.load()) {
+                    std::this_thread::yield();
+                }
+                // each entity is modified several times in a frame
+                for (uint32_t n = 0; n < 4; ++n) {
+                    for (uint32_t i = 0; i < per_writer; ++i) {
+                        map.Insert(w * per_writer + i, frame);
+                    }
+                }
+            }));
+        }
+        while (ready.load() < nr_writer) {
+            std::this_thread::yield();
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true);
+        for (auto& t : writers) {
+            t.join();
+        }
+        auto inserted = std::chrono::steady_clock::now();
+        polled += map.Poll().size();
+        insert_time += inserted - start;
+        poll_time += std::chrono::steady_clock::now() - inserted;
+    }
+    EXPECT_EQ(static_cast<size_t>(per_writer) * nr_writer * nr_frame, polled) << "Elements lost";
+    insert_cost = insert_time.count() / (4.0 * per_writer * nr_writer * nr_frame);
+    poll_cost = poll_time.count() / polled;
+}
+
+TEST(AtomicMapBenchmark, DISABLED_Writers) {
+    const uint32_t nr_entity = 8192;
+    const unsigned int nr_frame = 20;
+    for (unsigned int nr_writer : {1, 2, 4, 8}) {
+        AtomicMap<uint32_t, uint32_t> tree_map;
+        AtomicHashMap<uint32_t, uint32_t> hash_map;
+        double tree_insert, tree_poll, hash_insert, hash_poll;
+        MapContention(tree_map, nr_writer, nr_entity, nr_frame, tree_insert, tree_poll);
+        MapContention(hash_map, nr_writer, nr_entity, nr_frame, hash_insert, hash_poll);
+        std::cout << "[ BENCH    ] " << nr_writer << " writers, " << nr_entity
+                  << " entities: std::map and mutex " << tree_insert << " ns/insert, "
+                  << tree_poll << " ns/polled, sharded hash map " << hash_insert << " ns/insert, "
+                  << hash_poll << " ns/polled" << std::endl;
+    }
+}
+
+/** \brief Insert nr_entity keys then poll them, once per frame, from one thread
+ *
+ * This is the cycle of a physics tick publishing the transforms it updated.
+ *
+ * \param poll the function polling the map
+ * \return double the time per frame in ns
+ */
+template<class Map, class Poll>
+static double WriteThenPoll(const Map& map, uint32_t nr_entity, unsigned int nr_frame, Poll poll) {
+    size_t polled = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < nr_frame; ++frame) {
+        for (uint32_t i = 0; i < nr_entity; ++i) {
+            map.Insert(i, frame);
+        }
+        polled += poll(map);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(static_cast<size_t>(nr_entity) * nr_frame, polled) << "Elements lost";
+    return elapsed.count() / nr_frame;
+}
+
+TEST(AtomicMapBenchmark, DISABLED_WriteThenPoll) {
+    const unsigned int nr_frame = 100000;
+    for (uint32_t nr_entity : {1, 16, 256}) {
+        AtomicMap<uint32_t, uint32_t> tree_map;
+        AtomicHashMap<uint32_t, uint32_t> hash_map;
+        // the buffer reused at each frame, as the recycled buffers of AsyncData
+        std::vector<std::pair<uint32_t, uint32_t>> buffer;
+        const double tree = WriteThenPoll(tree_map, nr_entity, nr_frame / nr_entity,
+            [](const AtomicMap<uint32_t, uint32_t>& m) { return m.Poll().size(); });
+        const double hash_tree = WriteThenPoll(hash_map, nr_entity, nr_frame / nr_entity,
+            [](const AtomicHashMap<uint32_t, uint32_t>& m) { return m.Poll().size(); });
+        const double hash_vector = WriteThenPoll(hash_map, nr_entity, nr_frame / nr_entity,
+            [&buffer](const AtomicHashMap<uint32_t, uint32_t>& m) {
+                buffer.clear();
+                m.Poll(buffer);
+                return buffer.size();
+            });
+        std::cout << "[ BENCH    ] " << nr_entity << " entities written then polled per frame: std::map and mutex "
+                  << tree << " ns, sharded hash map to std::map " << hash_tree
+                  << " ns, sharded hash map to reused vector " << hash_vector << " ns per frame" << std::endl;
+    }
+}
+
+} // namespace benchmark
+} // namespace trillek
+
+#endif // ATOMICMAPBENCHMARK_H_INCLUDED
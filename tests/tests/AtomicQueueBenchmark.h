@@ -0,0 +1,122 @@
+#ifndef ATOMICQUEUEBENCHMARK_H_INCLUDED
+#define ATOMICQUEUEBENCHMARK_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "atomic-queue.hpp"
+#include "atomic-ring-queue.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+/** \brief Push nr_element elements from nr_producer threads, popped by one consumer thread
+ *
+ * This is the pattern of the input and network events.
+ *
+ * \return double the number of elements going through the queue per second
+ */
+template<class Queue>
+static double QueueThroughput(const Queue& q, unsigned int nr_producer, uint64_t nr_element) {
+    const uint64_t per_producer = nr_element / nr_producer;
+    const uint64_t total = per_producer * nr_producer;
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (unsigned int p = 0; p < nr_producer; ++p) {
+        producers.push_back(std::thread([&q, per_producer]() {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                q.Push(i);
+            }
+        }));
+    }
+    uint64_t element;
+    for (uint64_t popped = 0; popped < total; ) {
+        if (q.Pop(element)) {
+            sum += element;
+            ++popped;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(nr_producer * per_producer * (per_producer - 1) / 2, sum) << "Elements lost";
+    return total / elapsed.count();
+}
+
+TEST(AtomicQueueBenchmark, DISABLED_Producers) {
+    const uint64_t nr_element = 320000;
+    for (unsigned int nr_producer : {1, 2, 4, 8, 16, 32}) {
+        AtomicQueue<uint64_t> list_queue;
+        AtomicRingQueue<uint64_t> ring_queue(4096);
+        double list_tput = QueueThroughput(list_queue, nr_producer, nr_element);
+        double ring_tput = QueueThroughput(ring_queue, nr_producer, nr_element);
+        std::cout << "[ BENCH    ] " << nr_producer << " producers: list and mutex "
+                  << static_cast<long>(list_tput) << " elements/s, MPMC ring "
+                  << static_cast<long>(ring_tput) << " elements/s";
+        if (nr_producer == 1) {
+            AtomicRingQueue<uint64_t, RingAccess::SPSC> spsc_queue(4096);
+            std::cout << ", SPSC ring " << static_cast<long>(QueueThroughput(spsc_queue, 1, nr_element))
+                      << " elements/s";
+        }
+        std::cout << std::endl;
+    }
+}
+
+/** \brief Push nr_element elements and drain them, nr_frame times
+ *
+ * This is the pattern of the per-frame event drain of the systems.
+ *
+ * \return double the time per element in ns
+ */
+template<class Drain>
+static double FrameDrain(const AtomicQueue<uint64_t>& q, uint64_t nr_frame, uint64_t nr_element, Drain&& drain) {
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t frame = 0; frame < nr_frame; ++frame) {
+        for (uint64_t i = 0; i < nr_element; ++i) {
+            q.Push(i);
+        }
+        sum += drain(q);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(nr_frame * nr_element * (nr_element - 1) / 2, sum) << "Elements lost";
+    return elapsed.count() / (nr_frame * nr_element);
+}
+
+TEST(AtomicQueueBenchmark, DISABLED_DoubleBufferedPoll) {
+    const uint64_t nr_frame = 2000, nr_element = 256;
+    AtomicQueue<uint64_t> q1, q2;
+    double poll_cost = FrameDrain(q1, nr_frame, nr_element, [](const AtomicQueue<uint64_t>& q) {
+        uint64_t sum = 0;
+        for (auto e : q.Poll()) {
+            sum += e;
+        }
+        return sum;
+    });
+    std::list<uint64_t, TrillekAllocator<uint64_t>> buffer;
+    double buffered_cost = FrameDrain(q2, nr_frame, nr_element, [&buffer](const AtomicQueue<uint64_t>& q) {
+        uint64_t sum = 0;
+        q.Poll(buffer);
+        for (auto e : buffer) {
+            sum += e;
+        }
+        return sum;
+    });
+    std::cout << "[ BENCH    ] " << nr_element << " elements per frame: Poll() "
+              << poll_cost << " ns/element, double-buffered Poll "
+              << buffered_cost << " ns/element" << std::endl;
+}
+
+} // namespace benchmark
+} // namespace trillek
+
+#endif // ATOMICQUEUEBENCHMARK_H_INCLUDED
@@ -1,6 +1,7 @@
 #ifndef ATOMICQUEUETEST_H_INCLUDED
 #define ATOMICQUEUETEST_H_INCLUDED
 
+#include <vector>
 #include "atomic-queue.hpp"
 
 #include "gtest/gtest.h"
@@ -14,6 +15,11 @@ protected:
 
 using trillek::AtomicQueue;
 
+// the memory held by the queues
+static int64_t AllocatedSize() {
+    return trillek::MemoryAccounting::Stats(trillek::MemoryTag::GENERAL).current;
+}
+
 namespace trillek {
 TEST_F(AtomicQueueTest, AtomicQueueEmpty) {
     ASSERT_TRUE(q.Empty()) << "New queue is not empty";
@@ -31,7 +37,7 @@ TEST_F(AtomicQueueTest, AtomicQueueOneElement) {
     ASSERT_EQ(i, 1) << "Queue popped  wrong value";
     ASSERT_TRUE(q.Empty()) << "Queue is not empty";
     ASSERT_TRUE(q.Poll().empty()) << "Polled queue gives elements";
-    ASSERT_EQ(gAllocatedSize, 0) << "Allocated size is not null";
+    ASSERT_EQ(AllocatedSize(), 0) << "Allocated size is not null";
 }
 
 TEST_F(AtomicQueueTest, AtomicQueuePoll) {
@@ -47,7 +53,7 @@ TEST_F(AtomicQueueTest, AtomicQueuePoll) {
     ASSERT_EQ(ret.front(), 2) << "Second element from Poll has wrong value";
     ret.pop_front();
     ASSERT_TRUE(ret.empty()) << "Returned list from Poll() has more than 2 elements";
-    ASSERT_EQ(gAllocatedSize, 0) << "Allocated size is not null";
+    ASSERT_EQ(AllocatedSize(), 0) << "Allocated size is not null";
 }
 
 TEST_F(AtomicQueueTest, AtomicQueuePop) {
@@ -62,7 +68,7 @@ TEST_F(AtomicQueueTest, AtomicQueuePop) {
     ASSERT_EQ(i, 2) << "Pop()  wrong value";
     ASSERT_TRUE(q.Empty()) << "Queue is not empty";
     ASSERT_TRUE(q.Poll().empty()) << "Empty queue gives elements";
-    ASSERT_EQ(gAllocatedSize, 0) << "Allocated size is not null";
+    ASSERT_EQ(AllocatedSize(), 0) << "Allocated size is not null";
 }
 
 TEST_F(AtomicQueueTest, AtomicQueueCopyList) {
@@ -82,7 +88,7 @@ TEST_F(AtomicQueueTest, AtomicQueueCopyList) {
 }
 
 TEST_F(AtomicQueueTest, AtomicQueueMoveList) {
-    auto alloc_backup = gAllocatedSize;
+    auto alloc_backup = AllocatedSize();
     std::list<uint32_t, TrillekAllocator<uint32_t>> a{1,2,3,4,5};
     q.PushList(std::move(a));
     ASSERT_FALSE(q.Empty()) << "Queue is empty";
@@ -97,5 +103,40 @@ TEST_F(AtomicQueueTest, AtomicQueueMoveList) {
     ASSERT_TRUE(q.Empty()) << "Queue is not empty";
     ASSERT_TRUE(q.Poll().empty()) << "Polled queue gives elements";
 }
+
+TEST_F(AtomicQueueTest, AtomicQueueDoubleBuffer) {
+    std::list<uint32_t, TrillekAllocator<uint32_t>> buffer;
+    // the nodes polled in the last two frames
+    std::vector<const uint32_t*> nodes[2];
+    int64_t allocated = 0;
+    for (uint32_t frame = 0; frame < 6; ++frame) {
+        for (uint32_t i = 0; i < 5; ++i) {
+            q.Push(frame * 10 + i);
+        }
+        q.Poll(buffer);
+        ASSERT_TRUE(q.Empty()) << "Queue is not empty";
+        ASSERT_EQ(5, buffer.size()) << "Poll does not return all elements";
+        ASSERT_EQ(frame * 10, buffer.front()) << "First element from Poll has wrong value";
+        ASSERT_EQ(frame * 10 + 4, buffer.back()) << "Last element from Poll has wrong value";
+        std::vector<const uint32_t*> frame_nodes;
+        for (auto& element : buffer) {
+            frame_nodes.push_back(&element);
+        }
+        if (frame > 1) {
+            // the elements were pushed in the nodes consumed two frames ago
+            ASSERT_EQ(nodes[frame % 2], frame_nodes) << "Nodes not recycled";
+            ASSERT_EQ(allocated, AllocatedSize()) << "Steady frame allocated memory";
+        }
+        if (frame > 0) {
+            ASSERT_EQ(5, q.Spare()) << "Consumed nodes not kept";
+        }
+        nodes[frame % 2] = frame_nodes;
+        allocated = AllocatedSize();
+    }
+    buffer.clear();
+    q.ReleaseSpare();
+    ASSERT_EQ(0, q.Spare()) << "Spare nodes not released";
+    ASSERT_EQ(AllocatedSize(), 0) << "Allocated size is not null";
+}
 }
 #endif // ATOMICQUEUETEST_H_INCLUDED
@@ -0,0 +1,113 @@
+#ifndef ATOMICRINGQUEUETEST_H_INCLUDED
+#define ATOMICRINGQUEUETEST_H_INCLUDED
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "atomic-ring-queue.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// the behaviour shared with AtomicQueue
+template<RingAccess A>
+static void CheckRingQueue() {
+    AtomicRingQueue<uint32_t, A> q(4);
+    ASSERT_EQ(4, q.Capacity()) << "Wrong capacity";
+    ASSERT_TRUE(q.Empty()) << "New queue is not empty";
+    uint32_t i = 0;
+    ASSERT_FALSE(q.Pop(i)) << "New queue can pop inexisting element";
+    ASSERT_TRUE(q.Poll().empty()) << "New polled queue gives elements";
+
+    q.Push(1);
+    q.Push(2);
+    ASSERT_FALSE(q.Empty()) << "Queue is empty";
+    ASSERT_TRUE(q.Pop(i)) << "Queue can't pop existing element";
+    ASSERT_EQ(1, i) << "Pop()  wrong value";
+
+    typedef std::list<uint32_t, TrillekAllocator<uint32_t>> list_t;
+    list_t a{3, 4, 5};
+    q.PushList(a);
+    ASSERT_TRUE(a.empty()) << "Elements not moved out of the list";
+    ASSERT_FALSE(q.TryPush(6)) << "Element pushed in a full queue";
+    auto ret = q.Poll();
+    ASSERT_TRUE(q.Empty()) << "Queue is not empty";
+    ASSERT_EQ(list_t({2, 3, 4, 5}), ret) << "Poll does not return all elements in order";
+
+    // the ring turns
+    for (uint32_t n = 0; n < 10; ++n) {
+        ASSERT_TRUE(q.TryPush(n)) << "Element not pushed after the ring turned";
+        ASSERT_TRUE(q.Pop(i)) << "Element not popped after the ring turned";
+        ASSERT_EQ(n, i) << "Wrong element after the ring turned";
+    }
+}
+
+TEST(AtomicRingQueueTest, MPMC) {
+    CheckRingQueue<RingAccess::MPMC>();
+}
+
+TEST(AtomicRingQueueTest, SPSC) {
+    CheckRingQueue<RingAccess::SPSC>();
+}
+
+TEST(AtomicRingQueueTest, MPMCThreads) {
+    AtomicRingQueue<uint64_t> q(64);
+    const uint64_t per_producer = 20000;
+    std::atomic<uint64_t> sum(0), count(0);
+    std::vector<std::thread> threads;
+    for (uint64_t p = 0; p < 4; ++p) {
+        threads.push_back(std::thread([&q, p, per_producer]() {
+            for (uint64_t i = 1; i <= per_producer; ++i) {
+                q.Push(p * per_producer + i);
+            }
+        }));
+    }
+    for (int c = 0; c < 2; ++c) {
+        threads.push_back(std::thread([&]() {
+            uint64_t element;
+            while (count.load() < 4 * per_producer) {
+                if (q.Pop(element)) {
+                    sum.fetch_add(element);
+                    count.fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const uint64_t n = 4 * per_producer;
+    ASSERT_EQ(n * (n + 1) / 2, sum.load()) << "Elements lost or duplicated";
+    ASSERT_TRUE(q.Empty()) << "Queue is not empty";
+}
+
+TEST(AtomicRingQueueTest, SPSCOrder) {
+    AtomicRingQueue<uint32_t, RingAccess::SPSC> q(16);
+    const uint32_t n = 100000;
+    std::thread producer([&q, n]() {
+        for (uint32_t i = 0; i < n; ++i) {
+            q.Push(i);
+        }
+    });
+    uint32_t expected = 0, element;
+    bool ordered = true;
+    while (expected < n) {
+        if (q.Pop(element)) {
+            ordered = ordered && element == expected;
+            ++expected;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(ordered) << "Elements not popped in order";
+}
+
+} // namespace trillek
+
+#endif // ATOMICRINGQUEUETEST_H_INCLUDED
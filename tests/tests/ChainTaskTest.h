@@ -0,0 +1,76 @@
+#ifndef CHAINTASKTEST_H_INCLUDED
+#define CHAINTASKTEST_H_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "scheduler/task-request.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// collect the chains queued again instead of scheduling them
+struct ChainQueue {
+    ChainQueue() {
+        TaskRequest<chain_t>::Initialize([this](std::shared_ptr<TaskRequest<chain_t>>&& c, frame_unit&& delay) {
+            queued.push_back(std::move(c));
+            delays.push_back(delay);
+        }, frame_unit(100));
+    }
+
+    std::vector<std::shared_ptr<TaskRequest<chain_t>>> queued;
+    std::vector<frame_unit> delays;
+};
+
+// a block returning a list of results, and logging its calls
+static block_t LogBlock(const std::string& name, std::vector<std::string>& log, std::vector<int> results) {
+    auto call = std::make_shared<size_t>(0);
+    return [name, &log, results, call]() {
+        log.push_back(name);
+        auto i = (*call)++;
+        return i < results.size() ? results[i] : CONTINUE;
+    };
+}
+
+TEST(ChainTaskTest, Requeue) {
+    ChainQueue q;
+    std::vector<std::string> log;
+    chain_t chain = { LogBlock("a", log, {}), LogBlock("b", log, {REQUEUE}), LogBlock("c", log, {}) };
+    auto task = std::make_shared<TaskRequest<chain_t>>(chain);
+    task->RunTask();
+    ASSERT_EQ(std::vector<std::string>({"a", "b"}), log) << "Chain not suspended";
+    ASSERT_EQ(std::vector<frame_unit>({frame_unit(100)}), q.delays) << "Chain not queued with the requeue delay";
+    ASSERT_EQ(1, q.queued.size()) << "Suspended chain not queued";
+    ASSERT_EQ(task.get(), q.queued[0].get()) << "Suspended chain was copied";
+    task->RunTask();
+    ASSERT_EQ(std::vector<std::string>({"a", "b", "b", "c"}), log) << "Chain not resumed at the suspending block";
+    ASSERT_EQ(1, q.queued.size()) << "Finished chain queued";
+}
+
+TEST(ChainTaskTest, Split) {
+    ChainQueue q;
+    std::vector<std::string> log;
+    chain_t chain = { LogBlock("a", log, {SPLIT, STOP}), LogBlock("b", log, {}) };
+    auto task = std::make_shared<TaskRequest<chain_t>>(chain);
+    task->RunTask();
+    ASSERT_EQ(std::vector<std::string>({"a", "b"}), log) << "Chain not continued after split";
+    ASSERT_EQ(1, q.queued.size()) << "Fork not queued";
+    ASSERT_NE(task.get(), q.queued[0].get()) << "Fork is the same task";
+    q.queued[0]->RunTask();
+    ASSERT_EQ(std::vector<std::string>({"a", "b", "a"}), log) << "Fork does not run the splitting block";
+}
+
+TEST(ChainTaskTest, RepeatAndStop) {
+    ChainQueue q;
+    std::vector<std::string> log;
+    chain_t chain = { LogBlock("a", log, {REPEAT, REPEAT}), LogBlock("b", log, {STOP}), LogBlock("c", log, {}) };
+    auto task = std::make_shared<TaskRequest<chain_t>>(chain);
+    task->RunTask();
+    ASSERT_EQ(std::vector<std::string>({"a", "a", "a", "b"}), log) << "Wrong repeat or stop";
+    ASSERT_TRUE(q.queued.empty()) << "Chain queued";
+}
+
+} // namespace trillek
+
+#endif // CHAINTASKTEST_H_INCLUDED
@@ -0,0 +1,46 @@
+#ifndef CLOCKTEST_H_INCLUDED
+#define CLOCKTEST_H_INCLUDED
+
+#include <chrono>
+#include <thread>
+#include "scheduler/clock.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(ClockTest, RealClock) {
+    RealClock clock;
+    auto t0 = clock.Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_LE(std::chrono::milliseconds(10), clock.Now() - t0) << "Real time not elapsed";
+    ASSERT_FALSE(clock.Virtual()) << "Real clock is virtual";
+}
+
+TEST(ClockTest, VirtualClock) {
+    VirtualClock clock(frame_tp(frame_unit(1000)));
+    ASSERT_TRUE(clock.Virtual()) << "Virtual clock not virtual";
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(frame_tp(frame_unit(1000)), clock.Now()) << "Virtual time moved by itself";
+    clock.AdvanceTo(frame_tp(frame_unit(5000)));
+    ASSERT_EQ(frame_tp(frame_unit(5000)), clock.Now()) << "Virtual time not advanced";
+    clock.AdvanceTo(frame_tp(frame_unit(3000)));
+    ASSERT_EQ(frame_tp(frame_unit(5000)), clock.Now()) << "Virtual time went back";
+}
+
+TEST(ClockTest, ScaledClock) {
+    ScaledClock clock(4.0);
+    ASSERT_EQ(frame_unit(1000), clock.RealDuration(frame_unit(4000))) << "Wrong real duration";
+    // the real interval encloses the scaled one
+    auto r0 = std::chrono::steady_clock::now();
+    auto t0 = clock.Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto elapsed = clock.Now() - t0;
+    auto real_elapsed = std::chrono::steady_clock::now() - r0;
+    ASSERT_LE(std::chrono::milliseconds(40), elapsed) << "Scaled time too slow";
+    ASSERT_GE(4 * real_elapsed, elapsed) << "Scaled time too fast";
+}
+
+} // namespace trillek
+
+#endif // CLOCKTEST_H_INCLUDED
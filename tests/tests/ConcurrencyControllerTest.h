@@ -0,0 +1,66 @@
+#ifndef CONCURRENCYCONTROLLERTEST_H_INCLUDED
+#define CONCURRENCYCONTROLLERTEST_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "scheduler/concurrency-controller.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(ConcurrencyControllerTest, Defaults) {
+    ConcurrencyController controller;
+    ASSERT_EQ(std::max(std::thread::hardware_concurrency(), 1u), controller.Limit()) << "Limit not sized from the hardware";
+    ASSERT_EQ(controller.Limit(), controller.Quota(TaskClass::FRAME_CRITICAL)) << "Wrong frame-critical quota";
+    ASSERT_LE(1, controller.Quota(TaskClass::BACKGROUND_IO)) << "No background I/O quota";
+}
+
+TEST(ConcurrencyControllerTest, Quotas) {
+    ConcurrencyController controller;
+    controller.SetLimit(3);
+    controller.SetQuota(TaskClass::FRAME_CRITICAL, 3);
+    controller.SetQuota(TaskClass::BACKGROUND_IO, 1);
+    ASSERT_TRUE(controller.TryAcquire(TaskClass::BACKGROUND_IO)) << "Free slot not taken";
+    ASSERT_FALSE(controller.TryAcquire(TaskClass::BACKGROUND_IO)) << "Quota exceeded";
+    ASSERT_TRUE(controller.TryAcquire(TaskClass::FRAME_CRITICAL)) << "Free slot not taken";
+    ASSERT_TRUE(controller.TryAcquire(TaskClass::FRAME_CRITICAL)) << "Free slot not taken";
+    ASSERT_FALSE(controller.TryAcquire(TaskClass::FRAME_CRITICAL)) << "Limit exceeded";
+    ASSERT_EQ(3, controller.Running()) << "Wrong number of running tasks";
+    ASSERT_EQ(1, controller.Running(TaskClass::BACKGROUND_IO)) << "Wrong number of running tasks of the class";
+    controller.Release(TaskClass::BACKGROUND_IO);
+    ASSERT_TRUE(controller.TryAcquire(TaskClass::SCRIPTING)) << "Released slot not taken";
+    ASSERT_FALSE(controller.TryAcquire(TaskClass::FRAME_CRITICAL)) << "Limit exceeded";
+}
+
+TEST(ConcurrencyControllerTest, WakeOneWaiter) {
+    ConcurrencyController controller;
+    controller.SetLimit(1);
+    ASSERT_TRUE(controller.TryAcquire(TaskClass::FRAME_CRITICAL)) << "Free slot not taken";
+    std::atomic<int> acquired(0);
+    std::thread t1([&]() { controller.Acquire(TaskClass::FRAME_CRITICAL); acquired++; });
+    std::thread t2([&]() { controller.Acquire(TaskClass::FRAME_CRITICAL); acquired++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(0, acquired.load()) << "Waiter did not wait";
+
+    controller.Release(TaskClass::FRAME_CRITICAL);
+    auto start = std::chrono::steady_clock::now();
+    while (acquired.load() < 1 && std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(1, acquired.load()) << "Not exactly one waiter woken up";
+    ASSERT_EQ(1, controller.Running()) << "Slot not given to the waiter";
+
+    controller.Release(TaskClass::FRAME_CRITICAL);
+    t1.join();
+    t2.join();
+    ASSERT_EQ(2, acquired.load()) << "Second waiter not woken up";
+    controller.Release(TaskClass::FRAME_CRITICAL);
+    ASSERT_EQ(0, controller.Running()) << "Slots not released";
+}
+
+} // namespace trillek
+
+#endif // CONCURRENCYCONTROLLERTEST_H_INCLUDED
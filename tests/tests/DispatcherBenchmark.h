@@ -0,0 +1,73 @@
+#ifndef DISPATCHERBENCHMARK_H_INCLUDED
+#define DISPATCHERBENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <map>
+#include "systems/dispatcher.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+struct BenchmarkEvent {
+    unsigned int value;
+};
+
+class BenchmarkSubscriber : public event::Subscriber<BenchmarkEvent> {
+public:
+    BenchmarkSubscriber() : sum(0) { }
+    void Notify(const unsigned int entity_id, const BenchmarkEvent* data) override {
+        sum += data->value;
+    }
+    uint64_t sum;
+};
+
+TEST(DispatcherBenchmark, DISABLED_Notify) {
+    const unsigned int nr_entity = 1000, nr_notify = 1000000;
+    auto dispatcher = event::Dispatcher<BenchmarkEvent>::GetInstance();
+    // the lookup and the copy of the list done by the dispatcher before
+    std::map<unsigned int, std::list<event::Subscriber<BenchmarkEvent>*>> lists;
+    BenchmarkSubscriber a, b;
+    for (unsigned int id = 1; id <= nr_entity; ++id) {
+        dispatcher->Subscribe(id, &a);
+        dispatcher->Subscribe(id, &b);
+        lists[id].push_back(&a);
+        lists[id].push_back(&b);
+    }
+    BenchmarkEvent event{1};
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_notify; ++i) {
+        const unsigned int id = 1 + (i * 7919) % nr_entity;
+        if (lists.find(id) != lists.end()) {
+            auto subscriber_list = lists.at(id);
+            for (auto subscriber : subscriber_list) {
+                subscriber->Notify(id, &event);
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> copy_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_notify; ++i) {
+        dispatcher->NotifySubscribers(1 + (i * 7919) % nr_entity, &event);
+    }
+    std::chrono::duration<double, std::nano> rcu_time = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(4ull * nr_notify, a.sum + b.sum) << "Notifications lost";
+    std::cout << "[ BENCH    ] " << nr_entity << " entities, 2 subscribers: map and list copy "
+              << copy_time.count() / nr_notify << " ns/notify, flat table "
+              << rcu_time.count() / nr_notify << " ns/notify" << std::endl;
+    for (unsigned int id = 1; id <= nr_entity; ++id) {
+        dispatcher->Unsubscribe(id, &a);
+        dispatcher->Unsubscribe(id, &b);
+    }
+}
+
+} // namespace benchmark
+} // namespace trillek
+
+#endif // DISPATCHERBENCHMARK_H_INCLUDED
@@ -0,0 +1,225 @@
+#ifndef DISPATCHERTEST_H_INCLUDED
+#define DISPATCHERTEST_H_INCLUDED
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "systems/dispatcher.hpp"
+#include "systems/deferred-events.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// each test uses its own event type, the dispatchers being singletons
+template<int N>
+struct DispatcherTestEvent {
+    unsigned int value;
+};
+
+template<int N>
+class CountingSubscriber : public event::Subscriber<DispatcherTestEvent<N>> {
+public:
+    CountingSubscriber() : entity_sum(0), global_sum(0), calls(0) { }
+    void Notify(const unsigned int entity_id, const DispatcherTestEvent<N>* data) override {
+        entity_sum.fetch_add(entity_id * data->value);
+        calls.fetch_add(1);
+    }
+    void Notify(const DispatcherTestEvent<N>* data) override {
+        global_sum.fetch_add(data->value);
+        calls.fetch_add(1);
+    }
+    std::atomic<unsigned int> entity_sum, global_sum, calls;
+};
+
+TEST(DispatcherTest, Subscriptions) {
+    auto dispatcher = event::Dispatcher<DispatcherTestEvent<0>>::GetInstance();
+    CountingSubscriber<0> a, b;
+    DispatcherTestEvent<0> event{1};
+    dispatcher->NotifySubscribers(5, &event);
+    dispatcher->NotifySubscribers(&event);
+
+    dispatcher->Subscribe(5, &a);
+    dispatcher->Subscribe(5, &a);
+    dispatcher->Subscribe(5, &b);
+    dispatcher->Subscribe(&b);
+    // enough entities to grow the table
+    for (unsigned int id = 100; id < 200; ++id) {
+        dispatcher->Subscribe(id, &b);
+    }
+    dispatcher->NotifySubscribers(5, &event);
+    ASSERT_EQ(1, a.calls.load()) << "Subscriber subscribed twice to an entity";
+    ASSERT_EQ(5, b.entity_sum.load()) << "Second subscriber of the entity not notified";
+    dispatcher->NotifySubscribers(&event);
+    ASSERT_EQ(1, b.global_sum.load()) << "Subscriber to any entity not notified";
+    ASSERT_EQ(0, a.global_sum.load()) << "Subscriber of an entity notified for any entity";
+    dispatcher->NotifySubscribers(6, &event);
+    ASSERT_EQ(1, a.calls.load()) << "Subscriber notified for another entity";
+    dispatcher->NotifySubscribers(150, &event);
+    ASSERT_EQ(155, b.entity_sum.load()) << "Subscriber not notified for another entity";
+
+    dispatcher->Unsubscribe(5, &a);
+    dispatcher->Unsubscribe(&b);
+    dispatcher->Synchronize();
+    dispatcher->NotifySubscribers(5, &event);
+    dispatcher->NotifySubscribers(&event);
+    ASSERT_EQ(1, a.calls.load()) << "Unsubscribed subscriber notified";
+    ASSERT_EQ(160, b.entity_sum.load()) << "Subscriber left not notified";
+    ASSERT_EQ(1, b.global_sum.load()) << "Unsubscribed subscriber notified for any entity";
+    for (unsigned int id = 100; id < 200; ++id) {
+        dispatcher->Unsubscribe(id, &b);
+    }
+    dispatcher->Unsubscribe(5, &b);
+}
+
+TEST(DispatcherTest, ConcurrentSubscriptions) {
+    auto dispatcher = event::Dispatcher<DispatcherTestEvent<1>>::GetInstance();
+    CountingSubscriber<1> permanent, transient;
+    dispatcher->Subscribe(1, &permanent);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> notifiers;
+    for (int t = 0; t < 2; ++t) {
+        notifiers.push_back(std::thread([&]() {
+            DispatcherTestEvent<1> event{1};
+            while (! done.load()) {
+                dispatcher->NotifySubscribers(1, &event);
+            }
+        }));
+    }
+    for (unsigned int i = 0; i < 2000; ++i) {
+        dispatcher->Subscribe(1, &transient);
+        dispatcher->Subscribe(2 + i % 50, &transient);
+        dispatcher->Unsubscribe(1, &transient);
+        if (! (i % 64)) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true);
+    for (auto& t : notifiers) {
+        t.join();
+    }
+    dispatcher->Synchronize();
+    const auto calls = transient.calls.load();
+    DispatcherTestEvent<1> event{1};
+    dispatcher->NotifySubscribers(1, &event);
+    ASSERT_EQ(calls, transient.calls.load()) << "Unsubscribed subscriber notified";
+    ASSERT_LT(0, permanent.calls.load()) << "Subscriber not notified";
+}
+
+// a subscriber keeping the notifications in the table
+class SlowSubscriber : public CountingSubscriber<3> {
+public:
+    void Notify(const unsigned int entity_id, const DispatcherTestEvent<3>* data) override {
+        std::this_thread::yield();
+        CountingSubscriber<3>::Notify(entity_id, data);
+    }
+};
+
+TEST(DispatcherTest, StressSubscriptions) {
+    // the tables are replaced while notifications read them
+    auto dispatcher = event::Dispatcher<DispatcherTestEvent<3>>::GetInstance();
+    SlowSubscriber permanent;
+    std::vector<CountingSubscriber<3>> transients(4);
+    dispatcher->Subscribe(1, &permanent);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            DispatcherTestEvent<3> event{1};
+            unsigned int i = 0;
+            while (! done.load()) {
+                dispatcher->NotifySubscribers(1 + i % 64, &event);
+                dispatcher->NotifySubscribers(&event);
+                i += t + 1;
+            }
+        }));
+    }
+    std::vector<std::thread> writers;
+    for (unsigned int w = 0; w < transients.size(); ++w) {
+        writers.push_back(std::thread([&, w]() {
+            auto* transient = &transients[w];
+            for (unsigned int i = 0; i < 2000; ++i) {
+                dispatcher->Subscribe(1 + i % 64, transient);
+                dispatcher->Subscribe(transient);
+                dispatcher->Unsubscribe(1 + (i + 32) % 64, transient);
+                dispatcher->Unsubscribe(transient);
+            }
+            for (unsigned int id = 1; id <= 64; ++id) {
+                dispatcher->Unsubscribe(id, transient);
+            }
+        }));
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    done.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    dispatcher->Synchronize();
+    DispatcherTestEvent<3> event{1};
+    unsigned int calls = 0;
+    for (auto& transient : transients) {
+        calls += transient.calls.load();
+    }
+    for (unsigned int id = 1; id <= 64; ++id) {
+        dispatcher->NotifySubscribers(id, &event);
+    }
+    dispatcher->NotifySubscribers(&event);
+    unsigned int after = 0;
+    for (auto& transient : transients) {
+        after += transient.calls.load();
+    }
+    ASSERT_EQ(calls, after) << "Unsubscribed subscriber notified";
+    ASSERT_LT(0, permanent.calls.load()) << "Subscriber not notified";
+    dispatcher->Unsubscribe(1, &permanent);
+}
+
+TEST(DispatcherTest, DeferredEvents) {
+    auto dispatcher = event::Dispatcher<DispatcherTestEvent<2>>::GetInstance();
+    CountingSubscriber<2> target;
+    {
+        // a small ring, so that the events spill
+        event::DeferredEvents<DispatcherTestEvent<2>> deferred(8);
+        deferred.Subscribe();
+        deferred.Subscribe(7);
+        std::thread notifier([&dispatcher]() {
+            for (unsigned int i = 1; i <= 100; ++i) {
+                DispatcherTestEvent<2> event{i};
+                dispatcher->NotifySubscribers(&event);
+            }
+            DispatcherTestEvent<2> event{1};
+            dispatcher->NotifySubscribers(7, &event);
+            dispatcher->NotifySubscribers(8, &event);
+        });
+        notifier.join();
+        ASSERT_EQ(0, target.calls.load()) << "Events delivered before the owner asks for them";
+
+        auto& batch = deferred.Poll();
+        ASSERT_EQ(101, batch.size()) << "Events lost";
+        bool ordered = true;
+        for (unsigned int i = 0; i < 100; ++i) {
+            ordered = ordered && batch[i].any_entity && batch[i].data.value == i + 1;
+        }
+        ASSERT_TRUE(ordered) << "Events not in the order they were notified";
+        ASSERT_EQ(7, batch.back().entity_id) << "Wrong entity of the event";
+        ASSERT_TRUE(deferred.Poll().empty()) << "Events delivered twice";
+
+        for (unsigned int i = 1; i <= 3; ++i) {
+            DispatcherTestEvent<2> event{i};
+            dispatcher->NotifySubscribers(&event);
+            dispatcher->NotifySubscribers(7, &event);
+        }
+        deferred.Deliver(&target);
+        ASSERT_EQ(6, target.global_sum.load()) << "Wrong events delivered";
+        ASSERT_EQ(42, target.entity_sum.load()) << "Wrong entity events delivered";
+    }
+    // the buffer unsubscribed when destroyed
+    DispatcherTestEvent<2> event{1};
+    dispatcher->NotifySubscribers(&event);
+    dispatcher->NotifySubscribers(7, &event);
+}
+
+} // namespace trillek
+
+#endif // DISPATCHERTEST_H_INCLUDED
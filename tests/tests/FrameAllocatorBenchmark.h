@@ -0,0 +1,57 @@
+#ifndef FRAMEALLOCATORBENCHMARK_H_INCLUDED
+#define FRAMEALLOCATORBENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <vector>
+#include "frame-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+/** \brief Build the per-frame temporaries of nr_entity entities with an allocator
+ *
+ * A map of the modified entities and a vector of matrices, as done by the systems.
+ *
+ * \return double the time per entity in ns
+ */
+template<template<class> class Alloc>
+static double FrameTemporaries(unsigned int nr_entity, unsigned int nr_frame) {
+    auto& arena = FrameArena::Local();
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (unsigned int frame = 0; frame < nr_frame; ++frame) {
+        {
+            std::map<unsigned int, const void*, std::less<unsigned int>,
+                Alloc<std::pair<const unsigned int, const void*>>> modified;
+            std::vector<float, Alloc<float>> matrices;
+            for (unsigned int i = 0; i < nr_entity; ++i) {
+                modified.emplace(i, &arena);
+                matrices.insert(matrices.end(), 16, 1.0f);
+            }
+            total += modified.size() + matrices.size();
+        }
+        arena.Reset();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(size_t(17) * nr_entity * nr_frame, total);
+    return elapsed.count() / (nr_entity * nr_frame);
+}
+
+TEST(FrameAllocatorBenchmark, DISABLED_Temporaries) {
+    auto& arena = FrameArena::Local();
+    arena.SetManaged(true);
+    const double heap = FrameTemporaries<std::allocator>(2000, 200);
+    const double frame = FrameTemporaries<FrameAllocator>(2000, 200);
+    arena.SetManaged(false);
+    std::cout << "[ BENCH    ] per-frame temporaries: heap " << heap << " ns/entity, frame arena "
+        << frame << " ns/entity, " << arena.BlockAllocations() << " blocks allocated" << std::endl;
+}
+
+} // End of benchmark
+} // End of trillek
+
+#endif // FRAMEALLOCATORBENCHMARK_H_INCLUDED
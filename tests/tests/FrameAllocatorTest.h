@@ -0,0 +1,87 @@
+#ifndef FRAMEALLOCATORTEST_H_INCLUDED
+#define FRAMEALLOCATORTEST_H_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <thread>
+#include <vector>
+#include "frame-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(FrameAllocatorTest, Arena) {
+    FrameArena arena(1024);
+    void* first = arena.Allocate(10, 1);
+    void* aligned = arena.Allocate(24, 64);
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 64) << "Alignment not respected";
+    ASSERT_NE(first, aligned) << "Same memory given twice";
+    ASSERT_EQ(34u, arena.Used()) << "Wrong used size";
+    ASSERT_EQ(1u, arena.BlockAllocations()) << "Small allocations in several blocks";
+
+    // larger than a block
+    void* large = arena.Allocate(4000);
+    ASSERT_NE(nullptr, large) << "No memory for a large allocation";
+    ASSERT_EQ(2u, arena.BlockAllocations()) << "No block for a large allocation";
+
+    // the next frames use the same blocks
+    arena.Reset();
+    ASSERT_EQ(0u, arena.Used()) << "Memory still used after a reset";
+    ASSERT_EQ(4034u, arena.Peak()) << "Wrong peak";
+    for (int frame = 0; frame < 10; ++frame) {
+        ASSERT_EQ(first, arena.Allocate(10, 1)) << "The blocks are not reused";
+        arena.Allocate(24, 64);
+        arena.Allocate(4000);
+        arena.Reset();
+    }
+    ASSERT_EQ(2u, arena.BlockAllocations()) << "Heap used after the first frame";
+
+    arena.Release();
+    ASSERT_EQ(0u, arena.Capacity()) << "Blocks kept after release";
+}
+
+TEST(FrameAllocatorTest, Containers) {
+    auto& arena = FrameArena::Local();
+    arena.SetManaged(true);
+    arena.Reset();
+    size_t blocks = 0;
+    for (int frame = 0; frame < 10; ++frame) {
+        std::vector<int, FrameAllocator<int>> v;
+        std::map<unsigned int, int, std::less<unsigned int>,
+            FrameAllocator<std::pair<const unsigned int, int>>> m;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+            m[i] = i;
+        }
+        ASSERT_EQ(999, v[999]) << "Wrong vector content";
+        ASSERT_EQ(1000u, m.size()) << "Wrong map size";
+        ASSERT_EQ(500, m[500]) << "Wrong map content";
+        ASSERT_LE(1000 * sizeof(int), arena.Used()) << "The containers do not use the arena";
+        arena.Reset();
+        if (frame == 0) {
+            blocks = arena.BlockAllocations();
+        }
+    }
+    ASSERT_EQ(blocks, arena.BlockAllocations()) << "Heap used after the first frame";
+    arena.SetManaged(false);
+}
+
+TEST(FrameAllocatorTest, Unmanaged) {
+    std::vector<double, FrameAllocator<double>> v;
+    std::thread t([&v]() {
+        // a thread not managed by the scheduler uses the heap
+        ASSERT_FALSE(FrameArena::Local().Managed()) << "Thread arena managed by default";
+        v.assign(100, 1.0);
+        ASSERT_EQ(0u, FrameArena::Local().Used()) << "The arena is used without reset";
+    });
+    t.join();
+    ASSERT_EQ(100u, v.size()) << "Wrong vector size";
+    // freed on another thread
+    v.clear();
+    v.shrink_to_fit();
+}
+
+} // End of trillek
+
+#endif // FRAMEALLOCATORTEST_H_INCLUDED
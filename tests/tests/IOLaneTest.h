@@ -0,0 +1,55 @@
+#ifndef IOLANETEST_H_INCLUDED
+#define IOLANETEST_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include "scheduler/io-lane.hpp"
+#include "trillek-scheduler.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(IOLaneTest, RunInOtherThread) {
+    IOLane lane;
+    std::atomic<bool> other_thread(false);
+    const auto caller = std::this_thread::get_id();
+    lane.Push([&]() { other_thread = std::this_thread::get_id() != caller; });
+    lane.Stop();
+    ASSERT_TRUE(other_thread.load()) << "Job not run in a thread of the lane";
+    ASSERT_EQ(0, lane.Threads()) << "Threads not stopped";
+}
+
+TEST(IOLaneTest, BoundedThreads) {
+    IOLane lane(2);
+    std::atomic<int> running(0), max_running(0), done(0);
+    for (int i = 0; i < 10; ++i) {
+        lane.Push([&]() {
+            const int r = ++running;
+            int m = max_running.load();
+            while (m < r && ! max_running.compare_exchange_weak(m, r)) {}
+            // a blocking read
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            --running;
+            ++done;
+        });
+    }
+    ASSERT_GE(2, lane.Threads()) << "Too many threads launched";
+    lane.Stop();
+    ASSERT_EQ(10, done.load()) << "Queued jobs not done before stopping";
+    ASSERT_GE(2, max_running.load()) << "Too many jobs at once";
+}
+
+TEST(IOLaneTest, QueueIOFuture) {
+    TrillekScheduler scheduler;
+    auto result = scheduler.QueueIO([]() { return 42; });
+    ASSERT_EQ(42, result.get()) << "Wrong result";
+    auto error = scheduler.QueueIO([]() -> int { throw std::runtime_error("no file"); });
+    ASSERT_THROW(error.get(), std::runtime_error) << "Exception not passed to the future";
+}
+
+} // namespace trillek
+
+#endif // IOLANETEST_H_INCLUDED
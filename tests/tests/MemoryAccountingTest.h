@@ -0,0 +1,78 @@
+#ifndef MEMORYACCOUNTINGTEST_H_INCLUDED
+#define MEMORYACCOUNTINGTEST_H_INCLUDED
+
+#include <list>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include "memory-accounting.hpp"
+#include "trillek-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(MemoryAccountingTest, Tags) {
+    const auto before = MemoryAccounting::Stats(MemoryTag::SOUND);
+    const auto other = MemoryAccounting::Stats(MemoryTag::PHYSICS);
+    MemoryAccounting::Allocate(MemoryTag::SOUND, 100);
+    MemoryAccounting::Allocate(MemoryTag::SOUND, 50);
+    auto stats = MemoryAccounting::Stats(MemoryTag::SOUND);
+    ASSERT_EQ(before.current + 150, stats.current) << "Wrong current size";
+    ASSERT_EQ(before.allocations + 2, stats.allocations) << "Wrong number of allocations";
+    ASSERT_LE(stats.current, stats.peak) << "Peak lower than the current size";
+    MemoryAccounting::Deallocate(MemoryTag::SOUND, 100);
+    stats = MemoryAccounting::Stats(MemoryTag::SOUND);
+    ASSERT_EQ(before.current + 50, stats.current) << "Wrong current size";
+    ASSERT_EQ(before.deallocations + 1, stats.deallocations) << "Wrong number of deallocations";
+    ASSERT_LE(before.current + 150, stats.peak) << "Peak not kept";
+    ASSERT_EQ(other.current, MemoryAccounting::Stats(MemoryTag::PHYSICS).current) << "Wrong tag counted";
+    MemoryAccounting::Deallocate(MemoryTag::SOUND, 50);
+
+    // the allocators count for their tag
+    const auto lua = MemoryAccounting::Stats(MemoryTag::LUA);
+    {
+        std::list<uint64_t, TrillekAllocator<uint64_t, MemoryTag::LUA>> l(10, 1);
+        ASSERT_LE(lua.current + 10 * static_cast<int64_t>(sizeof(uint64_t)),
+                  MemoryAccounting::Stats(MemoryTag::LUA).current) << "Allocator memory not counted";
+        auto p = std::allocate_shared<uint64_t>(TrillekAllocator<uint64_t, MemoryTag::LUA>(), 5);
+        ASSERT_EQ(5u, *p) << "Wrong shared value";
+    }
+    ASSERT_EQ(lua.current, MemoryAccounting::Stats(MemoryTag::LUA).current) << "Allocator memory not released";
+
+    std::ostringstream report;
+    MemoryAccounting::Dump(report);
+    ASSERT_NE(std::string::npos, report.str().find("lua: current")) << "Tag missing in the report";
+}
+
+TEST(MemoryAccountingTest, Threads) {
+    const auto before = MemoryAccounting::Stats(MemoryTag::GRAPHICS);
+    const int64_t size = 4 * MemoryAccounting::FLUSH_SIZE;
+    // allocated by threads that end, freed by this one
+    std::thread t1([size]() {
+        for (int i = 0; i < 1000; ++i) {
+            MemoryAccounting::Allocate(MemoryTag::GRAPHICS, size / 1000);
+        }
+    });
+    std::thread t2([size]() {
+        for (int i = 0; i < 1000; ++i) {
+            MemoryAccounting::Allocate(MemoryTag::GRAPHICS, size / 1000);
+        }
+    });
+    t1.join();
+    t2.join();
+    auto stats = MemoryAccounting::Stats(MemoryTag::GRAPHICS);
+    ASSERT_EQ(before.current + 2 * (size / 1000) * 1000, stats.current) << "Ended thread memory lost";
+    ASSERT_EQ(before.allocations + 2000, stats.allocations) << "Ended thread allocations lost";
+    for (int i = 0; i < 2000; ++i) {
+        MemoryAccounting::Deallocate(MemoryTag::GRAPHICS, size / 1000);
+    }
+    stats = MemoryAccounting::Stats(MemoryTag::GRAPHICS);
+    ASSERT_EQ(before.current, stats.current) << "Memory freed by another thread not counted";
+    // exact up to FLUSH_SIZE bytes per thread
+    ASSERT_LE(before.current + 2 * size - 2 * MemoryAccounting::FLUSH_SIZE, stats.peak) << "Peak missed";
+}
+
+} // End of trillek
+
+#endif // MEMORYACCOUNTINGTEST_H_INCLUDED
@@ -0,0 +1,108 @@
+#ifndef PARALLELJOBTEST_H_INCLUDED
+#define PARALLELJOBTEST_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "trillek-scheduler.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(ParallelJobTest, ForEachIndexOnce) {
+    std::vector<std::atomic<int>> visits(10000);
+    std::atomic<size_t> smallest_chunk(~size_t(0));
+    auto fn = [&visits, &smallest_chunk](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i) {
+            visits[i]++;
+        }
+        // only the last chunk can be smaller than the grain
+        auto chunk = smallest_chunk.load();
+        while (last != visits.size() && last - first < chunk && ! smallest_chunk.compare_exchange_weak(chunk, last - first)) {}
+    };
+    auto job = std::make_shared<ParallelForJob<size_t,decltype(fn)>>(0, visits.size(), 100, 4, fn);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.push_back(std::thread([job] () { job->Work(); }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_TRUE(job->Done()) << "Job not done";
+    for (size_t i = 0; i < visits.size(); ++i) {
+        ASSERT_EQ(1, visits[i]) << "Index " << i << " not processed once";
+    }
+    ASSERT_LE(100, smallest_chunk.load()) << "Chunk other than the last smaller than the grain";
+}
+
+TEST(ParallelJobTest, Reduce) {
+    std::vector<int> values(10000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = i;
+    }
+    auto fn = [](std::vector<int>::const_iterator first, std::vector<int>::const_iterator last) {
+        long sum = 0;
+        for (auto it = first; it != last; ++it) {
+            sum += *it;
+        }
+        return sum;
+    };
+    auto combine = [](long a, long b) { return a + b; };
+    auto job = std::make_shared<ParallelReduceJob<std::vector<int>::const_iterator,long,decltype(fn),decltype(combine)>>(
+                    values.cbegin(), values.size(), 10, 3, 0, fn, combine);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.push_back(std::thread([job] () { job->Work(); }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_TRUE(job->Done()) << "Job not done";
+    ASSERT_EQ(49995000, job->Result()) << "Wrong sum";
+}
+
+TEST(ParallelJobTest, Wait) {
+    // the waiting thread wakes up when the last chunk of another thread is done
+    std::atomic<bool> release(false);
+    auto fn = [&release](size_t, size_t) {
+        while (! release.load()) {
+            std::this_thread::yield();
+        }
+    };
+    auto job = std::make_shared<ParallelForJob<size_t,decltype(fn)>>(0, 4, 4, 1, fn);
+    std::thread worker([job] () { job->Work(); });
+    std::thread waiter([job] () { job->Wait(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(job->Done()) << "Job done before its chunk";
+    release = true;
+    waiter.join();
+    worker.join();
+    ASSERT_TRUE(job->Done()) << "Wait() returned before the job is done";
+}
+
+TEST(ParallelJobTest, SchedulerWithoutWorkers) {
+    // before Initialize(), the calling thread does all the work
+    TrillekScheduler scheduler;
+    std::vector<int> values(1000, 1);
+    scheduler.ParallelFor(values.begin(), values.end(), 16, [](std::vector<int>::iterator first, std::vector<int>::iterator last) {
+        for (auto it = first; it != last; ++it) {
+            *it *= 2;
+        }
+    });
+    auto sum = scheduler.ParallelReduce(0, 1000, 16, 0,
+                                        [&values](int first, int last) {
+                                            int sum = 0;
+                                            for (int i = first; i < last; ++i) {
+                                                sum += values[i];
+                                            }
+                                            return sum;
+                                        },
+                                        [](int a, int b) { return a + b; });
+    ASSERT_EQ(2000, sum) << "Wrong result";
+}
+
+} // namespace trillek
+
+#endif // PARALLELJOBTEST_H_INCLUDED
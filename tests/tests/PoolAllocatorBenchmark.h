@@ -0,0 +1,81 @@
+#ifndef POOLALLOCATORBENCHMARK_H_INCLUDED
+#define POOLALLOCATORBENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "pool-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+// a component of the size of a renderable
+struct PoolBenchmarkComponent {
+    PoolBenchmarkComponent(unsigned int id) : id(id) { }
+    virtual ~PoolBenchmarkComponent() { }
+    unsigned int id;
+    float matrix[16];
+    std::shared_ptr<void> resources[4];
+};
+
+/** \brief Spawn and despawn nr_entity components, then read them all
+ *
+ * \param make Function the function creating a component
+ * \param spawn_cost double& the time per spawned component in ns
+ * \param despawn_cost double& the time per destroyed component in ns
+ * \param read_cost double& the time per component read in ns
+ */
+template<class Function>
+static void SpawnDespawn(unsigned int nr_entity, unsigned int nr_round, Function make,
+                         double& spawn_cost, double& despawn_cost, double& read_cost) {
+    std::vector<std::shared_ptr<PoolBenchmarkComponent>> components(nr_entity);
+    std::chrono::duration<double, std::nano> spawn(0), despawn(0), read(0);
+    unsigned int sum = 0;
+    for (unsigned int round = 0; round < nr_round; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < nr_entity; ++i) {
+            components[i] = make(i);
+        }
+        auto spawned = std::chrono::steady_clock::now();
+        for (int n = 0; n < 4; ++n) {
+            for (auto& c : components) {
+                sum += c->id;
+            }
+        }
+        auto read_done = std::chrono::steady_clock::now();
+        for (auto& c : components) {
+            c.reset();
+        }
+        spawn += spawned - start;
+        read += read_done - spawned;
+        despawn += std::chrono::steady_clock::now() - read_done;
+    }
+    EXPECT_NE(0u, sum);
+    spawn_cost = spawn.count() / (nr_entity * nr_round);
+    despawn_cost = despawn.count() / (nr_entity * nr_round);
+    read_cost = read.count() / (4.0 * nr_entity * nr_round);
+}
+
+TEST(PoolAllocatorBenchmark, DISABLED_SpawnDespawn) {
+    double spawn, despawn, read;
+    SpawnDespawn(50000, 10, [](unsigned int id) {
+        return std::make_shared<PoolBenchmarkComponent>(id);
+    }, spawn, despawn, read);
+    std::cout << "[ BENCH    ] make_shared: spawn " << spawn << " ns, despawn " << despawn
+        << " ns, read " << read << " ns per component" << std::endl;
+    SpawnDespawn(50000, 10, [](unsigned int id) {
+        return std::allocate_shared<PoolBenchmarkComponent>(PoolAllocator<PoolBenchmarkComponent>(), id);
+    }, spawn, despawn, read);
+    const auto stats = PoolAllocator<PoolBenchmarkComponent>::Stats();
+    std::cout << "[ BENCH    ] pool: spawn " << spawn << " ns, despawn " << despawn
+        << " ns, read " << read << " ns per component, " << stats.chunks << " chunks of "
+        << stats.capacity / stats.chunks << " slots of " << stats.slot_size << " bytes" << std::endl;
+}
+
+} // End of benchmark
+} // End of trillek
+
+#endif // POOLALLOCATORBENCHMARK_H_INCLUDED
@@ -0,0 +1,90 @@
+#ifndef POOLALLOCATORTEST_H_INCLUDED
+#define POOLALLOCATORTEST_H_INCLUDED
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include "pool-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+struct PoolTestComponent {
+    PoolTestComponent(unsigned int id = 0) : id(id) { }
+    unsigned int id;
+    double data[8];
+};
+
+TEST(PoolAllocatorTest, Slots) {
+    SlabPool pool(1024);
+    std::vector<void*> slots;
+    for (int i = 0; i < 40; ++i) {
+        slots.push_back(pool.Allocate(48, 8));
+    }
+    auto stats = pool.Stats();
+    ASSERT_EQ(48u, stats.slot_size) << "Wrong slot size";
+    ASSERT_EQ(40u, stats.used) << "Wrong number of slots in use";
+    ASSERT_EQ(2u, stats.chunks) << "Wrong number of chunks";
+    ASSERT_EQ(42u, stats.capacity) << "Wrong capacity";
+    // contiguous in a chunk
+    for (int i = 1; i < 21; ++i) {
+        ASSERT_EQ(static_cast<char*>(slots[i - 1]) + 48, slots[i]) << "Slots not contiguous";
+    }
+
+    // the freed slots are reused
+    pool.Deallocate(slots[5], 48, 8);
+    ASSERT_EQ(slots[5], pool.Allocate(40, 8)) << "Freed slot not reused";
+    for (auto p : slots) {
+        pool.Deallocate(p, 48, 8);
+    }
+    stats = pool.Stats();
+    ASSERT_EQ(0u, stats.used) << "Slots still in use";
+    ASSERT_EQ(40u, stats.peak) << "Wrong peak";
+    ASSERT_EQ(2u, stats.chunks) << "Chunks not kept";
+
+    // too large for a slot
+    void* large = pool.Allocate(100, 8);
+    ASSERT_EQ(1u, pool.Stats().overflows) << "Large object in a slot";
+    pool.Deallocate(large, 100, 8);
+    ASSERT_EQ(0u, pool.Stats().used) << "Large object counted as a slot";
+}
+
+TEST(PoolAllocatorTest, AllocateShared) {
+    const auto before = PoolAllocator<PoolTestComponent>::Stats();
+    std::vector<std::shared_ptr<PoolTestComponent>> components;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        components.push_back(std::allocate_shared<PoolTestComponent>(PoolAllocator<PoolTestComponent>(), i));
+    }
+    auto stats = PoolAllocator<PoolTestComponent>::Stats();
+    ASSERT_EQ(before.used + 1000, stats.used) << "The components are not in the pool";
+    ASSERT_LE(sizeof(PoolTestComponent), stats.slot_size) << "The slot is too small";
+    ASSERT_EQ(before.overflows, stats.overflows) << "Components allocated on the heap";
+    ASSERT_EQ(999u, components.back()->id) << "Wrong component";
+
+    // released from other threads
+    std::thread t1([&components]() {
+        for (size_t i = 0; i < 500; ++i) {
+            components[i].reset();
+        }
+    });
+    std::thread t2([&components]() {
+        for (size_t i = 500; i < 1000; ++i) {
+            components[i].reset();
+        }
+    });
+    t1.join();
+    t2.join();
+    stats = PoolAllocator<PoolTestComponent>::Stats();
+    ASSERT_EQ(before.used, stats.used) << "The components are not released";
+
+    // a respawn does not take more memory
+    for (unsigned int i = 0; i < 1000; ++i) {
+        components[i] = std::allocate_shared<PoolTestComponent>(PoolAllocator<PoolTestComponent>(), i);
+    }
+    ASSERT_EQ(stats.chunks, PoolAllocator<PoolTestComponent>::Stats().chunks) << "The freed slots are not reused";
+}
+
+} // End of trillek
+
+#endif // POOLALLOCATORTEST_H_INCLUDED
@@ -0,0 +1,151 @@
+#ifndef PROPERTYBENCHMARK_H_INCLUDED
+#define PROPERTYBENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include "allocation-tracer.hpp"
+#include "container.hpp"
+#include "property.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+// a value stored inline if it is small enough
+template<typename T>
+using InlineValue = T;
+
+// a value whose move may throw is stored on the heap, as every value was
+// stored before ValueStorage
+template<typename T>
+struct HeapValue {
+    HeapValue(T value) : value(std::move(value)) { }
+    HeapValue(const HeapValue&) = default;
+    HeapValue(HeapValue&& that) noexcept(false) : value(std::move(that.value)) { }
+    T value;
+};
+
+// the properties of a component, built and copied as when parsing a scene
+template<template<typename> class Value>
+static unsigned int BuildAndCopy(unsigned int entity_id) {
+    std::vector<Property> properties;
+    properties.reserve(6);
+    properties.push_back(Property("mesh"_sym, Value<std::string>(std::string("assets/mesh.md5mesh"))));
+    properties.push_back(Property("entity_id"_sym, Value<unsigned int>(entity_id)));
+    properties.push_back(Property("dynamic"_sym, Value<bool>(true)));
+    properties.push_back(Property("mass"_sym, Value<double>(1.5)));
+    properties.push_back(Property("scale"_sym, Value<float>(2.0f)));
+    properties.push_back(Property("layer"_sym, Value<int>(3)));
+    std::vector<Property> copy(properties);
+    return copy.size();
+}
+
+// the number of allocations of the global operator new done by a function
+template<typename F>
+static uint64_t CountAllocations(F f) {
+    const bool was_enabled = AllocationTracer::Enabled();
+    AllocationTracer::Clear();
+    AllocationTracer::Enable(1);
+    f();
+    AllocationTracer::Disable();
+    uint64_t count = 0;
+    for (auto& site : AllocationTracer::Sites()) {
+        count += site.count;
+    }
+    AllocationTracer::Clear();
+    if (was_enabled) {
+        AllocationTracer::Enable();
+    }
+    return count;
+}
+
+TEST(PropertyBenchmark, SceneLoadAllocations) {
+    const unsigned int nr_component = 100;
+    unsigned int sum = 0;
+    const auto on_heap = CountAllocations([&sum]() {
+        for (unsigned int i = 0; i < nr_component; ++i) {
+            sum += BuildAndCopy<HeapValue>(i);
+        }
+    });
+    const auto in_storage = CountAllocations([&sum]() {
+        for (unsigned int i = 0; i < nr_component; ++i) {
+            sum += BuildAndCopy<InlineValue>(i);
+        }
+    });
+    EXPECT_EQ(2 * 6 * nr_component, sum);
+    std::cout << "[ BENCH    ] properties: " << on_heap / nr_component << " allocations per component on the heap, "
+        << in_storage / nr_component << " inline" << std::endl;
+    // 12 values built or copied per component
+    ASSERT_LE(12 * nr_component, on_heap - in_storage) << "Inline values allocated";
+}
+
+TEST(PropertyBenchmark, DISABLED_SceneLoad) {
+    // the properties of a component, built and copied as when parsing a scene
+    const unsigned int nr_component = 100000;
+    unsigned int sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_component; ++i) {
+        std::vector<Property> properties;
+        properties.push_back(Property("mesh"_sym, std::string("assets/mesh.md5mesh")));
+        properties.push_back(Property("entity_id"_sym, i));
+        properties.push_back(Property("dynamic"_sym, true));
+        properties.push_back(Property("mass"_sym, 1.5));
+        properties.push_back(Property("scale"_sym, 2.0f));
+        properties.push_back(Property("layer"_sym, 3));
+        std::vector<Property> copy(properties);
+        for (auto& p : copy) {
+            if (p.Is<unsigned int>()) {
+                sum += p.Get<unsigned int>();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(0u, sum);
+    std::cout << "[ BENCH    ] properties: " << elapsed.count() / (6 * nr_component)
+        << " ns per property built and copied" << std::endl;
+}
+
+TEST(PropertyBenchmark, DISABLED_RenderList) {
+    // the resolved values of a render list, read at each frame
+    auto shader = std::make_shared<int>(1);
+    const unsigned int nr_frame = 100000;
+    std::list<Container> run_values;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < 1000; ++i) {
+        run_values.clear();
+        run_values.push_back(Container(false));
+        run_values.push_back(Container((long)1));
+        run_values.push_back(Container(shader));
+        run_values.push_back(Container(true));
+    }
+    std::chrono::duration<double, std::nano> build = std::chrono::steady_clock::now() - start;
+    long sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (unsigned int frame = 0; frame < nr_frame; ++frame) {
+        for (auto& value : run_values) {
+            if (value.Is<long>()) {
+                sum += value.Get<long>();
+            }
+            else if (value.Is<bool>()) {
+                sum += value.Get<bool>();
+            }
+            else {
+                sum += *value.Get<std::shared_ptr<int>>();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> read = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(0, sum);
+    std::cout << "[ BENCH    ] containers: build " << build.count() / (4 * 1000) << " ns, read "
+        << read.count() / (4 * nr_frame) << " ns per value" << std::endl;
+}
+
+} // End of benchmark
+} // End of trillek
+
+#endif // PROPERTYBENCHMARK_H_INCLUDED
@@ -3,8 +3,12 @@
 
 #include "gtest/gtest.h"
 #include "gtest/gtest-spi.h"
+#include <list>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
+#include "container.hpp"
 #include "property.hpp"
 
 namespace trillek {
@@ -12,20 +16,20 @@ namespace trillek {
     TEST(PropertyTest, PropertyName) {
         const std::string name = "PropertyTestName";
         int testINT = 10;
-        Property p(name, testINT);
+        Property p(Symbol(name), testINT);
         EXPECT_EQ(name, p.GetName());
     }
     TEST(PropertyTest, PropertyMovePOD) {
         const std::string name = "PropertyTestName";
         int testINT = 10;
-        Property p(name, testINT);
+        Property p(Symbol(name), testINT);
         Property moved_P = std::move(p);
         EXPECT_EQ(10, moved_P.Get<int>());
     }
     TEST(PropertyTest, PropertyCopyPOD) {
         const std::string name = "PropertyTestName";
         int testINT = 10;
-        Property p(name, testINT);
+        Property p(Symbol(name), testINT);
         Property copied_P(p);
         EXPECT_EQ(10, copied_P.Get<int>());
     }
@@ -35,7 +39,7 @@ namespace trillek {
         const std::string name = "PropertyTestName";
         std::vector<int> testVec;
         testVec.push_back(10);
-        Property p(name, testVec);
+        Property p(Symbol(name), testVec);
         Property moved_P = std::move(p);
         EXPECT_EQ(10, moved_P.Get<std::vector<int>>()[0]);
     }
@@ -43,7 +47,7 @@ namespace trillek {
         const std::string name = "PropertyTestName";
         std::vector<int> testVec;
         testVec.push_back(10);
-        Property p(name, testVec);
+        Property p(Symbol(name), testVec);
         Property copied_P(p);
         EXPECT_EQ(10, copied_P.Get<std::vector<int>>()[0]);
     }
@@ -53,7 +57,7 @@ namespace trillek {
         const std::string name = "PropertyTestName";
         int* testINT = new int();
         *testINT = 10;
-        Property p(name, testINT);
+        Property p(Symbol(name), testINT);
         Property moved_P = std::move(p);
         EXPECT_EQ(10, *moved_P.Get<int*>());
         delete testINT;
@@ -62,17 +66,67 @@ namespace trillek {
         const std::string name = "PropertyTestName";
         int* testINT = new int();
         *testINT = 10;
-        Property p(name, testINT);
+        Property p(Symbol(name), testINT);
         Property copied_P(p);
         EXPECT_EQ(10, *copied_P.Get<int*>());
         delete testINT;
     }
 
+    // Small values are stored inline, the others on the heap
+    TEST(PropertyTest, PropertyInline) {
+        EXPECT_TRUE(ValueStorage::IsInline<bool>::value);
+        EXPECT_TRUE(ValueStorage::IsInline<double>::value);
+        EXPECT_TRUE(ValueStorage::IsInline<std::shared_ptr<int>>::value);
+        EXPECT_FALSE(ValueStorage::IsInline<char[64]>::value);
+        const std::string name = "PropertyTestName";
+        std::string long_string(100, 'x');
+        Property p(Symbol(name), long_string);
+        Property copied_P(p);
+        Property moved_P = std::move(p);
+        EXPECT_EQ(long_string, copied_P.Get<std::string>());
+        EXPECT_EQ(long_string, moved_P.Get<std::string>());
+        EXPECT_TRUE(moved_P.Is<std::string>());
+        EXPECT_EQ(sizeof(std::string), moved_P.GetSize());
+    }
+
+    TEST(PropertyTest, ContainerValues) {
+        auto shared = std::make_shared<int>(10);
+        std::list<Container> values;
+        values.push_back(Container(shared));
+        values.push_back(Container((long)1));
+        values.push_back(Container(std::unique_ptr<int>(new int(20))));
+        values.push_back(Container());
+        EXPECT_EQ(2, shared.use_count());
+        auto itr = values.begin();
+        EXPECT_EQ(10, *itr->Get<std::shared_ptr<int>>());
+        EXPECT_EQ(1, (++itr)->Get<long>());
+        EXPECT_EQ(sizeof(std::unique_ptr<int>), (++itr)->GetSize());
+        EXPECT_TRUE((++itr)->IsEmpty());
+        EXPECT_EQ(0, itr->GetType());
+        Container moved = std::move(values.front());
+        EXPECT_TRUE(values.front().IsEmpty());
+        EXPECT_EQ(2, shared.use_count());
+        values.clear();
+        moved = Container(false);
+        EXPECT_EQ(1, shared.use_count());
+        EXPECT_TRUE(moved.Is<bool>());
+    }
+
+    // A value that can't be copied is not silently dropped by a copy
+    TEST(PropertyTest, StorageCopyNotCopyable) {
+        ValueStorage storage(std::unique_ptr<int>(new int(20)));
+        EXPECT_THROW(ValueStorage copy(storage), std::logic_error);
+        ValueStorage other;
+        EXPECT_THROW(other = storage, std::logic_error);
+        EXPECT_TRUE(other.IsEmpty());
+        EXPECT_EQ(20, **storage.Get<std::unique_ptr<int>>());
+    }
+
     // Testing get without a different type than the set
     TEST(PropertyTest, PropertyGetDifferentType_Exception) {
         const std::string name = "PropertyTestName";
         int testINT = 10;
-        Property p2(name, testINT);
+        Property p2(Symbol(name), testINT);
         /*try {
             std::vector<int> bad = p2.Get<std::vector<int>>(); // DOES a SEG FAULT!
             FAIL();
@@ -85,7 +139,7 @@ namespace trillek {
         const std::string name = "PropertyTestName";
         int* testINT = new int();
         *testINT = 10;
-        Property p2(name, testINT);
+        Property p2(Symbol(name), testINT);
         /*try {
             std::vector<int> bad = p2.Get<std::vector<int>>(); // DOES a SEG FAULT
             FAIL();
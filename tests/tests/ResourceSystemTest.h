@@ -20,87 +20,87 @@ namespace trillek {
     // Create a resource at compile time when type information is known.
     TEST(ResSysTest, CreateCompileTime) {
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
-        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test", props);
+        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test"_sym, props);
 
         // This should be true as the resource was created properly.
         ASSERT_TRUE(file != nullptr);
     }
 
     TEST(ResSysTest, Exists) {
-        ASSERT_TRUE(ResourceMap::Exists("test"));
+        ASSERT_TRUE(ResourceMap::Exists("test"_sym));
     }
 
     TEST(ResSysTest, Remove) {
-        ResourceMap::Remove("test");
-        ASSERT_FALSE(ResourceMap::Exists("test"));
+        ResourceMap::Remove("test"_sym);
+        ASSERT_FALSE(ResourceMap::Exists("test"_sym));
     }
 
     // Create a resource at runtime when type information is not known.
     TEST(ResSysTest, CreateRunTime) {
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
         // If we have a valid type id retrieved from within resource system, then registtration was valid.
         // We are using the compile time ID in this instance incase it is changed in source. Normally this
         // woulnd't be used and, instead, would be obtained from the script or other loader.
-        ASSERT_TRUE(ResourceMap::Create(reflection::GetTypeName<TextFile>(), "test", props));
+        ASSERT_TRUE(ResourceMap::Create(reflection::GetTypeName<TextFile>(), "test"_sym, props));
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 
     // Create a resource that doesn't exist.
     TEST(ResSysTest, CreateNonExistent) {
         std::vector<Property> props;
-        Property p("filename", std::string("bad_test.txt"));
+        Property p("filename"_sym, std::string("bad_test.txt"));
         props.push_back(p);
 
-        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test", props);
+        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test"_sym, props);
 
         // This should be true as the resource wasn't created properly.
         ASSERT_TRUE(file == nullptr);
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 
     // Create a resource at runtime when type information is not known.
     TEST(ResSysTest, CreateInvalidType) {
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
         // If we have a valid type id retrieved from within resource system, then registtration was valid.
         // We are using the compile time ID in this instance incase it is changed in source. Normally this
         // woulnd't be used and, instead, would be obtained from the script or other loader.
-        ASSERT_FALSE(ResourceMap::Create("", "test", props));
+        ASSERT_FALSE(ResourceMap::Create("", "test"_sym, props));
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 
     // Attempt to create a resource that already has been created. It should return the already created resource.
     TEST(ResSysTest, CreateAlreadyCreated) {
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
-        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test", props);
+        std::shared_ptr<TextFile> file = ResourceMap::Create<TextFile>("test"_sym, props);
 
-        std::shared_ptr<TextFile> file2 = ResourceMap::Create<TextFile>("test", props);
+        std::shared_ptr<TextFile> file2 = ResourceMap::Create<TextFile>("test"_sym, props);
 
         ASSERT_EQ(file.get(), file2.get());
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 
     // Add a resource create in memory. Also checks if it keeps a strong reference.
@@ -108,23 +108,23 @@ namespace trillek {
         std::shared_ptr<TextFile> file(new TextFile());
 
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
         file->Initialize(props);
 
-        ResourceMap::Add<TextFile>("test", file);
+        ResourceMap::Add<TextFile>("test"_sym, file);
 
-        ASSERT_TRUE(ResourceMap::Exists("test"));
+        ASSERT_TRUE(ResourceMap::Exists("test"_sym));
 
         // Check to make sure it still exists after the local strong reference is gone.
         file.reset();
 
-        ASSERT_TRUE(ResourceMap::Exists("test"));
+        ASSERT_TRUE(ResourceMap::Exists("test"_sym));
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 
     // Add a resource create in memory. Also checks if it keeps a strong reference.
@@ -132,14 +132,14 @@ namespace trillek {
         std::shared_ptr<TextFile> file(new TextFile());
 
         std::vector<Property> props;
-        Property p("filename", std::string("assets/tests/test.txt"));
+        Property p("filename"_sym, std::string("assets/tests/test.txt"));
         props.push_back(p);
 
         file->Initialize(props);
 
-        ResourceMap::Add<TextFile>("test", file);
+        ResourceMap::Add<TextFile>("test"_sym, file);
 
-        std::shared_ptr<TextFile> file2 = ResourceMap::Get<TextFile>("test");
+        std::shared_ptr<TextFile> file2 = ResourceMap::Get<TextFile>("test"_sym);
 
         file->AppendText("?");
 
@@ -147,7 +147,7 @@ namespace trillek {
 
         // We must make sure to remove the resource each time as resource system is a singleton and the
         // resource will persist.
-        ResourceMap::Remove("test");
+        ResourceMap::Remove("test"_sym);
     }
 }
 
@@ -0,0 +1,398 @@
+#ifndef SCHEDULERBENCHMARK_H_INCLUDED
+#define SCHEDULERBENCHMARK_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "scheduler/task-pool.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+// the index of the benchmark thread that runs a task
+static thread_local unsigned int bench_worker = TaskPool::NO_WORKER;
+
+/** \brief A task that does a bit of work and spawns two children
+ *
+ * This is the fan-out pattern of the systems splitting their job.
+ */
+class ForkTask : public TaskRequestBase {
+public:
+    ForkTask(TaskPool& pool, std::atomic<int>& budget) :
+        TaskRequestBase(frame_tp()), pool(pool), budget(budget) {};
+
+    void RunTask() override {
+        volatile unsigned int work = 0;
+        for (unsigned int i = 0; i < 64; ++i) {
+            work = work + i;
+        }
+        for (int c = 0; c < 2; ++c) {
+            if (budget.fetch_sub(1) > 0) {
+                pool.Push(std::make_shared<ForkTask>(pool, budget), bench_worker, frame_tp());
+            }
+        }
+    }
+
+private:
+    TaskPool& pool;
+    std::atomic<int>& budget;
+};
+
+/** \brief Run nr_tasks tasks with nr_thread threads
+ *
+ * \return double the throughput in tasks per second
+ */
+static double PoolThroughput(TaskPool& pool, unsigned int nr_thread, int nr_tasks) {
+    std::atomic<int> budget(nr_tasks - 1);
+    std::atomic<int> done(0);
+    pool.Push(std::make_shared<ForkTask>(pool, budget), TaskPool::NO_WORKER, frame_tp());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nr_thread; ++i) {
+        threads.push_back(std::thread([&pool, &done, nr_tasks, i] () {
+            bench_worker = i;
+            std::shared_ptr<TaskRequestBase> task;
+            while (done.load() < nr_tasks) {
+                if (pool.Pop(task, i, frame_tp())) {
+                    task->RunTask();
+                    done.fetch_add(1);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return nr_tasks / elapsed.count();
+}
+
+TEST(SchedulerBenchmark, DISABLED_WorkStealingThroughput) {
+    const int nr_tasks = 200000;
+    for (unsigned int nr_thread : {4, 8, 16, 32}) {
+        GlobalTaskPool global;
+        WorkStealingTaskPool stealing(nr_thread);
+        double global_tput = PoolThroughput(global, nr_thread, nr_tasks);
+        double stealing_tput = PoolThroughput(stealing, nr_thread, nr_tasks);
+        EXPECT_EQ(0, global.Size()) << "Global queue not drained";
+        EXPECT_EQ(0, stealing.Size()) << "Work-stealing pool not drained";
+        std::cout << "[ BENCH    ] " << nr_thread << " threads: global queue "
+                  << static_cast<long>(global_tput) << " tasks/s, work stealing "
+                  << static_cast<long>(stealing_tput) << " tasks/s" << std::endl;
+    }
+}
+
+/** \brief A task that only carries a timestamp
+ */
+class TimerTask : public TaskRequestBase {
+public:
+    TimerTask(const frame_tp& timestamp) : TaskRequestBase(frame_tp(timestamp)) {};
+
+    void RunTask() override {};
+};
+
+/** \brief Queue nr_timers delayed tasks in a pool, then pop them frame after frame
+ *
+ * The delays are spread over one second, and the pool is polled every
+ * millisecond, as a worker waiting for the next timer would do.
+ *
+ * \return double the number of timers going through the pool per second
+ */
+static double TimerThroughput(TaskPool& pool, int nr_timers) {
+    const frame_tp t0(frame_unit(1000000000));
+    std::vector<std::shared_ptr<TaskRequestBase>> tasks;
+    for (int i = 0; i < nr_timers; ++i) {
+        tasks.push_back(std::make_shared<TimerTask>(t0 + frame_unit(((i * 7919LL) % 1000000) * 1000)));
+    }
+    int popped = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& t : tasks) {
+        pool.Push(std::move(t), 0, t0);
+    }
+    std::shared_ptr<TaskRequestBase> task;
+    for (frame_tp now = t0; popped < nr_timers; now += std::chrono::milliseconds(1)) {
+        while (pool.Pop(task, 0, now)) {
+            ++popped;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return nr_timers / elapsed.count();
+}
+
+TEST(SchedulerBenchmark, DISABLED_TimerThroughput) {
+    for (int nr_timers : {1000, 10000, 100000}) {
+        // a heap alone is what the pools used before the timer wheel
+        task_heap heap;
+        const frame_tp t0(frame_unit(1000000000));
+        std::vector<std::shared_ptr<TaskRequestBase>> tasks;
+        for (int i = 0; i < nr_timers; ++i) {
+            tasks.push_back(std::make_shared<TimerTask>(t0 + frame_unit(((i * 7919LL) % 1000000) * 1000)));
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (auto& t : tasks) {
+            heap.push(std::move(t));
+        }
+        for (frame_tp now = t0; ! heap.empty(); now += std::chrono::milliseconds(1)) {
+            while (! heap.empty() && ! (now < heap.top()->Timepoint())) {
+                heap.pop();
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        GlobalTaskPool global;
+        WorkStealingTaskPool stealing(4);
+        double global_tput = TimerThroughput(global, nr_timers);
+        double stealing_tput = TimerThroughput(stealing, nr_timers);
+        EXPECT_EQ(0, global.Size()) << "Global queue not drained";
+        EXPECT_EQ(0, stealing.Size()) << "Work-stealing pool not drained";
+        std::cout << "[ BENCH    ] " << nr_timers << " timers: heap "
+                  << static_cast<long>(nr_timers / elapsed.count()) << " timers/s, global queue "
+                  << static_cast<long>(global_tput) << " timers/s, work stealing "
+                  << static_cast<long>(stealing_tput) << " timers/s" << std::endl;
+    }
+}
+
+/** \brief Run a chain of nr_steps blocks, each suspending the chain once
+ *
+ * \param copy bool true to copy the chain task at each resume, as it was done
+ * before the chain tasks were resumed in place
+ * \return double the number of steps per second
+ */
+static double ChainThroughput(int nr_steps, int result, bool copy) {
+    std::deque<std::shared_ptr<TaskRequest<chain_t>>> queued;
+    TaskRequest<chain_t>::Initialize([&queued, copy](std::shared_ptr<TaskRequest<chain_t>>&& c, frame_unit&& delay) {
+        if (copy) {
+            queued.push_back(std::make_shared<TaskRequest<chain_t>>(*c));
+        }
+        else {
+            queued.push_back(std::move(c));
+        }
+    }, frame_unit(0));
+    // each block returns the result on its first call, then CONTINUE or STOP
+    std::vector<char> called(nr_steps, 0);
+    chain_t chain;
+    for (int i = 0; i < nr_steps; ++i) {
+        char* c = &called[i];
+        chain.push_back([c, result]() {
+            if (! *c) {
+                *c = 1;
+                return result;
+            }
+            // the fork of a SPLIT only runs this block
+            return result == SPLIT ? STOP : CONTINUE;
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    queued.push_back(std::make_shared<TaskRequest<chain_t>>(chain));
+    while (! queued.empty()) {
+        auto task = std::move(queued.front());
+        queued.pop_front();
+        task->RunTask();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return nr_steps / elapsed.count();
+}
+
+TEST(SchedulerBenchmark, DISABLED_ChainThroughput) {
+    const int nr_steps = 10000;
+    double requeue_copy = ChainThroughput(nr_steps, REQUEUE, true);
+    double requeue = ChainThroughput(nr_steps, REQUEUE, false);
+    double split = ChainThroughput(nr_steps, SPLIT, false);
+    std::cout << "[ BENCH    ] chain of " << nr_steps << " steps: requeue with copy "
+              << static_cast<long>(requeue_copy) << " steps/s, requeue in place "
+              << static_cast<long>(requeue) << " steps/s, split with recycled forks "
+              << static_cast<long>(split) << " steps/s" << std::endl;
+}
+
+/** \brief Submit nr_tasks tasks to a pool drained by nr_thread sleeping threads
+ *
+ * The threads sleep as the workers of the scheduler do when the pool is
+ * empty. The tasks are submitted one by one with a wake-up each, or in one
+ * batch waking up at most one thread per task.
+ *
+ * \param batch bool true to submit the tasks in one batch
+ * \return double the time spent submitting, in nanoseconds per task
+ */
+static double SubmitCost(TaskPool& pool, unsigned int nr_thread, int nr_tasks, bool batch) {
+    std::mutex m_sleep;
+    std::condition_variable queuecheck;
+    std::atomic<unsigned int> sleepers(0);
+    std::atomic<int> done(0);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nr_thread; ++i) {
+        threads.push_back(std::thread([&, i] () {
+            std::shared_ptr<TaskRequestBase> task;
+            while (done.load() < nr_tasks) {
+                if (pool.Pop(task, i, frame_tp())) {
+                    task->RunTask();
+                    done.fetch_add(1);
+                    continue;
+                }
+                std::unique_lock<std::mutex> locker(m_sleep);
+                sleepers.fetch_add(1);
+                if (! pool.Size() && done.load() < nr_tasks) {
+                    queuecheck.wait_for(locker, std::chrono::milliseconds(10));
+                }
+                sleepers.fetch_sub(1);
+            }
+        }));
+    }
+    std::vector<std::shared_ptr<TaskRequestBase>> tasks;
+    for (int i = 0; i < nr_tasks; ++i) {
+        tasks.push_back(std::make_shared<TimerTask>(frame_tp()));
+    }
+    // let the threads fall asleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto start = std::chrono::steady_clock::now();
+    if (batch) {
+        pool.PushBatch(tasks, TaskPool::NO_WORKER, frame_tp());
+        const unsigned int nr_sleeper = sleepers.load();
+        if (nr_sleeper) {
+            { std::lock_guard<std::mutex> locker(m_sleep); }
+            queuecheck.notify_all();
+        }
+    }
+    else {
+        for (auto& t : tasks) {
+            pool.Push(std::move(t), TaskPool::NO_WORKER, frame_tp());
+            if (sleepers.load()) {
+                { std::lock_guard<std::mutex> locker(m_sleep); }
+                queuecheck.notify_one();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    for (auto& t : threads) {
+        t.join();
+    }
+    return elapsed.count() / nr_tasks;
+}
+
+TEST(SchedulerBenchmark, DISABLED_SubmitCost) {
+    const int nr_tasks = 100000;
+    const unsigned int nr_thread = 4;
+    for (bool stealing : {false, true}) {
+        std::unique_ptr<TaskPool> single(stealing ? static_cast<TaskPool*>(new WorkStealingTaskPool(nr_thread))
+                                                  : new GlobalTaskPool());
+        std::unique_ptr<TaskPool> batched(stealing ? static_cast<TaskPool*>(new WorkStealingTaskPool(nr_thread))
+                                                   : new GlobalTaskPool());
+        double single_cost = SubmitCost(*single, nr_thread, nr_tasks, false);
+        double batch_cost = SubmitCost(*batched, nr_thread, nr_tasks, true);
+        EXPECT_EQ(0, single->Size()) << "Pool not drained";
+        EXPECT_EQ(0, batched->Size()) << "Pool not drained";
+        std::cout << "[ BENCH    ] submit " << nr_tasks << " tasks to "
+                  << (stealing ? "work stealing" : "global queue") << ": one by one "
+                  << single_cost << " ns/task, batch " << batch_cost << " ns/task" << std::endl;
+    }
+}
+
+/** \brief A task keeping its thread busy for a while
+ */
+class SpinTask : public TaskRequestBase {
+public:
+    SpinTask(const frame_tp& timestamp, const frame_unit& work, std::atomic<int>* done) :
+        TaskRequestBase(frame_tp(timestamp)), work(work), done(done) {};
+
+    void RunTask() override {
+        auto end = std::chrono::steady_clock::now() + work;
+        while (std::chrono::steady_clock::now() < end) {}
+        if (done) {
+            done->fetch_add(1);
+        }
+    }
+
+private:
+    const frame_unit work;
+    std::atomic<int>* const done;
+};
+
+/** \brief Run frames of frame-critical tasks while a backlog of background tasks is waiting
+ *
+ * The background tasks are queued before the frame. With lanes they are in
+ * the background class, without lanes they are frame-critical, so that they
+ * are ordered by timestamp with the tasks of the frame.
+ *
+ * \param frame_times std::vector<double>& the time to run the tasks of each frame, in microseconds
+ */
+static void FrameJitter(TaskPool& pool, bool lanes, unsigned int nr_thread, int nr_frames, std::vector<double>& frame_times) {
+    const frame_tp now(frame_unit(1000));
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nr_thread; ++i) {
+        threads.push_back(std::thread([&pool, &stop, &now, i] () {
+            std::shared_ptr<TaskRequestBase> task;
+            while (! stop.load()) {
+                if (pool.Pop(task, i, now)) {
+                    task->RunTask();
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+    const int nr_critical = 16;
+    for (int f = 0; f < nr_frames; ++f) {
+        while (pool.Size() < 32) {
+            auto task = std::make_shared<SpinTask>(frame_tp(), std::chrono::microseconds(50), nullptr);
+            task->SetClass(lanes ? TaskClass::BACKGROUND_IO : TaskClass::FRAME_CRITICAL);
+            pool.Push(std::move(task), TaskPool::NO_WORKER, now);
+        }
+        std::atomic<int> done(0);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nr_critical; ++i) {
+            pool.Push(std::make_shared<SpinTask>(now, std::chrono::microseconds(20), &done), TaskPool::NO_WORKER, now);
+        }
+        while (done.load() < nr_critical) {
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        frame_times.push_back(elapsed.count());
+    }
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+TEST(SchedulerBenchmark, DISABLED_FrameJitter) {
+    // one hardware thread is left to the thread queuing the frames
+    const unsigned int nr_thread = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    for (bool stealing : {false, true}) {
+        for (bool lanes : {false, true}) {
+            std::unique_ptr<TaskPool> pool(stealing ? static_cast<TaskPool*>(new WorkStealingTaskPool(nr_thread))
+                                                    : new GlobalTaskPool());
+            std::vector<double> times;
+            FrameJitter(*pool, lanes, nr_thread, 100, times);
+            double mean = 0, var = 0, max = 0;
+            for (auto t : times) {
+                mean += t / times.size();
+                max = std::max(max, t);
+            }
+            for (auto t : times) {
+                var += (t - mean) * (t - mean) / times.size();
+            }
+            std::cout << "[ BENCH    ] frame under background load, "
+                      << (stealing ? "work stealing" : "global queue") << (lanes ? " with lanes" : " one lane")
+                      << ": mean " << static_cast<long>(mean) << " us, stddev " << static_cast<long>(std::sqrt(var))
+                      << " us, max " << static_cast<long>(max) << " us" << std::endl;
+        }
+    }
+}
+
+} // namespace benchmark
+} // namespace trillek
+
+#endif // SCHEDULERBENCHMARK_H_INCLUDED
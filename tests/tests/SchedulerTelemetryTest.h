@@ -0,0 +1,65 @@
+#ifndef SCHEDULERTELEMETRYTEST_H_INCLUDED
+#define SCHEDULERTELEMETRYTEST_H_INCLUDED
+
+#include <sstream>
+#include "scheduler/scheduler-telemetry.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(SchedulerTelemetryTest, HistogramBuckets) {
+    LatencyHistogram histogram;
+    histogram.Record(frame_unit(0));
+    histogram.Record(frame_unit(1));
+    histogram.Record(frame_unit(1000));
+    histogram.Record(frame_unit(-5));
+    ASSERT_EQ(4, histogram.Count()) << "Wrong number of samples";
+    ASSERT_EQ(3, histogram.Bucket(0)) << "Short durations not in the first bucket";
+    // 512 <= 1000 < 1024
+    ASSERT_EQ(1, histogram.Bucket(9)) << "Duration not in its power of 2 bucket";
+    ASSERT_EQ(frame_unit(250), histogram.Mean()) << "Wrong mean";
+    ASSERT_EQ(frame_unit(1), histogram.Percentile(50)) << "Wrong median bound";
+    ASSERT_EQ(frame_unit(1023), histogram.Percentile(100)) << "Wrong maximum bound";
+}
+
+TEST(SchedulerTelemetryTest, Workers) {
+    SchedulerTelemetry telemetry;
+    telemetry.Initialize(2);
+    telemetry.RecordTask(0, frame_unit(100), frame_unit(2000));
+    telemetry.RecordTask(0, frame_unit(100), frame_unit(3000));
+    telemetry.RecordTask(1, frame_unit(5000), frame_unit(1000));
+    telemetry.RecordIdle(1, frame_unit(7000));
+    // not a worker
+    telemetry.RecordTask(~0u, frame_unit(1), frame_unit(1));
+
+    ASSERT_EQ(2, telemetry.Worker(0).tasks) << "Wrong number of tasks of the worker";
+    ASSERT_EQ(frame_unit(5000), telemetry.Worker(0).busy) << "Wrong busy time";
+    ASSERT_EQ(frame_unit(7000), telemetry.Worker(1).idle) << "Wrong idle time";
+    ASSERT_EQ(3, telemetry.WaitTimes().Count()) << "Wait times of the workers not merged";
+    ASSERT_EQ(3, telemetry.RunTimes().Count()) << "Run times of the workers not merged";
+}
+
+TEST(SchedulerTelemetryTest, Frames) {
+    SchedulerTelemetry telemetry;
+    for (size_t i = 0; i < SchedulerTelemetry::DEPTH_SAMPLES + 3; ++i) {
+        telemetry.RecordFrameStart(frame_unit(10), i);
+        telemetry.RecordFrameEnd(frame_unit(i % 2 ? 200 : 50), frame_unit(100));
+    }
+    ASSERT_EQ(SchedulerTelemetry::DEPTH_SAMPLES / 2 + 1, telemetry.FrameOverruns()) << "Wrong number of overruns";
+    auto depths = telemetry.QueueDepths();
+    ASSERT_EQ(SchedulerTelemetry::DEPTH_SAMPLES, depths.size()) << "Wrong number of samples kept";
+    ASSERT_EQ(3, depths.front()) << "Oldest samples not dropped";
+    ASSERT_EQ(SchedulerTelemetry::DEPTH_SAMPLES + 2, depths.back()) << "Last sample not kept";
+
+    std::ostringstream out;
+    telemetry.Dump(out);
+    ASSERT_NE(std::string::npos, out.str().find("frame overruns: 129")) << "Overruns not reported";
+    telemetry.Reset();
+    ASSERT_EQ(0, telemetry.FrameOverruns()) << "Overruns not reset";
+    ASSERT_TRUE(telemetry.QueueDepths().empty()) << "Samples not reset";
+}
+
+} // namespace trillek
+
+#endif // SCHEDULERTELEMETRYTEST_H_INCLUDED
@@ -0,0 +1,108 @@
+#ifndef SYMBOLBENCHMARK_H_INCLUDED
+#define SYMBOLBENCHMARK_H_INCLUDED
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "property.hpp"
+#include "symbol.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+namespace benchmark {
+
+static const char* const uniform_names[] = {
+    "model", "animation_matrix", "animated", "light_pos", "light_color", "light_dir", "light_type",
+    "shadow_enabled", "shadow_matrix", "shadow_depth", "layer0", "layer1", "layer2", "layer3", "inv_proj"
+};
+
+TEST(SymbolBenchmark, DISABLED_UniformLookup) {
+    // the uniform locations of a shader, looked up by name at each frame
+    const unsigned int nr_round = 100000;
+    std::map<std::string, int> by_string;
+    std::unordered_map<Symbol, int> by_symbol;
+    int location = 0;
+    for (auto name : uniform_names) {
+        by_string[name] = location;
+        by_symbol[Symbol(name)] = location++;
+    }
+    int sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_round; ++i) {
+        sum += by_string.find("light_pos")->second + by_string.find("shadow_matrix")->second
+            + by_string.find("model")->second + by_string.find("layer3")->second;
+    }
+    std::chrono::duration<double, std::nano> strings = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_round; ++i) {
+        sum += by_symbol.find("light_pos"_sym)->second + by_symbol.find("shadow_matrix"_sym)->second
+            + by_symbol.find("model"_sym)->second + by_symbol.find("layer3"_sym)->second;
+    }
+    std::chrono::duration<double, std::nano> symbols = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(0, sum);
+    std::cout << "[ BENCH    ] uniform lookup: std::string " << strings.count() / (4 * nr_round)
+        << " ns, symbol " << symbols.count() / (4 * nr_round) << " ns" << std::endl;
+}
+
+TEST(SymbolBenchmark, DISABLED_PropertyNames) {
+    // the loop of an Initialize(properties)
+    std::vector<Property> properties;
+    properties.push_back(Property("radius"_sym, 1.0));
+    properties.push_back(Property("disable_deactivation"_sym, true));
+    properties.push_back(Property("mass"_sym, 2.0));
+    properties.push_back(Property("height"_sym, 3.0));
+    properties.push_back(Property("shape"_sym, std::string("capsule")));
+    properties.push_back(Property("entity_id"_sym, 4u));
+    const unsigned int nr_round = 100000;
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_round; ++i) {
+        for (const Property& p : properties) {
+            std::string name = p.GetName();
+            if (name == "radius") {
+                sum += p.Get<double>();
+            }
+            else if (name == "mass") {
+                sum += p.Get<double>();
+            }
+            else if (name == "height") {
+                sum += p.Get<double>();
+            }
+            else if (name == "entity_id") {
+                sum += p.Get<unsigned int>();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> strings = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nr_round; ++i) {
+        for (const Property& p : properties) {
+            Symbol name = p.GetSymbol();
+            if (name == "radius"_sym) {
+                sum += p.Get<double>();
+            }
+            else if (name == "mass"_sym) {
+                sum += p.Get<double>();
+            }
+            else if (name == "height"_sym) {
+                sum += p.Get<double>();
+            }
+            else if (name == "entity_id"_sym) {
+                sum += p.Get<unsigned int>();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> symbols = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(0, sum);
+    std::cout << "[ BENCH    ] property names: std::string " << strings.count() / (6 * nr_round)
+        << " ns, symbol " << symbols.count() / (6 * nr_round) << " ns per property" << std::endl;
+}
+
+} // End of benchmark
+} // End of trillek
+
+#endif // SYMBOLBENCHMARK_H_INCLUDED
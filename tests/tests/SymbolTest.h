@@ -0,0 +1,83 @@
+#ifndef SYMBOLTEST_H_INCLUDED
+#define SYMBOLTEST_H_INCLUDED
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "property.hpp"
+#include "symbol.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// the literals are hashed at compile time
+static_assert("mesh"_sym.GetID() == Symbol::Hash("mesh", 4), "Symbol literal not constant");
+static_assert("mesh"_sym != "shader"_sym, "Symbol literals collide");
+// interning is never implicit
+static_assert(!std::is_convertible<std::string, Symbol>::value, "std::string converts to Symbol");
+static_assert(!std::is_convertible<const char*, Symbol>::value, "const char* converts to Symbol");
+
+TEST(SymbolTest, Intern) {
+    const std::string name("light_color");
+    Symbol runtime(name);
+    EXPECT_EQ("light_color"_sym, runtime);
+    EXPECT_EQ("light_color"_sym.GetID(), runtime.GetID());
+    EXPECT_EQ(name, runtime.GetName());
+    EXPECT_EQ(name, std::string("light_color"_sym.GetName()));
+    // the interned name is shared
+    EXPECT_EQ(runtime.GetName(), Symbol("light_color").GetName());
+    EXPECT_NE("light_colour"_sym, runtime);
+    EXPECT_EQ(Symbol(), Symbol(std::string()));
+    EXPECT_EQ(std::string(), Symbol().GetName());
+
+    switch (runtime.GetID()) {
+    case "light_pos"_sym.GetID():
+        FAIL() << "Wrong case";
+        break;
+    case "light_color"_sym.GetID():
+        break;
+    default:
+        FAIL() << "No case";
+    }
+}
+
+TEST(SymbolTest, Lookup) {
+    std::unordered_map<Symbol, int> uniforms;
+    uniforms[Symbol(std::string("model"))] = 1;
+    uniforms["view"_sym] = 2;
+    EXPECT_EQ(1, uniforms["model"_sym]);
+    EXPECT_EQ(2, uniforms[Symbol("view")]);
+    EXPECT_EQ(2u, uniforms.size());
+
+    Property p(Symbol(std::string("entity_id")), 5u);
+    EXPECT_EQ("entity_id"_sym, p.GetSymbol());
+    EXPECT_EQ("entity_id", p.GetName());
+}
+
+TEST(SymbolTest, Threads) {
+    // the same strings interned by several threads give the same names
+    std::vector<std::thread> threads;
+    std::vector<const char*> names(4);
+    for (unsigned int t = 0; t < names.size(); ++t) {
+        threads.push_back(std::thread([t, &names] () {
+            for (int i = 0; i < 1000; ++i) {
+                Symbol(std::to_string(i));
+            }
+            names[t] = Symbol(std::string("shadow_depth")).GetName();
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto name : names) {
+        EXPECT_EQ(names[0], name);
+    }
+    EXPECT_EQ(Symbol("999"), Symbol::FromLiteral("999", 3));
+}
+
+} // End of trillek
+
+#endif // SYMBOLTEST_H_INCLUDED
@@ -0,0 +1,235 @@
+#ifndef SYSTEMGRAPHTEST_H_INCLUDED
+#define SYSTEMGRAPHTEST_H_INCLUDED
+
+#include <queue>
+#include <string>
+#include <vector>
+#include "systems/system-base.hpp"
+#include "scheduler/system-graph.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// a system recording its calls in a log
+class LogSystem : public SystemBase {
+public:
+    LogSystem(const std::string& name, std::vector<std::string>& log, bool bound = false) :
+        name(name), log(log), bound(bound) {};
+
+    void ThreadInit() override { log.push_back("init " + name); };
+    void HandleEvents(const frame_tp& timepoint) override { frame = timepoint; };
+    void RunBatch() const override { log.push_back(name); };
+    void Terminate() override { log.push_back("terminate " + name); };
+    bool ThreadBound() const override { return bound; };
+
+    void Reads(SystemData data) { DeclareRead(data); };
+    void Writes(SystemData data) { DeclareWrite(data); };
+
+    const std::string name;
+    std::vector<std::string>& log;
+    const bool bound;
+    frame_tp frame;
+};
+
+// the tasks queued by a graph, and the worker they are queued on
+struct QueuedTasks {
+    std::vector<std::pair<std::shared_ptr<TaskRequestBase>,unsigned int>> tasks;
+    int frames_done = 0;
+
+    SystemGraph::push_t Push() {
+        return [this](std::shared_ptr<TaskRequestBase>&& task, unsigned int worker) {
+            tasks.push_back(std::make_pair(std::move(task), worker));
+        };
+    }
+
+    std::function<void(void)> Done() {
+        return [this]() { ++frames_done; };
+    }
+
+    // run the task queued at a position
+    void Run(size_t i) {
+        auto task = tasks[i].first;
+        tasks.erase(tasks.begin() + i);
+        task->RunTask();
+    }
+};
+
+TEST(SystemGraphTest, WriterBeforeReaders) {
+    std::vector<std::string> log;
+    LogSystem physics("physics", log), graphics("graphics", log, true), sound("sound", log);
+    physics.Writes(SystemData::TRANSFORMS);
+    graphics.Reads(SystemData::TRANSFORMS);
+    sound.Reads(SystemData::TRANSFORMS);
+    std::queue<SystemBase*> systems;
+    systems.push(&physics);
+    systems.push(&graphics);
+    systems.push(&sound);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    const frame_tp t0(frame_unit(1000));
+    graph.Build(systems, 2, t0, frame_unit(100));
+    ASSERT_EQ(3, graph.Size()) << "Systems not registered";
+    ASSERT_TRUE(systems.empty()) << "Queue of systems not emptied";
+    ASSERT_EQ(t0 + frame_unit(100), graph.NextFrame()) << "Wrong first frame";
+    ASSERT_FALSE(graph.StartFrame(t0)) << "Frame started before its timepoint";
+    ASSERT_TRUE(graph.StartFrame(t0 + frame_unit(100))) << "Frame not started";
+    ASSERT_FALSE(graph.Idle()) << "Running frame reported idle";
+    ASSERT_FALSE(graph.StartFrame(t0 + frame_unit(200))) << "Frame started while the previous is running";
+    ASSERT_EQ(1, q.tasks.size()) << "Readers queued before the writer";
+    ASSERT_EQ(TaskPool::NO_WORKER, q.tasks[0].second) << "Unbound system queued on a worker";
+
+    q.Run(0);
+    ASSERT_EQ(2, q.tasks.size()) << "Readers not queued after the writer";
+    ASSERT_EQ(1, q.tasks[0].second) << "Bound system not queued on its home worker";
+    ASSERT_EQ(TaskPool::NO_WORKER, q.tasks[1].second) << "Unbound system queued on a worker";
+    q.Run(1);
+    ASSERT_EQ(0, q.frames_done) << "Frame done before all the systems";
+    q.Run(0);
+    ASSERT_EQ(1, q.frames_done) << "Frame not done";
+    ASSERT_TRUE(graph.Idle()) << "Finished frame not idle";
+    ASSERT_EQ(std::vector<std::string>({"physics", "sound", "graphics"}), log) << "Wrong order";
+    ASSERT_EQ(t0 + frame_unit(100), sound.frame) << "Wrong frame passed to the system";
+
+    // the late frame begins immediately
+    ASSERT_TRUE(graph.StartFrame(t0 + frame_unit(250))) << "Next frame not started";
+    ASSERT_EQ(1, q.tasks.size()) << "Readers queued before the writer";
+    ASSERT_EQ(t0 + frame_unit(300), graph.NextFrame()) << "Wrong next frame";
+}
+
+TEST(SystemGraphTest, WriterAfterReaders) {
+    std::vector<std::string> log;
+    LogSystem reader("reader", log), writer("writer", log), other("other", log);
+    reader.Reads(SystemData::TRANSFORMS);
+    writer.Writes(SystemData::TRANSFORMS);
+    std::queue<SystemBase*> systems;
+    systems.push(&reader);
+    systems.push(&writer);
+    systems.push(&other);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    const frame_tp t0(frame_unit(1000));
+    graph.Build(systems, 4, t0, frame_unit(100));
+    ASSERT_TRUE(graph.StartFrame(t0 + frame_unit(100))) << "Frame not started";
+    ASSERT_EQ(2, q.tasks.size()) << "Independent systems not queued together";
+    q.Run(0);
+    ASSERT_EQ(2, q.tasks.size()) << "Writer not queued after the reader";
+    q.Run(0);
+    q.Run(0);
+    ASSERT_EQ(std::vector<std::string>({"reader", "other", "writer"}), log) << "Wrong order";
+    ASSERT_TRUE(graph.Idle()) << "Finished frame not idle";
+}
+
+TEST(SystemGraphTest, HomeWorker) {
+    std::vector<std::string> log;
+    LogSystem a("a", log), b("b", log), c("c", log);
+    std::queue<SystemBase*> systems;
+    systems.push(&a);
+    systems.push(&b);
+    systems.push(&c);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    graph.Build(systems, 2, frame_tp(), frame_unit(100));
+    graph.ThreadInit(0);
+    graph.Terminate(1);
+    ASSERT_EQ(std::vector<std::string>({"init a", "init c", "terminate b"}), log) << "Wrong home workers";
+}
+
+TEST(SystemGraphTest, Stop) {
+    std::vector<std::string> log;
+    LogSystem a("a", log);
+    std::queue<SystemBase*> systems;
+    systems.push(&a);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    const frame_tp t0(frame_unit(1000));
+    graph.Build(systems, 1, t0, frame_unit(100));
+    ASSERT_TRUE(graph.StartFrame(t0 + frame_unit(100))) << "Frame not started";
+    ASSERT_FALSE(graph.Stop()) << "Graph stopped while a frame is running";
+    q.Run(0);
+    ASSERT_TRUE(graph.Stop()) << "Idle graph not stopped";
+    ASSERT_TRUE(graph.Stop()) << "Stopped graph not reported";
+    ASSERT_TRUE(graph.Idle()) << "Stopped graph not idle";
+    ASSERT_FALSE(graph.StartFrame(t0 + frame_unit(200))) << "Frame started after the stop";
+    ASSERT_TRUE(q.tasks.empty()) << "System queued after the stop";
+}
+
+TEST(SystemGraphTest, TickRates) {
+    std::vector<std::string> log;
+    LogSystem physics("physics", log), graphics("graphics", log), sound("sound", log);
+    physics.Writes(SystemData::TRANSFORMS);
+    graphics.Reads(SystemData::TRANSFORMS);
+    sound.Reads(SystemData::TRANSFORMS);
+    // periods of 100, 200 (the frame) and 400 ns
+    physics.SetTickRate(10000000);
+    sound.SetTickRate(2500000);
+    std::queue<SystemBase*> systems;
+    systems.push(&physics);
+    systems.push(&graphics);
+    systems.push(&sound);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    const frame_tp t0(frame_unit(1000));
+    graph.Build(systems, 1, t0, frame_unit(200));
+    for (int tick = 1; tick <= 4; ++tick) {
+        const frame_tp now = t0 + frame_unit(100 * tick);
+        ASSERT_EQ(now, graph.NextFrame()) << "Wrong next frame";
+        ASSERT_TRUE(graph.StartFrame(now)) << "Frame not started";
+        ASSERT_EQ(now + frame_unit(100), q.tasks[0].first->Deadline()) << "Tick not due by the next tick";
+        while (! q.tasks.empty()) {
+            q.Run(0);
+        }
+        log.push_back("|");
+    }
+    ASSERT_EQ(std::vector<std::string>({"physics", "|", "physics", "graphics", "|", "physics", "|",
+                                        "physics", "graphics", "sound", "|"}), log) << "Wrong ticks";
+    ASSERT_EQ(t0 + frame_unit(400), sound.frame) << "Wrong tick passed to the system";
+    ASSERT_EQ(4, graph.GetTickStats(&physics).ticks) << "Wrong number of ticks";
+    ASSERT_EQ(1, graph.GetTickStats(&sound).ticks) << "Wrong number of ticks";
+}
+
+TEST(SystemGraphTest, CatchUpPolicies) {
+    std::vector<std::string> log;
+    LogSystem skip("skip", log), clamp("clamp", log), burst("burst", log);
+    skip.SetTickRate(10000000, CatchUpPolicy::SKIP);
+    clamp.SetTickRate(10000000, CatchUpPolicy::CLAMP, 2);
+    burst.SetTickRate(10000000, CatchUpPolicy::BURST);
+    std::queue<SystemBase*> systems;
+    systems.push(&skip);
+    systems.push(&clamp);
+    systems.push(&burst);
+
+    QueuedTasks q;
+    SystemGraph graph(q.Push(), q.Done());
+    const frame_tp t0(frame_unit(1000));
+    graph.Build(systems, 1, t0, frame_unit(200));
+    // 4 ticks late
+    const frame_tp now = t0 + frame_unit(550);
+    while (graph.StartFrame(now)) {
+        while (! q.tasks.empty()) {
+            q.Run(0);
+        }
+    }
+    ASSERT_EQ(t0 + frame_unit(600), graph.NextFrame()) << "Late ticks not caught up";
+    auto stats = graph.GetTickStats(&skip);
+    ASSERT_EQ(1, stats.ticks) << "SKIP ran late ticks";
+    ASSERT_EQ(1, stats.overruns) << "Wrong overruns with SKIP";
+    ASSERT_EQ(4, stats.skipped) << "Wrong skipped ticks with SKIP";
+    stats = graph.GetTickStats(&clamp);
+    ASSERT_EQ(3, stats.ticks) << "CLAMP did not run a limited number of late ticks";
+    ASSERT_EQ(2, stats.overruns) << "Wrong overruns with CLAMP";
+    ASSERT_EQ(2, stats.skipped) << "Wrong skipped ticks with CLAMP";
+    stats = graph.GetTickStats(&burst);
+    ASSERT_EQ(5, stats.ticks) << "BURST did not run all the late ticks";
+    ASSERT_EQ(4, stats.overruns) << "Wrong overruns with BURST";
+    ASSERT_EQ(0, stats.skipped) << "BURST skipped ticks";
+}
+
+} // namespace trillek
+
+#endif // SYSTEMGRAPHTEST_H_INCLUDED
@@ -0,0 +1,212 @@
+#ifndef TASKPOOLTEST_H_INCLUDED
+#define TASKPOOLTEST_H_INCLUDED
+
+#include "scheduler/task-pool.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+// a task with an explicit timestamp, that does not need the OS clock
+class TestTask : public TaskRequestBase {
+public:
+    TestTask(const frame_tp& timestamp, int id) :
+        TaskRequestBase(frame_tp(timestamp)), id(id) {};
+
+    void RunTask() override {};
+
+    const int id;
+};
+
+static int PoppedId(TaskPool& pool, unsigned int worker, const frame_tp& now) {
+    std::shared_ptr<TaskRequestBase> task;
+    if (! pool.Pop(task, worker, now)) {
+        return -1;
+    }
+    return std::static_pointer_cast<TestTask>(task)->id;
+}
+
+TEST(TaskPoolTest, GlobalPoolOrder) {
+    GlobalTaskPool pool;
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(std::make_shared<TestTask>(t0 + frame_unit(20), 2), 0, t0);
+    pool.Push(std::make_shared<TestTask>(t0 + frame_unit(10), 1), 0, t0);
+    ASSERT_EQ(2, pool.Size()) << "Pool does not contain the tasks";
+    ASSERT_EQ(t0 + frame_unit(10), pool.NextTimepoint()) << "Wrong next timepoint";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Task popped before its timestamp";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0 + frame_unit(30))) << "Earliest task not popped first";
+    ASSERT_EQ(2, PoppedId(pool, 0, t0 + frame_unit(30))) << "Second task not popped";
+    ASSERT_EQ(frame_tp::max(), pool.NextTimepoint()) << "Empty pool has a next timepoint";
+}
+
+TEST(TaskPoolTest, WorkStealingOwnQueue) {
+    WorkStealingTaskPool pool(2);
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(std::make_shared<TestTask>(t0, 1), 0, t0);
+    pool.Push(std::make_shared<TestTask>(t0, 2), 0, t0);
+    ASSERT_EQ(2, pool.Size()) << "Pool does not contain the tasks";
+    ASSERT_EQ(frame_tp::min(), pool.NextTimepoint()) << "Ready tasks not reported";
+    ASSERT_EQ(2, PoppedId(pool, 0, t0)) << "Worker does not pop its newest task first";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0)) << "Worker does not pop its second task";
+    ASSERT_EQ(0, pool.Size()) << "Pool is not empty";
+}
+
+TEST(TaskPoolTest, WorkStealingSteal) {
+    WorkStealingTaskPool pool(2);
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(std::make_shared<TestTask>(t0, 1), 0, t0);
+    pool.Push(std::make_shared<TestTask>(t0, 2), 0, t0);
+    ASSERT_EQ(1, PoppedId(pool, 1, t0)) << "Idle worker does not steal the oldest task";
+    ASSERT_EQ(2, PoppedId(pool, 1, t0)) << "Idle worker does not steal the second task";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Stolen task popped twice";
+}
+
+TEST(TaskPoolTest, WorkStealingDelayed) {
+    WorkStealingTaskPool pool(2);
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(std::make_shared<TestTask>(t0 + frame_unit(10), 1), 0, t0);
+    ASSERT_EQ(1, pool.Size()) << "Delayed task not counted";
+    ASSERT_EQ(t0 + frame_unit(10), pool.NextTimepoint()) << "Wrong next timepoint";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Task popped before its timestamp";
+    ASSERT_EQ(1, PoppedId(pool, 1, t0 + frame_unit(10))) << "Due task not released";
+    ASSERT_EQ(frame_tp::max(), pool.NextTimepoint()) << "Empty pool has a next timepoint";
+}
+
+TEST(TaskPoolTest, GlobalPoolBatch) {
+    GlobalTaskPool pool;
+    const frame_tp t0(frame_unit(1000));
+    std::vector<std::shared_ptr<TaskRequestBase>> batch;
+    batch.push_back(std::make_shared<TestTask>(t0 + frame_unit(20), 2));
+    batch.push_back(std::make_shared<TestTask>(t0, 1));
+    pool.PushBatch(batch, TaskPool::NO_WORKER, t0);
+    ASSERT_EQ(2, pool.Size()) << "Pool does not contain the batch";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0)) << "Ready task of the batch not popped";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Delayed task of the batch popped before its timestamp";
+    ASSERT_EQ(2, PoppedId(pool, 0, t0 + frame_unit(20))) << "Delayed task of the batch not popped";
+}
+
+TEST(TaskPoolTest, WorkStealingBatch) {
+    WorkStealingTaskPool pool(2);
+    const frame_tp t0(frame_unit(1000));
+    std::vector<std::shared_ptr<TaskRequestBase>> batch;
+    for (int i = 0; i < 4; ++i) {
+        batch.push_back(std::make_shared<TestTask>(t0, i));
+    }
+    batch.push_back(std::make_shared<TestTask>(t0 + frame_unit(20), 4));
+    // not a worker : the batch is cut in one slice per deque, {0, 1} and {2, 3}
+    pool.PushBatch(batch, TaskPool::NO_WORKER, t0);
+    ASSERT_EQ(5, pool.Size()) << "Pool does not contain the batch";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0)) << "First slice not in the deque of worker 0";
+    ASSERT_EQ(3, PoppedId(pool, 1, t0)) << "Second slice not in the deque of worker 1";
+    // a worker keeps its batch
+    batch.clear();
+    batch.push_back(std::make_shared<TestTask>(t0, 5));
+    batch.push_back(std::make_shared<TestTask>(t0, 6));
+    pool.PushBatch(batch, 1, t0);
+    ASSERT_EQ(6, PoppedId(pool, 1, t0)) << "Worker does not pop the newest task of its batch";
+    ASSERT_EQ(4, pool.Size()) << "Wrong number of tasks left";
+    ASSERT_EQ(4, PoppedId(pool, 0, t0 + frame_unit(20))) << "Delayed task of the batch not released";
+}
+
+static std::shared_ptr<TestTask> LaneTask(const frame_tp& timestamp, int id, TaskClass task_class,
+                                          const frame_tp& deadline = frame_tp::max()) {
+    auto task = std::make_shared<TestTask>(timestamp, id);
+    task->SetClass(task_class);
+    task->SetDeadline(deadline);
+    return task;
+}
+
+TEST(TaskPoolTest, GlobalPoolEarliestDeadline) {
+    GlobalTaskPool pool;
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(LaneTask(t0, 1, TaskClass::FRAME_CRITICAL, t0 + frame_unit(50)), 0, t0);
+    pool.Push(LaneTask(t0 + frame_unit(5), 2, TaskClass::FRAME_CRITICAL, t0 + frame_unit(20)), 0, t0 + frame_unit(5));
+    // due by its timestamp
+    pool.Push(LaneTask(t0 + frame_unit(10), 3, TaskClass::FRAME_CRITICAL), 0, t0 + frame_unit(10));
+    ASSERT_EQ(3, PoppedId(pool, 0, t0 + frame_unit(10))) << "Task without deadline not due by its timestamp";
+    ASSERT_EQ(2, PoppedId(pool, 0, t0 + frame_unit(10))) << "Earliest deadline not popped first";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0 + frame_unit(10))) << "Latest deadline not popped last";
+}
+
+TEST(TaskPoolTest, WorkStealingEarliestDeadline) {
+    WorkStealingTaskPool pool(2);
+    const frame_tp t0(frame_unit(1000));
+    pool.Push(LaneTask(t0, 1, TaskClass::FRAME_CRITICAL), 0, t0);
+    pool.Push(LaneTask(t0, 2, TaskClass::FRAME_CRITICAL, t0 + frame_unit(50)), 1, t0);
+    std::vector<std::shared_ptr<TaskRequestBase>> batch;
+    batch.push_back(LaneTask(t0, 3, TaskClass::FRAME_CRITICAL, t0 + frame_unit(20)));
+    batch.push_back(LaneTask(t0, 4, TaskClass::FRAME_CRITICAL));
+    batch.push_back(LaneTask(t0 + frame_unit(10), 5, TaskClass::FRAME_CRITICAL, t0 + frame_unit(10)));
+    pool.PushBatch(batch, 0, t0);
+    ASSERT_EQ(5, pool.Size()) << "Pool does not contain the tasks";
+    // the tasks with a deadline are shared by the workers, the delayed one waits for its timestamp
+    ASSERT_EQ(3, PoppedId(pool, 0, t0)) << "Earliest deadline not popped first";
+    ASSERT_EQ(5, PoppedId(pool, 0, t0 + frame_unit(10))) << "Delayed task with deadline not released";
+    ASSERT_EQ(2, PoppedId(pool, 0, t0 + frame_unit(10))) << "Task with deadline not popped before the deques";
+    ASSERT_EQ(4, PoppedId(pool, 0, t0 + frame_unit(10))) << "Task without deadline not in the deque";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0 + frame_unit(10))) << "Task without deadline not in the deque";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0 + frame_unit(10))) << "Pool is not empty";
+}
+
+// a background task queued first waits for the frame-critical tasks, but gets its share
+static void CheckLanes(TaskPool& pool) {
+    const frame_tp t0(frame_unit(1000));
+    pool.SetBackgroundInterval(3);
+    pool.Push(LaneTask(t0, 100, TaskClass::BACKGROUND_IO), 0, t0);
+    pool.Push(LaneTask(t0, 101, TaskClass::SCRIPTING), 0, t0);
+    for (int i = 0; i < 5; ++i) {
+        pool.Push(LaneTask(t0, i, TaskClass::FRAME_CRITICAL), 0, t0);
+    }
+    std::vector<bool> background;
+    for (int i = 0; i < 7; ++i) {
+        background.push_back(PoppedId(pool, 0, t0) >= 100);
+    }
+    ASSERT_EQ(std::vector<bool>({false, false, true, false, false, true, false}), background)
+        << "Background tasks do not get one pop in 3";
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Pool is not empty";
+}
+
+TEST(TaskPoolTest, GlobalPoolLanes) {
+    GlobalTaskPool pool;
+    CheckLanes(pool);
+}
+
+TEST(TaskPoolTest, WorkStealingLanes) {
+    WorkStealingTaskPool pool(2);
+    CheckLanes(pool);
+}
+
+// a refused background task stays in the pool and does not hide the frame-critical tasks
+static void CheckAdmission(TaskPool& pool) {
+    const frame_tp t0(frame_unit(1000));
+    bool background_slot = false;
+    pool.SetAdmission([&background_slot](TaskClass c) {
+        return c == TaskClass::FRAME_CRITICAL || background_slot;
+    });
+    pool.Push(LaneTask(t0, 100, TaskClass::BACKGROUND_IO), 0, t0);
+    ASSERT_EQ(-1, PoppedId(pool, 0, t0)) << "Refused task popped";
+    ASSERT_EQ(1, pool.Size()) << "Refused task left the pool";
+    ASSERT_EQ(frame_tp::max(), pool.NextTimepoint()) << "Refused task reported as ready";
+    pool.Push(LaneTask(t0, 1, TaskClass::FRAME_CRITICAL), 0, t0);
+    ASSERT_NE(frame_tp::max(), pool.NextTimepoint()) << "Admitted task not reported";
+    ASSERT_EQ(1, PoppedId(pool, 0, t0)) << "Admitted task not popped";
+    background_slot = true;
+    ASSERT_TRUE(pool.Readmit()) << "Refused lane not reported";
+    ASSERT_NE(frame_tp::max(), pool.NextTimepoint()) << "Readmitted task not reported";
+    ASSERT_EQ(100, PoppedId(pool, 0, t0)) << "Readmitted task not popped";
+    ASSERT_FALSE(pool.Readmit()) << "Lane still refused";
+}
+
+TEST(TaskPoolTest, GlobalPoolAdmission) {
+    GlobalTaskPool pool;
+    CheckAdmission(pool);
+}
+
+TEST(TaskPoolTest, WorkStealingAdmission) {
+    WorkStealingTaskPool pool(2);
+    CheckAdmission(pool);
+}
+
+} // namespace trillek
+
+#endif // TASKPOOLTEST_H_INCLUDED
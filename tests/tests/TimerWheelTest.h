@@ -0,0 +1,75 @@
+#ifndef TIMERWHEELTEST_H_INCLUDED
+#define TIMERWHEELTEST_H_INCLUDED
+
+#include <algorithm>
+#include <vector>
+#include "scheduler/timer-wheel.hpp"
+
+#include "gtest/gtest.h"
+
+namespace trillek {
+
+TEST(TimerWheelTest, NotBeforeTimepoint) {
+    TimerWheel<int> wheel(frame_unit(100));
+    const frame_tp t0(frame_unit(1000));
+    std::vector<int> out;
+    wheel.Insert(1, t0 + frame_unit(150), t0);
+    wheel.Insert(2, t0 + frame_unit(30), t0);
+    ASSERT_EQ(2, wheel.Size()) << "Wheel does not contain the elements";
+    ASSERT_EQ(t0 + frame_unit(30), wheel.NextTimepoint()) << "Wrong next timepoint";
+    wheel.Advance(t0 + frame_unit(29), out);
+    ASSERT_TRUE(out.empty()) << "Element returned before its timepoint";
+    wheel.Advance(t0 + frame_unit(30), out);
+    ASSERT_EQ(std::vector<int>({2}), out) << "Due element not returned";
+    wheel.Advance(t0 + frame_unit(149), out);
+    ASSERT_EQ(1, out.size()) << "Element returned before its timepoint";
+    wheel.Advance(t0 + frame_unit(150), out);
+    ASSERT_EQ(std::vector<int>({2, 1}), out) << "Due element not returned";
+    ASSERT_TRUE(wheel.Empty()) << "Wheel is not empty";
+    ASSERT_EQ(frame_tp::max(), wheel.NextTimepoint()) << "Empty wheel has a next timepoint";
+}
+
+TEST(TimerWheelTest, Cascade) {
+    // one element on each level, and one beyond the range of the wheel
+    TimerWheel<int> wheel(frame_unit(1));
+    const frame_tp t0(frame_unit(0));
+    const std::vector<long> delays = {5, 100, 5000, 300000, 20000000, 40000000};
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.Insert(int(i), t0 + frame_unit(delays[i]), t0);
+    }
+    std::vector<int> out;
+    for (size_t i = 0; i < delays.size(); ++i) {
+        // the wheel never asks to be advanced after the next element is due
+        ASSERT_LE(wheel.NextTimepoint(), t0 + frame_unit(delays[i])) << "Next timepoint after element " << i;
+        wheel.Advance(t0 + frame_unit(delays[i] - 1), out);
+        ASSERT_EQ(i, out.size()) << "Element " << i << " returned before its timepoint";
+        wheel.Advance(t0 + frame_unit(delays[i]), out);
+        ASSERT_EQ(i + 1, out.size()) << "Element " << i << " not returned";
+        ASSERT_EQ(i, out.back()) << "Elements not returned in order";
+    }
+    ASSERT_TRUE(wheel.Empty()) << "Wheel is not empty";
+}
+
+TEST(TimerWheelTest, ManyElements) {
+    TimerWheel<int> wheel(frame_unit(10));
+    const frame_tp t0(frame_unit(12345));
+    std::vector<int> delays;
+    for (int i = 0; i < 1000; ++i) {
+        delays.push_back((i * 7919) % 100000);
+        wheel.Insert(int(i), t0 + frame_unit(delays.back()), t0);
+    }
+    std::vector<int> out;
+    for (frame_tp now = t0; ! wheel.Empty(); now += frame_unit(997)) {
+        size_t before = out.size();
+        wheel.Advance(now, out);
+        for (size_t i = before; i < out.size(); ++i) {
+            ASSERT_LE(t0 + frame_unit(delays[out[i]]), now) << "Element returned before its timepoint";
+            ASSERT_GT(t0 + frame_unit(delays[out[i]]), now - frame_unit(997)) << "Element returned late";
+        }
+    }
+    ASSERT_EQ(1000, out.size()) << "Elements lost";
+}
+
+} // namespace trillek
+
+#endif // TIMERWHEELTEST_H_INCLUDED